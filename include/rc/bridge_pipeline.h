@@ -0,0 +1,129 @@
+/**
+ * @file bridge_pipeline.h
+ *
+ * @brief      Per-frame processing of every subject from mocap frame to sent
+ *             packet.
+ *
+ *             For each subject the destination is parsed from its name, the
+ *             pose converted, and an ATT_POS_MOCAP packet packed and signed.
+ *             Subjects are spread over the worker pool (see worker_pool.h) in
+ *             chunks, and once every worker reaches the end-of-frame barrier
+ *             the whole batch of packets is flushed from the calling thread
+ *             and the status display updated.
+ *
+ *             Routes with a lower rate than the frames send, by default, the
+ *             mean of the poses since their last send rather than every Nth
+ *             frame, which keeps Vicon noise and aliasing out of slower
+ *             estimators at the cost of half an output period of lag. The
+ *             sums live in one 8-float array per subject, the quaternions
+ *             flipped into one hemisphere before they are added and the sum
+ *             normalized, which is the mean rotation for the small spread
+ *             within an interval.
+ *
+ *             For swarms, routes with msgs=neighbors also send each pose with
+ *             the positions and velocities of the subject's K nearest other
+ *             subjects, one LOCAL_POSITION_NED per neighbor from that
+ *             neighbor's system id and in the receiving route's frame. Only
+ *             subjects whose route sets a sysid are neighbors. A spatial hash
+ *             grid (see spatial_grid.h) is rebuilt from the calling thread at
+ *             the start of every frame that needs it and queried from the
+ *             workers, so the cost stays linear in the number of subjects.
+ *
+ *             Routes with msgs=collision get a COLLISION for every other
+ *             vehicle with a sysid predicted to come within 1m in the next 3s
+ *             (see collision.h), identified by its system id. The search runs
+ *             once per frame from the calling thread on the velocities of the
+ *             frames before, and a vehicle whose highest threat level rises
+ *             is told in the same frame even if its pose isn't due.
+ *
+ *             Routes with msgs=obstacle_distance get an OBSTACLE_DISTANCE
+ *             at their scan_rate, the 360 degree range scan a sensor on the
+ *             vehicle would see of every other unoccluded subject, routed or
+ *             not, and of the routing file's fixed obstacles (see
+ *             obstacle_scan.h). The subjects are binned from the calling
+ *             thread and the scans run on the workers.
+ *
+ *             Routes with a target and msgs=landing_target or follow_target
+ *             send, with each pose, where that subject is as seen from the
+ *             vehicle and where it is going. The pairs of a frame are found
+ *             and worked out in one pass from the calling thread (see
+ *             relative_pose.h) and packed on the workers.
+ *
+ *             The pose goes to each destination in that destination's format,
+ *             ATT_POS_MOCAP unless the routing file names another (see
+ *             pose_encoders.h), with the velocity and the variances of the
+ *             velocity filter for the formats that carry them.
+ *
+ *             Lower rate messages run on a timer wheel (see timer_wheel.h)
+ *             advanced by rc_bridge_run_timers from the same loop, so
+ *             thousands of them cost no threads. Every destination packets
+ *             are sent to gets a 1Hz HEARTBEAT until it has been unused for
+ *             5s, and subjects whose route asks for vision_speed_estimate get
+ *             one at the route's speed_rate, with a velocity low-pass filtered
+ *             from every frame in the route's frame and units.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_BRIDGE_PIPELINE_H
+#define RC_BRIDGE_PIPELINE_H
+
+#include "../rc/mocap_source.h"
+
+#define RC_BRIDGE_DEFAULT_CHUNK	8	// subjects taken by a worker at a time
+
+
+/**
+ * @brief      Starts the worker pool used to process frames.
+ *
+ *             rc_mav_init must have been called first.
+ *
+ * @param[in]  workers  Number of threads including the caller, 1 to process
+ *                      every subject on the calling thread
+ * @param[in]  chunk    Subjects taken by a worker at a time, for example
+ *                      RC_BRIDGE_DEFAULT_CHUNK
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_bridge_init(int workers, int chunk);
+
+/**
+ * @brief      Allocates every per-subject buffer of the pipeline for frames of
+ *             up to max_subjects subjects now, so the heap doesn't grow while
+ *             frames stream.
+ *
+ *             Call it after rc_bridge_init. Larger frames still work, growing
+ *             the buffers then.
+ *
+ * @param[in]  max_subjects  Most subjects expected in a frame
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_bridge_reserve(int max_subjects);
+
+/**
+ * @brief      Processes and sends every subject of a frame.
+ *
+ * @param[in]  frame  The frame
+ *
+ * @return     number of packets sent, -1 on failure
+ */
+int rc_bridge_process_frame(const rc_mocap_frame_t* frame);
+
+/**
+ * @brief      Runs the timers that are due and sends what they packed.
+ *
+ *             Call it on every pass of the frame loop, with or without a new
+ *             frame.
+ *
+ * @return     number of packets sent, -1 on failure
+ */
+int rc_bridge_run_timers();
+
+/**
+ * @brief      Stops the worker pool and removes every timer.
+ */
+void rc_bridge_cleanup();
+
+
+#endif /* RC_BRIDGE_PIPELINE_H */
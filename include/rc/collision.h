@@ -0,0 +1,101 @@
+/**
+ * @file collision.h
+ *
+ * @brief      Finds pairs of vehicles about to come closer than a safety
+ *             radius, from their positions and estimated velocities.
+ *
+ *             The broadphase is sweep-and-prune: every vehicle gets the box it
+ *             sweeps over the look-ahead horizon, grown by the radius, and the
+ *             boxes are swept along x in an order kept from one frame to the
+ *             next, so re-sorting is an insertion sort over an almost sorted
+ *             list and the sweep only pairs boxes that overlap on every axis.
+ *             The surviving pairs are laid out as arrays of relative position
+ *             and velocity and go through the closest point of approach in one
+ *             branch-free loop the compiler vectorizes: the time of minimum
+ *             distance assuming constant velocities, clamped to the horizon,
+ *             and the distance then.
+ *
+ *             Positions are in millimeters and velocities in millimeters per
+ *             second in the SDK frame, z up, as the bridge holds them.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_COLLISION_H
+#define RC_COLLISION_H
+
+#include <stdint.h>	// for specific integer types
+
+#define RC_COLLISION_DEFAULT_RADIUS	1.0f	// meters
+#define RC_COLLISION_DEFAULT_HORIZON	3.0f	// seconds looked ahead
+#define RC_COLLISION_DEFAULT_HIGH	1.0f	// seconds, sooner is a high threat
+#define RC_COLLISION_RESERVE_PAIRS	8	// per vehicle, room rc_collision_reserve makes
+
+/**
+ * What counts as a conflict
+ */
+typedef struct rc_collision_config_t{
+	float radius_m;			///< closer than this at the closest point
+	float horizon_s;		///< within this time
+	float high_s;			///< closest point sooner than this is a high threat
+} rc_collision_config_t;
+
+/**
+ * One conflicting pair
+ */
+typedef struct rc_collision_t{
+	int a;				///< index of the first vehicle
+	int b;				///< index of the second, a < b
+	float time_s;			///< until the closest point, 0 if it is now
+	float horizontal_m;		///< horizontal distance at the closest point
+	float vertical_m;		///< vertical distance at the closest point
+	uint8_t threat;			///< MAV_COLLISION_THREAT_LEVEL_LOW or _HIGH
+} rc_collision_t;
+
+
+/**
+ * @brief      Fills a config with the RC_COLLISION_DEFAULT_* values.
+ */
+void rc_collision_default_config(rc_collision_config_t* cfg);
+
+/**
+ * @brief      Finds every pair of vehicles in conflict.
+ *
+ *             When there are more than max, the max with the soonest closest
+ *             point are kept, the closer first on a tie. Not thread safe, the
+ *             sort order is kept between calls.
+ *
+ * @param[in]  x, y, z     Position of every vehicle, millimeters
+ * @param[in]  vx, vy, vz  Velocity of every vehicle, millimeters per second
+ * @param[in]  n           Number of vehicles
+ * @param[in]  cfg         What counts as a conflict
+ * @param[out] out         The pairs found
+ * @param[in]  max         Room in out
+ *
+ * @return     number of pairs written to out, -1 on error
+ */
+int rc_collision_detect(const float* x, const float* y, const float* z,
+			const float* vx, const float* vy, const float* vz, int n,
+			const rc_collision_config_t* cfg, rc_collision_t* out, int max);
+
+/**
+ * @brief      Pairs the broadphase passed to the closest point check in the
+ *             last call, for benchmarking.
+ */
+int rc_collision_candidates();
+
+/**
+ * @brief      Allocates the arrays kept between calls for n vehicles now.
+ *
+ *             Candidate pairs get room for RC_COLLISION_RESERVE_PAIRS per
+ *             vehicle, and only a denser swarm grows them while detecting.
+ */
+void rc_collision_reserve(int n);
+
+/**
+ * @brief      Frees the arrays kept between calls.
+ */
+void rc_collision_cleanup();
+
+
+#endif /* RC_COLLISION_H */
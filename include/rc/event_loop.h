@@ -0,0 +1,101 @@
+/**
+ * @file event_loop.h
+ *
+ * @brief      Single-threaded reactor the bridge's frame loop runs on.
+ *
+ *             One call, rc_loop_run_once, waits for whichever comes first of
+ *             a readable socket, a wakeup from another thread or the next
+ *             timer, then runs the callbacks of everything that is ready.
+ *             Sockets should be non-blocking and their callbacks drain them.
+ *             The wait is epoll on Linux and WSAPoll on Windows, and the
+ *             wakeup an eventfd or a UDP socket connected to itself, so
+ *             both look like one more readable socket to the wait.
+ *
+ *             Every callback runs on the thread calling rc_loop_run_once.
+ *             Only rc_loop_wakeup may be called from other threads, which is
+ *             how mocap acquisition threads (see rc_mocap_threaded_source
+ *             in mocap_source.h) hand over a frame.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_EVENT_LOOP_H
+#define RC_EVENT_LOOP_H
+
+#include <stdint.h>	// for specific integer types
+#include "../rc/net_platform.h"
+
+#define RC_LOOP_MAX_SOCKETS	64
+#define RC_LOOP_MAX_TIMERS	16
+
+typedef void (*rc_loop_callback_t)(void* ctx);
+
+
+/**
+ * @brief      Creates the loop.
+ *
+ * @param[in]  on_wakeup  Called on the loop thread after rc_loop_wakeup, once
+ *                        however many wakeups came since the last call, NULL
+ *                        for none
+ * @param[in]  ctx        Passed to on_wakeup
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_loop_init(rc_loop_callback_t on_wakeup, void* ctx);
+
+/**
+ * @brief      Watches a socket for incoming data.
+ *
+ * @param[in]  sock         The socket, non-blocking
+ * @param[in]  on_readable  Called when there is data, should read until the
+ *                          socket would block
+ * @param[in]  ctx          Passed to on_readable
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_loop_add_socket(rc_socket_t sock, rc_loop_callback_t on_readable, void* ctx);
+
+/**
+ * @brief      Stops watching a socket.
+ *
+ * @return     0 on success, -1 if it wasn't watched
+ */
+int rc_loop_remove_socket(rc_socket_t sock);
+
+/**
+ * @brief      Adds a periodic timer, first due one period from now.
+ *
+ * @param[in]  period_usec  Period in microseconds, at least 1000
+ * @param[in]  on_timer     Called when due, late calls aren't repeated
+ * @param[in]  ctx          Passed to on_timer
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_loop_add_timer(uint32_t period_usec, rc_loop_callback_t on_timer, void* ctx);
+
+/**
+ * @brief      Makes the loop return from its wait and run on_wakeup. Safe
+ *             from any thread.
+ */
+void rc_loop_wakeup();
+
+/**
+ * @brief      Waits for sockets, wakeups and timers and runs their
+ *             callbacks.
+ *
+ * @param[in]  timeout_ms  Longest wait when no timer is due sooner, 0 to
+ *                         only run what is ready, -1 to wait for the next
+ *                         event however long
+ *
+ * @return     number of callbacks run, -1 on failure
+ */
+int rc_loop_run_once(int timeout_ms);
+
+/**
+ * @brief      Removes every socket and timer and frees the loop. The sockets
+ *             themselves stay open.
+ */
+void rc_loop_cleanup();
+
+
+#endif /* RC_EVENT_LOOP_H */
@@ -0,0 +1,90 @@
+/**
+ * @file flight_recorder.h
+ *
+ * @brief      Binary flight recorder of every packet the bridge sends.
+ *
+ *             Packets are written in the tlog format understood by MAVProxy,
+ *             QGroundControl and pymavlink: for each packet an 8 byte
+ *             big-endian timestamp in microseconds since the unix epoch
+ *             followed by the raw MAVLink bytes.
+ *
+ *             rc_mav_send_msg pushes each sent packet into a bounded lock-free
+ *             multi-producer ring, which costs a copy of the packet and two
+ *             atomic operations. A background writer drains the ring into a
+ *             page-aligned 1MiB block and writes whole blocks unbuffered,
+ *             rotating to a new numbered file once a file reaches the
+ *             configured size. If the writer falls behind and the ring fills,
+ *             packets are counted as dropped rather than blocking the sender.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_FLIGHT_RECORDER_H
+#define RC_FLIGHT_RECORDER_H
+
+#include <stdint.h>	// for specific integer types
+#include <stddef.h>
+
+#define RC_RECORDER_DEFAULT_SLOTS	16384
+#define RC_RECORDER_DEFAULT_ROTATE	(256*1024*1024)
+
+
+/**
+ * @brief      Starts recording to prefix_0000.tlog, prefix_0001.tlog, ...
+ *
+ * @param[in]  prefix        Path prefix of the log files
+ * @param[in]  slots         Number of packets the ring can hold, rounded up
+ *                           to a power of two
+ * @param[in]  rotate_bytes  Size at which to start a new file, 0 to never
+ *                           rotate
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_recorder_start(const char* prefix, size_t slots, size_t rotate_bytes);
+
+/**
+ * @brief      Indicates if the recorder is running.
+ *
+ * @return     1 if recording, otherwise 0
+ */
+int rc_recorder_is_running();
+
+/**
+ * @brief      Queues a sent packet for recording. Safe to call from multiple
+ *             threads.
+ *
+ * @param[in]  time_usec  Send time in microseconds since the unix epoch
+ * @param[in]  buf        The raw packet bytes
+ * @param[in]  len        Number of bytes, at most MAVLINK_MAX_PACKET_LEN
+ *
+ * @return     0 on success, -1 if the recorder isn't running or the ring is
+ *             full
+ */
+int rc_recorder_push(uint64_t time_usec, const uint8_t* buf, int len);
+
+/**
+ * @brief      Stops the writer after draining the ring and closes the file.
+ *             Waits for pushes already in progress on other threads, later
+ *             ones return -1.
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_recorder_stop();
+
+/**
+ * @brief      Returns the number of packets written so far.
+ *
+ * @return     number of packets
+ */
+uint64_t rc_recorder_written();
+
+/**
+ * @brief      Returns the number of packets dropped because the ring was full
+ *             or the next file of a rotation couldn't be opened.
+ *
+ * @return     number of packets
+ */
+uint64_t rc_recorder_dropped();
+
+
+#endif /* RC_FLIGHT_RECORDER_H */
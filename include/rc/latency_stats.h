@@ -0,0 +1,168 @@
+/**
+ * @file latency_stats.h
+ *
+ * @brief      Low-overhead per-stage latency histograms for the bridge
+ *             pipeline.
+ *
+ *             Each stage of the path from GetFrame returning to the packet
+ *             leaving rc_mav_send_msg is timed with steady_clock stamps and
+ *             recorded into HDR-style log-linear histograms: 32 linear
+ *             sub-buckets per power of two, giving about 3% value resolution
+ *             from 1ns to over a minute. Counters are relaxed atomics so
+ *             recording is lock-free and safe from any thread. There is one
+ *             histogram per stage for all subjects plus one per stage per
+ *             subject, the latter allocated on the first sample for that
+ *             subject.
+ *
+ *             Instrumentation is disabled by default, in which case
+ *             rc_lat_now and rc_lat_record return immediately.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_LATENCY_STATS_H
+#define RC_LATENCY_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+
+#define RC_LAT_MAX_SUBJECTS	1024
+#define RC_LAT_ALL_SUBJECTS	-1
+
+/**
+ * Pipeline stages that are timed. RC_LAT_ACQUIRE covers the frame-level
+ * queries made once GetFrame has returned, since GetFrame itself blocks until
+ * the next frame. RC_LAT_SIGN covers signing and copying the packet into the
+ * send buffer, RC_LAT_SYSCALL the sendto call itself.
+ */
+typedef enum rc_lat_stage_t{
+	RC_LAT_ACQUIRE,
+	RC_LAT_EXTRACT,
+	RC_LAT_TRANSFORM,
+	RC_LAT_PACK,
+	RC_LAT_SIGN,
+	RC_LAT_SYSCALL,
+	RC_LAT_NUM_STAGES
+} rc_lat_stage_t;
+
+
+/**
+ * @brief      Enables or disables latency instrumentation.
+ *
+ * @param[in]  enable  1 to enable recording, 0 to disable
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_lat_init(int enable);
+
+/**
+ * @brief      Indicates if latency instrumentation is enabled.
+ *
+ * @return     1 if enabled, otherwise 0
+ */
+int rc_lat_is_enabled();
+
+/**
+ * @brief      Returns a steady clock stamp for use with rc_lat_record.
+ *
+ * @return     nanoseconds from an arbitrary epoch, or 0 if disabled
+ */
+uint64_t rc_lat_now();
+
+/**
+ * @brief      Sets the subject that stages timed inside the send path on this
+ *             thread are attributed to.
+ *
+ *             rc_mav_send_msg has no notion of which subject it is sending
+ *             for, so the frame loop sets it here before sending.
+ *
+ * @param[in]  subject  The subject index, or RC_LAT_ALL_SUBJECTS for none
+ */
+void rc_lat_set_subject(int subject);
+
+/**
+ * @brief      Returns the subject set with rc_lat_set_subject on this thread.
+ *
+ * @return     The subject index, or RC_LAT_ALL_SUBJECTS if none is set
+ */
+int rc_lat_current_subject();
+
+/**
+ * @brief      Records the time spent in a stage since a stamp.
+ *
+ *             Adds now - start to the stage histogram and, if subject is a
+ *             valid index, to that subject's histogram as well.
+ *
+ * @param[in]  stage    The pipeline stage
+ * @param[in]  subject  The subject index, or RC_LAT_ALL_SUBJECTS
+ * @param[in]  start    Stamp taken with rc_lat_now when the stage began
+ *
+ * @return     The stamp at the end of the stage for chaining into the next
+ *             stage, or 0 if disabled
+ */
+uint64_t rc_lat_record(rc_lat_stage_t stage, int subject, uint64_t start);
+
+/**
+ * @brief      Records an already measured duration.
+ *
+ * @param[in]  stage    The pipeline stage
+ * @param[in]  subject  The subject index, or RC_LAT_ALL_SUBJECTS
+ * @param[in]  ns       The duration in nanoseconds
+ */
+void rc_lat_record_ns(rc_lat_stage_t stage, int subject, uint64_t ns);
+
+/**
+ * @brief      Allocates the histograms of subjects 0 to n-1 now instead of on
+ *             their first sample. Does nothing while disabled.
+ *
+ * @param[in]  n     Number of subjects, at most RC_LAT_MAX_SUBJECTS are kept
+ */
+void rc_lat_reserve(int n);
+
+/**
+ * @brief      Returns a percentile of a stage's latency.
+ *
+ * @param[in]  stage    The pipeline stage
+ * @param[in]  subject  The subject index, or RC_LAT_ALL_SUBJECTS
+ * @param[in]  p        The percentile, 0-100
+ *
+ * @return     latency in nanoseconds, or 0 if nothing has been recorded
+ */
+double rc_lat_percentile(rc_lat_stage_t stage, int subject, double p);
+
+/**
+ * @brief      Returns the number of samples recorded for a stage.
+ *
+ * @param[in]  stage    The pipeline stage
+ * @param[in]  subject  The subject index, or RC_LAT_ALL_SUBJECTS
+ *
+ * @return     number of samples
+ */
+uint64_t rc_lat_count(rc_lat_stage_t stage, int subject);
+
+/**
+ * @brief      Returns a short human-readable name for a stage.
+ *
+ * @param[in]  stage  The pipeline stage
+ *
+ * @return     the stage name
+ */
+const char* rc_lat_stage_name(rc_lat_stage_t stage);
+
+/**
+ * @brief      Prints a percentile table for every stage, followed by one row
+ *             per subject and stage that has samples.
+ *
+ * @param      f     Stream to print to, such as stdout
+ */
+void rc_lat_print(FILE* f);
+
+/**
+ * @brief      Clears all histograms and frees the per-subject ones.
+ *
+ *             Must not be called while other threads are recording.
+ */
+void rc_lat_cleanup();
+
+
+#endif /* RC_LATENCY_STATS_H */
@@ -0,0 +1,45 @@
+/**
+ * @file mapped_file.h
+ *
+ * @brief      Read-only memory mapping of whole files on Windows and POSIX.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_MAPPED_FILE_H
+#define RC_MAPPED_FILE_H
+
+#include <stdint.h>	// for specific integer types
+#include <stddef.h>
+
+/**
+ * A file mapped read-only into memory
+ */
+typedef struct rc_mapped_file_t{
+	const uint8_t* data;	///< start of the mapping, NULL if not mapped
+	size_t size;		///< file size in bytes
+	void* handle;		///< platform specific, don't touch
+} rc_mapped_file_t;
+
+
+/**
+ * @brief      Maps a whole file read-only.
+ *
+ *             An empty file maps successfully with data NULL and size 0.
+ *
+ * @param[in]  path  Path of the file
+ * @param[out] file  The mapping
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_map_file(const char* path, rc_mapped_file_t* file);
+
+/**
+ * @brief      Unmaps a file mapped with rc_map_file.
+ *
+ * @param      file  The mapping
+ */
+void rc_unmap_file(rc_mapped_file_t* file);
+
+
+#endif /* RC_MAPPED_FILE_H */
@@ -0,0 +1,181 @@
+/**
+ * @file mavlink_signing.h
+ *
+ * @brief      Per-destination MAVLink2 packet signing and a hash-indexed
+ *             signing-stream table for verifying incoming signed packets.
+ *
+ *             The stock mavlink_signing_streams_t is a fixed array of
+ *             MAVLINK_MAX_SIGNING_STREAMS entries searched linearly for every
+ *             signed packet. This module replaces it with an open-addressed
+ *             table keyed by (link_id, sysid, compid) so the timestamp replay
+ *             check stays O(1) with thousands of streams. Secret keys and
+ *             link_ids are configured per destination IP address at startup,
+ *             either individually with rc_mav_signing_set_key or from a key
+ *             file with rc_mav_signing_load_file.
+ *
+ *             Signing timestamps follow the MAVLink convention of units of
+ *             10 microseconds since 1st January 2015 GMT.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_MAVLINK_SIGNING_H
+#define RC_MAVLINK_SIGNING_H
+
+#include <stdint.h>	// for specific integer types
+#include "../rc/mavlink/common/mavlink.h"
+#include "../rc/mavlink/mavlink_types.h"
+
+#define RC_MAV_SIGNING_DEFAULT_STREAMS	256
+#define RC_MAV_SIGNING_MAX_DESTS	256
+#define RC_MAV_SIGNING_KEY_LEN		32
+
+
+/**
+ * @brief      Allocates the signing-stream table.
+ *
+ *             The table is sized to the next power of two at least twice
+ *             max_streams so probe sequences stay short. Streams beyond
+ *             max_streams are rejected, just as the stock implementation
+ *             rejects streams beyond MAVLINK_MAX_SIGNING_STREAMS. Calling this
+ *             again discards all previously seen streams but keeps the
+ *             configured destination keys.
+ *
+ * @param[in]  max_streams  Maximum number of (link_id, sysid, compid) tuples
+ *                          to track
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_signing_init(int max_streams);
+
+/**
+ * @brief      Sets the secret key and link id used for a destination.
+ *
+ *             Packets sent to dest_ip are signed with this key and link id,
+ *             and signed packets received from dest_ip are verified against
+ *             it. Setting a key for an address that already has one replaces
+ *             it.
+ *
+ * @param[in]  dest_ip  The destination ip in dotted quad notation
+ * @param[in]  link_id  The link id placed in the signature block
+ * @param[in]  key      The 32 byte secret key
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_signing_set_key(const char* dest_ip, uint8_t link_id,
+			const uint8_t key[RC_MAV_SIGNING_KEY_LEN]);
+
+/**
+ * @brief      Loads destination keys from a text file.
+ *
+ *             Each non-empty line that does not start with '#' must be of the
+ *             form "<ip> <link_id> <64 hex digit key>", for example
+ *             "192.168.5.5 1 00112233...". Malformed lines are reported and
+ *             skipped.
+ *
+ * @param[in]  path  Path to the key file
+ *
+ * @return     number of keys loaded, or -1 if the file could not be read
+ */
+int rc_mav_signing_load_file(const char* path);
+
+/**
+ * @brief      Returns the number of destinations with a signing key.
+ *
+ * @return     number of configured destinations
+ */
+int rc_mav_signing_num_dests();
+
+/**
+ * @brief      Signs an already packed MAVLink2 message.
+ *
+ *             Sets MAVLINK_IFLAG_SIGNED, recomputes the checksum to cover the
+ *             new header and fills in the signature block. MAVLink1 messages
+ *             cannot be signed and are rejected.
+ *
+ * @param      msg        The message to sign
+ * @param[in]  link_id    The link identifier
+ * @param[in]  timestamp  The signing timestamp (10us units since 2015)
+ * @param[in]  key        The 32 byte secret key
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_sign_msg(mavlink_message_t* msg, uint8_t link_id, uint64_t timestamp,
+			const uint8_t key[RC_MAV_SIGNING_KEY_LEN]);
+
+/**
+ * @brief      Signs a message if its destination has a configured key.
+ *
+ *             Called by rc_mav_send_msg for every outgoing packet. When no keys
+ *             are configured this returns immediately.
+ *
+ * @param[in]  dest_addr  The destination IPv4 address in network byte order
+ * @param      msg        The message to sign
+ *
+ * @return     1 if the message was signed, 0 if the destination has no key,
+ *             -1 on failure
+ */
+int rc_mav_signing_sign(uint32_t dest_addr, mavlink_message_t* msg);
+
+/**
+ * @brief      Tells whether packets to a destination get signed.
+ *
+ * @param[in]  dest_addr  The destination IPv4 address in network byte order
+ *
+ * @return     1 if the destination has a key, 0 if not
+ */
+int rc_mav_signing_has_key(uint32_t dest_addr);
+
+/**
+ * @brief      Verifies the signature and timestamp of a received message.
+ *
+ *             The signature is checked with the key configured for the sending
+ *             address, then the timestamp is checked against the last one seen
+ *             on the same (link_id, sysid, compid) stream to reject replays.
+ *
+ * @param[in]  src_addr  The sender's IPv4 address in network byte order
+ * @param[in]  msg       The received message
+ *
+ * @return     0 if the message is correctly signed and fresh, -1 otherwise
+ */
+int rc_mav_signing_verify(uint32_t src_addr, const mavlink_message_t* msg);
+
+/**
+ * @brief      Performs only the replay check for one signing stream.
+ *
+ *             Accepts and records the timestamp if it is newer than the last
+ *             one seen on the stream. New streams are accepted if their
+ *             timestamp is no more than one minute old. Safe to call from
+ *             multiple threads.
+ *
+ * @param[in]  link_id    The link identifier from the signature block
+ * @param[in]  sysid      The sender's system id
+ * @param[in]  compid     The sender's component id
+ * @param[in]  timestamp  The signing timestamp (10us units since 2015)
+ *
+ * @return     0 if the timestamp is accepted, -1 otherwise
+ */
+int rc_mav_signing_check_timestamp(uint8_t link_id, uint8_t sysid,
+			uint8_t compid, uint64_t timestamp);
+
+/**
+ * @brief      Returns the number of signing streams seen so far.
+ *
+ * @return     number of streams in the table
+ */
+int rc_mav_signing_num_streams();
+
+/**
+ * @brief      Returns the current signing timestamp.
+ *
+ * @return     10us units since 1st January 2015 GMT
+ */
+uint64_t rc_mav_signing_timestamp_now();
+
+/**
+ * @brief      Frees the signing-stream table and forgets all keys.
+ */
+void rc_mav_signing_cleanup();
+
+
+#endif /* RC_MAVLINK_SIGNING_H */
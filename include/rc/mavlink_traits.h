@@ -0,0 +1,310 @@
+/**
+ * @file mavlink_traits.h
+ *
+ * @brief      Compile time traits of every MAVLink message and typed pack and
+ *             unpack built on them.
+ *
+ *             rc_mav_msg<mavlink_x_t> gives a message's id, lengths and CRC
+ *             extra as constants, so rc_mav_pack and rc_mav_unpack compile down
+ *             to a copy of a known size and a few header stores per message
+ *             type instead of the table lookups and length arguments of the C
+ *             helpers. The message structs are packed in wire order, which the
+ *             traits check against MAVLINK_MSG_ID_*_LEN when compiled.
+ *
+ *             Packets are MAVLink 2 as rc_mav_pack_msg builds them, byte for
+ *             byte. Destinations with a signing key go through rc_mav_pack_msg
+ *             to be signed. rc_check_traits checks every message both ways
+ *             against the C helpers.
+ *
+ *             RC_MAV_MESSAGES lists the messages of common.h's
+ *             MAVLINK_MESSAGE_INFO, and must follow it when the headers are
+ *             regenerated.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_MAVLINK_TRAITS_H
+#define RC_MAVLINK_TRAITS_H
+
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include "../rc/mavlink_udp.h"
+#include "../rc/mavlink_signing.h"
+#include "../rc/latency_stats.h"
+
+/**
+ * X(name, NAME) for every message
+ */
+#define RC_MAV_MESSAGES(X) \
+	X(heartbeat, HEARTBEAT) \
+	X(sys_status, SYS_STATUS) \
+	X(system_time, SYSTEM_TIME) \
+	X(ping, PING) \
+	X(change_operator_control, CHANGE_OPERATOR_CONTROL) \
+	X(change_operator_control_ack, CHANGE_OPERATOR_CONTROL_ACK) \
+	X(auth_key, AUTH_KEY) \
+	X(set_mode, SET_MODE) \
+	X(param_request_read, PARAM_REQUEST_READ) \
+	X(param_request_list, PARAM_REQUEST_LIST) \
+	X(param_value, PARAM_VALUE) \
+	X(param_set, PARAM_SET) \
+	X(gps_raw_int, GPS_RAW_INT) \
+	X(gps_status, GPS_STATUS) \
+	X(scaled_imu, SCALED_IMU) \
+	X(raw_imu, RAW_IMU) \
+	X(raw_pressure, RAW_PRESSURE) \
+	X(scaled_pressure, SCALED_PRESSURE) \
+	X(attitude, ATTITUDE) \
+	X(attitude_quaternion, ATTITUDE_QUATERNION) \
+	X(local_position_ned, LOCAL_POSITION_NED) \
+	X(global_position_int, GLOBAL_POSITION_INT) \
+	X(rc_channels_scaled, RC_CHANNELS_SCALED) \
+	X(rc_channels_raw, RC_CHANNELS_RAW) \
+	X(servo_output_raw, SERVO_OUTPUT_RAW) \
+	X(mission_request_partial_list, MISSION_REQUEST_PARTIAL_LIST) \
+	X(mission_write_partial_list, MISSION_WRITE_PARTIAL_LIST) \
+	X(mission_item, MISSION_ITEM) \
+	X(mission_request, MISSION_REQUEST) \
+	X(mission_set_current, MISSION_SET_CURRENT) \
+	X(mission_current, MISSION_CURRENT) \
+	X(mission_request_list, MISSION_REQUEST_LIST) \
+	X(mission_count, MISSION_COUNT) \
+	X(mission_clear_all, MISSION_CLEAR_ALL) \
+	X(mission_item_reached, MISSION_ITEM_REACHED) \
+	X(mission_ack, MISSION_ACK) \
+	X(set_gps_global_origin, SET_GPS_GLOBAL_ORIGIN) \
+	X(gps_global_origin, GPS_GLOBAL_ORIGIN) \
+	X(param_map_rc, PARAM_MAP_RC) \
+	X(mission_request_int, MISSION_REQUEST_INT) \
+	X(safety_set_allowed_area, SAFETY_SET_ALLOWED_AREA) \
+	X(safety_allowed_area, SAFETY_ALLOWED_AREA) \
+	X(attitude_quaternion_cov, ATTITUDE_QUATERNION_COV) \
+	X(nav_controller_output, NAV_CONTROLLER_OUTPUT) \
+	X(global_position_int_cov, GLOBAL_POSITION_INT_COV) \
+	X(local_position_ned_cov, LOCAL_POSITION_NED_COV) \
+	X(rc_channels, RC_CHANNELS) \
+	X(request_data_stream, REQUEST_DATA_STREAM) \
+	X(data_stream, DATA_STREAM) \
+	X(manual_control, MANUAL_CONTROL) \
+	X(rc_channels_override, RC_CHANNELS_OVERRIDE) \
+	X(mission_item_int, MISSION_ITEM_INT) \
+	X(vfr_hud, VFR_HUD) \
+	X(command_int, COMMAND_INT) \
+	X(command_long, COMMAND_LONG) \
+	X(command_ack, COMMAND_ACK) \
+	X(manual_setpoint, MANUAL_SETPOINT) \
+	X(set_attitude_target, SET_ATTITUDE_TARGET) \
+	X(attitude_target, ATTITUDE_TARGET) \
+	X(set_position_target_local_ned, SET_POSITION_TARGET_LOCAL_NED) \
+	X(position_target_local_ned, POSITION_TARGET_LOCAL_NED) \
+	X(set_position_target_global_int, SET_POSITION_TARGET_GLOBAL_INT) \
+	X(position_target_global_int, POSITION_TARGET_GLOBAL_INT) \
+	X(local_position_ned_system_global_offset, LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET) \
+	X(hil_state, HIL_STATE) \
+	X(hil_controls, HIL_CONTROLS) \
+	X(hil_rc_inputs_raw, HIL_RC_INPUTS_RAW) \
+	X(hil_actuator_controls, HIL_ACTUATOR_CONTROLS) \
+	X(optical_flow, OPTICAL_FLOW) \
+	X(global_vision_position_estimate, GLOBAL_VISION_POSITION_ESTIMATE) \
+	X(vision_position_estimate, VISION_POSITION_ESTIMATE) \
+	X(vision_speed_estimate, VISION_SPEED_ESTIMATE) \
+	X(vicon_position_estimate, VICON_POSITION_ESTIMATE) \
+	X(highres_imu, HIGHRES_IMU) \
+	X(optical_flow_rad, OPTICAL_FLOW_RAD) \
+	X(hil_sensor, HIL_SENSOR) \
+	X(sim_state, SIM_STATE) \
+	X(radio_status, RADIO_STATUS) \
+	X(file_transfer_protocol, FILE_TRANSFER_PROTOCOL) \
+	X(timesync, TIMESYNC) \
+	X(camera_trigger, CAMERA_TRIGGER) \
+	X(hil_gps, HIL_GPS) \
+	X(hil_optical_flow, HIL_OPTICAL_FLOW) \
+	X(hil_state_quaternion, HIL_STATE_QUATERNION) \
+	X(scaled_imu2, SCALED_IMU2) \
+	X(log_request_list, LOG_REQUEST_LIST) \
+	X(log_entry, LOG_ENTRY) \
+	X(log_request_data, LOG_REQUEST_DATA) \
+	X(log_data, LOG_DATA) \
+	X(log_erase, LOG_ERASE) \
+	X(log_request_end, LOG_REQUEST_END) \
+	X(gps_inject_data, GPS_INJECT_DATA) \
+	X(gps2_raw, GPS2_RAW) \
+	X(power_status, POWER_STATUS) \
+	X(serial_control, SERIAL_CONTROL) \
+	X(gps_rtk, GPS_RTK) \
+	X(gps2_rtk, GPS2_RTK) \
+	X(scaled_imu3, SCALED_IMU3) \
+	X(data_transmission_handshake, DATA_TRANSMISSION_HANDSHAKE) \
+	X(encapsulated_data, ENCAPSULATED_DATA) \
+	X(distance_sensor, DISTANCE_SENSOR) \
+	X(terrain_request, TERRAIN_REQUEST) \
+	X(terrain_data, TERRAIN_DATA) \
+	X(terrain_check, TERRAIN_CHECK) \
+	X(terrain_report, TERRAIN_REPORT) \
+	X(scaled_pressure2, SCALED_PRESSURE2) \
+	X(att_pos_mocap, ATT_POS_MOCAP) \
+	X(set_actuator_control_target, SET_ACTUATOR_CONTROL_TARGET) \
+	X(actuator_control_target, ACTUATOR_CONTROL_TARGET) \
+	X(altitude, ALTITUDE) \
+	X(resource_request, RESOURCE_REQUEST) \
+	X(scaled_pressure3, SCALED_PRESSURE3) \
+	X(follow_target, FOLLOW_TARGET) \
+	X(control_system_state, CONTROL_SYSTEM_STATE) \
+	X(battery_status, BATTERY_STATUS) \
+	X(autopilot_version, AUTOPILOT_VERSION) \
+	X(landing_target, LANDING_TARGET) \
+	X(estimator_status, ESTIMATOR_STATUS) \
+	X(wind_cov, WIND_COV) \
+	X(gps_input, GPS_INPUT) \
+	X(gps_rtcm_data, GPS_RTCM_DATA) \
+	X(high_latency, HIGH_LATENCY) \
+	X(vibration, VIBRATION) \
+	X(home_position, HOME_POSITION) \
+	X(set_home_position, SET_HOME_POSITION) \
+	X(message_interval, MESSAGE_INTERVAL) \
+	X(extended_sys_state, EXTENDED_SYS_STATE) \
+	X(adsb_vehicle, ADSB_VEHICLE) \
+	X(collision, COLLISION) \
+	X(v2_extension, V2_EXTENSION) \
+	X(memory_vect, MEMORY_VECT) \
+	X(debug_vect, DEBUG_VECT) \
+	X(named_value_float, NAMED_VALUE_FLOAT) \
+	X(named_value_int, NAMED_VALUE_INT) \
+	X(statustext, STATUSTEXT) \
+	X(debug, DEBUG) \
+	X(setup_signing, SETUP_SIGNING) \
+	X(button_change, BUTTON_CHANGE) \
+	X(play_tune, PLAY_TUNE) \
+	X(camera_information, CAMERA_INFORMATION) \
+	X(camera_settings, CAMERA_SETTINGS) \
+	X(storage_information, STORAGE_INFORMATION) \
+	X(camera_capture_status, CAMERA_CAPTURE_STATUS) \
+	X(camera_image_captured, CAMERA_IMAGE_CAPTURED) \
+	X(flight_information, FLIGHT_INFORMATION) \
+	X(mount_orientation, MOUNT_ORIENTATION) \
+	X(logging_data, LOGGING_DATA) \
+	X(logging_data_acked, LOGGING_DATA_ACKED) \
+	X(logging_ack, LOGGING_ACK) \
+	X(video_stream_information, VIDEO_STREAM_INFORMATION) \
+	X(set_video_stream_settings, SET_VIDEO_STREAM_SETTINGS) \
+	X(wifi_config_ap, WIFI_CONFIG_AP) \
+	X(protocol_version, PROTOCOL_VERSION) \
+	X(uavcan_node_status, UAVCAN_NODE_STATUS) \
+	X(uavcan_node_info, UAVCAN_NODE_INFO) \
+	X(param_ext_request_read, PARAM_EXT_REQUEST_READ) \
+	X(param_ext_request_list, PARAM_EXT_REQUEST_LIST) \
+	X(param_ext_value, PARAM_EXT_VALUE) \
+	X(param_ext_set, PARAM_EXT_SET) \
+	X(param_ext_ack, PARAM_EXT_ACK) \
+	X(obstacle_distance, OBSTACLE_DISTANCE)
+
+/**
+ * Traits of one message, specialized for each mavlink_x_t
+ */
+template<typename Msg> struct rc_mav_msg;
+
+#define RC_MAV_TRAITS(lower, NAME) \
+template<> struct rc_mav_msg<mavlink_##lower##_t>{ \
+	static constexpr uint32_t id = MAVLINK_MSG_ID_##NAME; \
+	static constexpr uint8_t min_len = MAVLINK_MSG_ID_##NAME##_MIN_LEN; \
+	static constexpr uint8_t len = MAVLINK_MSG_ID_##NAME##_LEN; \
+	static constexpr uint8_t crc_extra = MAVLINK_MSG_ID_##NAME##_CRC; \
+	static constexpr const char* name(){ return #NAME; } \
+	static_assert(sizeof(mavlink_##lower##_t) == MAVLINK_MSG_ID_##NAME##_LEN, "layout of " #NAME); \
+};
+RC_MAV_MESSAGES(RC_MAV_TRAITS)
+#undef RC_MAV_TRAITS
+
+
+/**
+ * @brief      Packs a message into a packet without sending it, as
+ *             rc_mav_pack_msg does.
+ *
+ * @param[out] pkt        The packet
+ * @param[in]  dest_addr  Destination IPv4 address, network byte order
+ * @param[in]  dest_port  Destination port, 0 for the port given to
+ *                        rc_mav_init
+ * @param[in]  sysid      System id in the packet, 0 for the one given to
+ *                        rc_mav_init
+ * @param[in]  seq        Sequence number of the packet
+ * @param[in]  msg        The message
+ *
+ * @return     0 on success, -1 on failure
+ */
+template<typename Msg>
+inline int rc_mav_pack(rc_mav_packet_t* pkt, uint32_t dest_addr, uint16_t dest_port,
+			uint8_t sysid, uint8_t seq, const Msg& msg)
+{
+	typedef rc_mav_msg<Msg> T;
+	uint8_t* b = pkt->buf;
+	uint8_t* payload = b + MAVLINK_NUM_HEADER_BYTES;
+	int subject;
+	uint64_t t;
+	uint16_t crc;
+	uint8_t n;
+
+	if(rc_mav_signing_has_key(dest_addr)){
+		return rc_mav_pack_msg(pkt, dest_addr, dest_port, sysid, seq, T::id, &msg,
+			T::min_len, T::len, T::crc_extra);
+	}
+	subject = rc_lat_current_subject();
+	t = rc_lat_now();
+	memcpy(payload, &msg, T::len);
+	// MAVLink 2 drops the trailing zeros
+	n = _mav_trim_payload((const char*)payload, T::len);
+	b[0] = MAVLINK_STX;
+	b[1] = n;
+	b[2] = 0;	// incompatibility flags
+	b[3] = 0;	// compatibility flags
+	b[4] = seq;
+	b[5] = sysid != 0 ? sysid : rc_mav_get_system_id();
+	b[6] = MAV_COMP_ID_ALL;
+	b[7] = (uint8_t)(T::id & 0xFF);
+	b[8] = (uint8_t)((T::id >> 8) & 0xFF);
+	b[9] = (uint8_t)((T::id >> 16) & 0xFF);
+	crc = crc_calculate(b + 1, MAVLINK_CORE_HEADER_LEN);
+	crc_accumulate_buffer(&crc, (const char*)payload, n);
+	crc_accumulate(T::crc_extra, &crc);
+	payload[n] = (uint8_t)(crc & 0xFF);
+	payload[n + 1] = (uint8_t)(crc >> 8);
+	t = rc_lat_record(RC_LAT_PACK, subject, t);
+	rc_lat_record(RC_LAT_SIGN, subject, t);
+	pkt->dest_addr = dest_addr;
+	pkt->dest_port = dest_port;
+	pkt->sysid = b[5];
+	pkt->subject = subject;
+	pkt->len = (uint16_t)(MAVLINK_NUM_NON_PAYLOAD_BYTES + n);
+	return 0;
+}
+
+/**
+ * @brief      Unpacks a received message, as mavlink_msg_x_decode does.
+ *
+ *             The parser only zero-fills a trimmed payload up to the length
+ *             without extensions, so the extensions past what was received
+ *             are zeroed here.
+ *
+ * @param[in]  msg  The message from mavlink_parse_char
+ * @param[out] out  The message struct
+ *
+ * @return     0 on success, -1 if msg is another message
+ */
+template<typename Msg>
+inline int rc_mav_unpack(const mavlink_message_t* msg, Msg* out)
+{
+	typedef rc_mav_msg<Msg> T;
+	uint8_t n;
+
+	if(msg->msgid != T::id) return -1;
+	if(msg->len >= T::len){
+		memcpy(out, _MAV_PAYLOAD(msg), T::len);
+		return 0;
+	}
+	n = msg->len;
+	memcpy(out, _MAV_PAYLOAD(msg), n);
+	memset((uint8_t*)out + n, 0, T::len - n);
+	return 0;
+}
+
+
+#endif /* RC_MAVLINK_TRAITS_H */
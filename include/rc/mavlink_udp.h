@@ -19,6 +19,7 @@
 
 
 #include <stdint.h>	// for specific integer types
+#include "../rc/net_platform.h"
 // these are directly from the mavlink source
 #include "../rc/mavlink/common/mavlink.h"
 #include "../include/rc/mavlink/mavlink_types.h"
@@ -28,6 +29,7 @@
 
 
 #define RC_MAV_DEFAULT_UDP_PORT	14551
+#define RC_MAV_MAX_RECEIVERS	16	// receive threads of rc_mav_receive_start
 
 
 /**
@@ -41,12 +43,29 @@ typedef enum rc_mav_connection_state_t{
 } rc_mav_connection_state_t;
 
 
+/**
+ * A packed, signed packet waiting to be sent by rc_mav_send_packets. Packets
+ * are built independently of the current destination so they can be prepared
+ * on several threads at once.
+ */
+typedef struct rc_mav_packet_t{
+	uint32_t dest_addr;		///< destination IPv4 address, network byte order
+	uint16_t dest_port;		///< destination port, 0 for the port given to rc_mav_init
+	uint8_t sysid;			///< system id the packet was sent as
+	int32_t subject;		///< subject the packet is for, for latency stats
+	uint16_t len;			///< packet length, 0 if there is nothing to send
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+} rc_mav_packet_t;
+
+
 /**
  * @brief      Initialize a UDP port for sending and receiving.
  *
- *             Initialize a UDP port for sending and receiving. Additionally
- *             starts a listening thread that handles incomming packets and
- *             makes them available with the remaining functions in this API.
+ *             Initialize a UDP port for sending and receiving. The socket is
+ *             non-blocking: incomming packets are read by rc_mav_receive,
+ *             called when rc_mav_socket is readable, for example from an
+ *             event loop (see event_loop.h), and made available with the
+ *             remaining functions in this API.
  *
  * @param[in]  system_id  The system id of this device tagged in outgoing
  *                        packets
@@ -58,6 +77,21 @@ typedef enum rc_mav_connection_state_t{
  */
 int rc_mav_init(uint8_t system_id, const char* dest_ip, uint16_t port);
 
+/**
+ * @brief      Sets the most receive threads rc_mav_receive_start may start.
+ *
+ *             Call it before rc_mav_init. With more than 1 the socket of
+ *             rc_mav_init is opened with SO_REUSEPORT so the other threads'
+ *             sockets can join it on the port, otherwise binding fails when
+ *             another socket already has the port.
+ *
+ * @param[in]  threads  Number of threads, 1 (the default) to
+ *                      RC_MAV_MAX_RECEIVERS
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_set_receive_threads(int threads);
+
 /**
  * @brief      Sets the destination ip address for sent packets.
  *
@@ -84,20 +118,82 @@ int rc_mav_set_dest_ip(const char* dest_ip);
  */
 int rc_mav_set_system_id(uint8_t system_id);
 
+/**
+ * @brief      Returns the system id packets are sent as by default.
+ */
+uint8_t rc_mav_get_system_id();
+
 
 /**
- * @brief      Closes UDP port and stops network port listening thread
+ * @brief      Closes the UDP port.
  *
- *             This is a blocking function call that returns after the network
- *             port listening thread has exited and the UDP port has closed. If
- *             the thread fails to exit before timeout a warning message is
- *             displayed and the function returns -1 to indicate there was an
- *             issue. This should be called before your program exits.
+ *             Remove rc_mav_socket from any event loop first. This should be
+ *             called before your program exits.
  *
  * @return     0 on success, -1 on failure
  */
 int rc_mav_cleanup();
 
+/**
+ * @brief      Returns the socket opened by rc_mav_init, to wait on for
+ *             incoming packets.
+ */
+rc_socket_t rc_mav_socket();
+
+/**
+ * @brief      Reads and parses every packet waiting on the socket.
+ *
+ *             Datagrams are read in batches, with one recvmmsg call per 64 on
+ *             Linux. Each message becomes the latest of its id for
+ *             rc_mav_get_msg and the like, and the callbacks set with
+ *             rc_mav_set_callback_all and rc_mav_set_callback run from here.
+ *             Only ids below 256 are kept. Messages from an address with a
+ *             signing key (see mavlink_signing.h) are dropped unless they are
+ *             signed with it and not replayed. Also marks the connection lost
+ *             when no heartbeat came for 3 seconds, so call it periodically
+ *             even when nothing arrives. While receive threads run it only
+ *             does that check.
+ *
+ * @return     number of messages received, -1 on failure
+ */
+int rc_mav_receive();
+
+/**
+ * @brief      Receives on threads of their own instead of rc_mav_receive.
+ *
+ *             The first thread reads the socket of rc_mav_init, and every
+ *             other one a socket of its own bound to the same port with
+ *             SO_REUSEPORT, so the Linux kernel spreads the senders over them
+ *             by address. Each thread has its own parser and latest-message
+ *             store, and rc_mav_get_msg and the like return the newest over
+ *             all stores. Callbacks then run on the receive threads, so set
+ *             them before starting. Other systems get one thread. Stop
+ *             watching rc_mav_socket in any event loop while they run.
+ *
+ * @param[in]  threads  Number of threads, 1 to the number given to
+ *                      rc_mav_set_receive_threads
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_receive_start(int threads);
+
+/**
+ * @brief      Stops and joins the receive threads, after which
+ *             rc_mav_receive reads the socket again.
+ */
+void rc_mav_receive_stop();
+
+/**
+ * @brief      Returns the number of messages a receiver has parsed, for
+ *             measuring how senders are spread over threads.
+ *
+ * @param[in]  receiver  The receive thread, 0 for rc_mav_receive
+ *
+ * @return     messages parsed since rc_mav_init, or since its thread started
+ *             for threads after the first
+ */
+uint64_t rc_mav_received(int receiver);
+
 
 /**
  * @brief      Sends any user-packed mavlink message
@@ -121,6 +217,103 @@ int rc_mav_cleanup();
  */
 int rc_mav_send_msg(mavlink_message_t msg);
 
+/**
+ * @brief      Sends an already serialized mavlink packet
+ *
+ *             The bytes are sent as they are to the current destination, so
+ *             they are neither re-signed nor given a new sequence number. This
+ *             is the final stage of rc_mav_send_msg and is what tlog replay
+ *             uses to re-emit recorded traffic.
+ *
+ * @param[in]  buf   The packet bytes
+ * @param[in]  len   Number of bytes
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_send_buffer(const uint8_t* buf, int len);
+
+/**
+ * @brief      Converts a dotted IPv4 address for use in rc_mav_packet_t.
+ *
+ * @param[in]  ip    The address string
+ * @param[out] addr  The address in network byte order
+ *
+ * @return     0 on success, -1 if ip is not a valid address
+ */
+int rc_mav_parse_ip(const char* ip, uint32_t* addr);
+
+/**
+ * @brief      Microseconds since the UNIX epoch, as put in outgoing messages.
+ */
+uint64_t rc_mav_time_usec();
+
+/**
+ * @brief      Packs and signs any message without sending it.
+ *
+ *             Unlike rc_mav_send_msg this touches no shared state, so it may
+ *             be called from several threads at once. The caller supplies the
+ *             sequence number, typically one counter per destination.
+ *
+ * @param[out] pkt        The packet
+ * @param[in]  dest_addr  Destination from rc_mav_parse_ip, selects the signing
+ *                        key
+ * @param[in]  dest_port  Destination port, 0 for the port given to rc_mav_init
+ * @param[in]  sysid      System id in the packet, 0 for the one given to
+ *                        rc_mav_init
+ * @param[in]  seq        Sequence number of the packet
+ * @param[in]  msgid      Message id, for example MAVLINK_MSG_ID_HEARTBEAT
+ * @param[in]  payload    The message struct, for example a mavlink_heartbeat_t
+ * @param[in]  min_len    MAVLINK_MSG_ID_*_MIN_LEN of the message
+ * @param[in]  len        MAVLINK_MSG_ID_*_LEN of the message
+ * @param[in]  crc_extra  MAVLINK_MSG_ID_*_CRC of the message
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_pack_msg(rc_mav_packet_t* pkt, uint32_t dest_addr, uint16_t dest_port,
+			uint8_t sysid, uint8_t seq, uint32_t msgid, const void* payload,
+			uint8_t min_len, uint8_t len, uint8_t crc_extra);
+
+/**
+ * rc_mav_pack_msg with the id, lengths and crc filled in from the message
+ * name, for example RC_MAV_PACK(&pkt, addr, 0, 0, seq, HEARTBEAT, &hb)
+ */
+#define RC_MAV_PACK(pkt, dest_addr, dest_port, sysid, seq, NAME, payload) \
+	rc_mav_pack_msg(pkt, dest_addr, dest_port, sysid, seq, MAVLINK_MSG_ID_##NAME, payload, \
+		MAVLINK_MSG_ID_##NAME##_MIN_LEN, MAVLINK_MSG_ID_##NAME##_LEN, MAVLINK_MSG_ID_##NAME##_CRC)
+
+/**
+ * @brief      Packs and signs an ATT_POS_MOCAP packet without sending it.
+ *
+ *             See rc_mav_pack_msg.
+ *
+ * @param[out] pkt        The packet
+ * @param[in]  dest_addr  Destination from rc_mav_parse_ip
+ * @param[in]  dest_port  Destination port, 0 for the port given to rc_mav_init
+ * @param[in]  sysid      System id, 0 for the one given to rc_mav_init
+ * @param[in]  seq        Sequence number of the packet
+ * @param[in]  q          Attitude quaternion
+ * @param[in]  x          x position
+ * @param[in]  y          y position
+ * @param[in]  z          z position
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mav_pack_att_pos_mocap(rc_mav_packet_t* pkt, uint32_t dest_addr, uint16_t dest_port,
+			uint8_t sysid, uint8_t seq, const float q[4], float x, float y, float z);
+
+/**
+ * @brief      Sends a batch of packets, each to its own destination.
+ *
+ *             Packets with len 0 are skipped. The len of packets that fail to
+ *             send is set to 0 so the caller can tell which were lost.
+ *
+ * @param      pkts  The packets
+ * @param[in]  n     Number of packets
+ *
+ * @return     number of packets sent, -1 on failure
+ */
+int rc_mav_send_packets(rc_mav_packet_t* pkts, int n);
+
 /**
  * @brief      Inidcates if a particular message type has been received by not
  *             read by the user yet.
@@ -0,0 +1,69 @@
+/**
+ * @file mocap_capture.h
+ *
+ * @brief      Append-only capture of the frames a MocapSource delivered.
+ *
+ *             A capture file is an rc_mocap_capture_header_t followed by
+ *             frames exactly as they are laid out in memory (see
+ *             mocap_source.h). Every record is a multiple of 8 bytes, so the
+ *             replay source can map the file and hand out pointers into it
+ *             without parsing or copying. Frames are written through a large
+ *             stdio buffer, a write costs a memcpy in the common case.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_MOCAP_CAPTURE_H
+#define RC_MOCAP_CAPTURE_H
+
+#include <stdint.h>	// for specific integer types
+#include "../rc/mocap_source.h"
+
+#define RC_MOCAP_CAPTURE_MAGIC		"RCMOCAP"
+#define RC_MOCAP_CAPTURE_VERSION	1
+
+/**
+ * Capture file header. The record sizes let a reader reject files written
+ * with a different layout.
+ */
+typedef struct rc_mocap_capture_header_t{
+	char magic[8];			///< RC_MOCAP_CAPTURE_MAGIC
+	uint32_t version;		///< RC_MOCAP_CAPTURE_VERSION
+	uint32_t frame_header_size;	///< sizeof(rc_mocap_frame_t)
+	uint32_t subject_size;		///< sizeof(rc_mocap_subject_t)
+	uint32_t reserved;
+} rc_mocap_capture_header_t;
+
+
+/**
+ * @brief      Creates a capture file, overwriting an existing one.
+ *
+ * @param[in]  path  Path of the capture file
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mocap_capture_start(const char* path);
+
+/**
+ * @brief      Returns 1 while a capture file is open, otherwise 0.
+ */
+int rc_mocap_capture_is_running();
+
+/**
+ * @brief      Appends a frame to the capture file.
+ *
+ * @param[in]  frame  The frame and its subjects
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_mocap_capture_write(const rc_mocap_frame_t* frame);
+
+/**
+ * @brief      Flushes and closes the capture file.
+ *
+ * @return     number of frames captured
+ */
+uint64_t rc_mocap_capture_stop();
+
+
+#endif /* RC_MOCAP_CAPTURE_H */
@@ -0,0 +1,257 @@
+/**
+ * @file mocap_source.h
+ *
+ * @brief      Sources of motion capture frames for the bridge.
+ *
+ *             A MocapSource delivers one frame at a time in a flat layout: an
+ *             rc_mocap_frame_t header immediately followed by subject_count
+ *             rc_mocap_subject_t records. The same layout is used live, in
+ *             capture files and in replay, so a replayed frame is a pointer
+ *             straight into the mapped capture file.
+ *
+ *             The Vicon source wraps the DataStream SDK client, the replay
+ *             source plays back a file written with rc_mocap_capture_write
+ *             (see mocap_capture.h) at real time, a multiple of it, or as
+ *             fast as possible. Vicon frames can be fanned out to several
+ *             bridges with server multicast, each bridge processing only its
+ *             hash shard of the subjects. The fan-in source merges several
+ *             others, for example one Vicon server per capture volume, into a
+ *             single subject table. The threaded source moves any of them onto
+ *             an acquisition thread of its own, so the bridge's event loop
+ *             never waits on a source.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_MOCAP_SOURCE_H
+#define RC_MOCAP_SOURCE_H
+
+#include <stdint.h>	// for specific integer types
+
+#define RC_MOCAP_NAME_LEN	64
+#define RC_MOCAP_SPEED_AFAP	0.0	// replay as fast as possible
+#define RC_MOCAP_MAX_SOURCES	8	// servers merged by one fan-in source
+
+// return values of MocapSource::next_frame
+#define RC_MOCAP_FRAME		0	// a new frame is available
+#define RC_MOCAP_NO_FRAME	-1	// nothing this time, try again
+#define RC_MOCAP_END		1	// the source is exhausted
+
+/**
+ * SMPTE timecode of a frame as reported by the SDK
+ */
+typedef struct rc_mocap_timecode_t{
+	uint8_t hours;
+	uint8_t minutes;
+	uint8_t seconds;
+	uint8_t frames;
+	uint16_t subframe;
+	uint16_t subframes_per_frame;
+} rc_mocap_timecode_t;
+
+/**
+ * Pose of one subject's root segment in a frame
+ */
+typedef struct rc_mocap_subject_t{
+	char name[RC_MOCAP_NAME_LEN];	///< subject name, NUL terminated
+	double translation[3];		///< global translation in millimeters
+	double quaternion[4];		///< global rotation as reported by the SDK, x, y, z, w order
+	double quality;			///< object quality, -1 if unavailable
+	uint32_t occluded;		///< 1 if the subject was occluded
+	uint16_t index;			///< stable index of the subject in its source
+	uint16_t source;		///< merged server the pose came from, 0 otherwise
+} rc_mocap_subject_t;
+
+/**
+ * How a Vicon source connects and which subjects it handles
+ */
+typedef struct rc_mocap_vicon_config_t{
+	const char* host;		///< server host:port, or the local interface when joining multicast
+	const char* multicast_send;	///< group:port the server should multicast to, NULL for none
+	const char* multicast_interface;///< bare IP of the server interface multicast_send leaves from
+	const char* multicast_join;	///< group:port to receive from instead of connecting, NULL for none
+	int shard_index;		///< shard handled by this bridge, 0 to shard_count-1
+	int shard_count;		///< number of shards, 1 to handle every subject
+} rc_mocap_vicon_config_t;
+
+/**
+ * Frame header, followed in memory by subject_count rc_mocap_subject_t
+ */
+typedef struct rc_mocap_frame_t{
+	uint32_t size;			///< bytes of header and subjects together
+	uint32_t subject_count;		///< number of subjects that follow
+	uint64_t frame_number;		///< SDK frame number
+	uint64_t capture_usec;		///< time the frame arrived, usec since the unix epoch
+	double latency_s;		///< SDK total latency in seconds
+	rc_mocap_timecode_t timecode;	///< SDK timecode
+} rc_mocap_frame_t;
+
+
+/**
+ * @brief      Returns the subject records that follow a frame header.
+ *
+ * @param[in]  frame  The frame
+ *
+ * @return     array of frame->subject_count subjects
+ */
+inline const rc_mocap_subject_t* rc_mocap_frame_subjects(const rc_mocap_frame_t* frame)
+{
+	return (const rc_mocap_subject_t*)(frame + 1);
+}
+
+/**
+ * @brief      Returns the record size of a frame with n subjects.
+ *
+ * @param[in]  n     Number of subjects
+ *
+ * @return     size in bytes
+ */
+inline uint32_t rc_mocap_frame_size(uint32_t n)
+{
+	return (uint32_t)(sizeof(rc_mocap_frame_t) + n * sizeof(rc_mocap_subject_t));
+}
+
+/**
+ * @brief      Returns the shard a subject belongs to.
+ *
+ *             FNV-1a of the name with a murmur3 finalizer to spread similar
+ *             names, so every bridge computes the same balanced partition
+ *             whatever order the server lists subjects in.
+ *
+ * @param[in]  name   The subject name
+ * @param[in]  count  Number of shards
+ *
+ * @return     shard from 0 to count-1
+ */
+inline int rc_mocap_shard_of(const char* name, int count)
+{
+	uint32_t h = 2166136261u;
+	while(*name){
+		h ^= (uint8_t)*name++;
+		h *= 16777619u;
+	}
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return (int)(h % (uint32_t)count);
+}
+
+
+/**
+ * Interface implemented by every frame source
+ */
+class MocapSource
+{
+public:
+	virtual ~MocapSource() {}
+
+	/**
+	 * @brief      Waits for and returns the next frame.
+	 *
+	 * @param[out] frame  The frame, valid until the next call
+	 *
+	 * @return     RC_MOCAP_FRAME, RC_MOCAP_NO_FRAME or RC_MOCAP_END
+	 */
+	virtual int next_frame(const rc_mocap_frame_t** frame) = 0;
+
+	/**
+	 * @brief      Allocates the frame buffers for up to max_subjects subjects
+	 *             now, so none grows while frames stream. Frames with more
+	 *             subjects still work. Call it from the thread reading
+	 *             frames, sources running others on threads of their own
+	 *             pass it on to those threads.
+	 */
+	virtual void reserve(int max_subjects) {}
+};
+
+
+/**
+ * @brief      Connects to a Vicon DataStream server.
+ *
+ *             Retries every half second until the server answers and has at
+ *             least one subject, printing the subjects found. With
+ *             multicast_send the server also multicasts every frame from
+ *             multicast_interface, so other bridges can join with
+ *             multicast_join and put no further load on it. Subjects outside
+ *             this bridge's shard are skipped before any of their data is read
+ *             from the SDK.
+ *
+ * @param[in]  config   Connection and shard settings
+ * @param[in]  running  Connecting gives up when this becomes 0
+ *
+ * @return     the source, NULL on failure
+ */
+MocapSource* rc_mocap_vicon_source_create(const rc_mocap_vicon_config_t* config, const int* running);
+
+/**
+ * @brief      Opens a capture file for replay.
+ *
+ *             Frames are paced by their capture_usec stamps divided by speed.
+ *             A truncated last frame, as left by a crash while capturing, ends
+ *             the replay early.
+ *
+ * @param[in]  path   Path of the capture file
+ * @param[in]  speed  1.0 for real time, N for N times, RC_MOCAP_SPEED_AFAP
+ *
+ * @return     the source, NULL on failure
+ */
+MocapSource* rc_mocap_replay_source_create(const char* path, double speed);
+
+/**
+ * @brief      Creates a source of generated frames for benchmarks and tests.
+ *
+ *             Subject i is named synthNNNN@127.x.y.z with a loopback address
+ *             of its own and flies a circle of its own phase, height and
+ *             radius. Frames are full, with no occlusion.
+ *
+ * @param[in]  subjects  Number of subjects per frame
+ * @param[in]  rate_hz   Frame rate, RC_MOCAP_SPEED_AFAP for as fast as possible
+ *
+ * @return     the source, NULL on failure
+ */
+MocapSource* rc_mocap_synthetic_source_create(int subjects, double rate_hz);
+
+/**
+ * @brief      Merges several sources into one subject table.
+ *
+ *             Each source gets its own acquisition thread that keeps only its
+ *             latest frame. next_frame returns whenever any source delivered a
+ *             new frame, with every subject resolved by name to one source:
+ *             the current owner is kept while it sees the subject unoccluded
+ *             and recently, and ownership hands over to another source when
+ *             the owner loses it or the other sees it with clearly better
+ *             quality. Subjects are only included when their chosen pose is
+ *             newer than the one last returned, and each server's frame lag is
+ *             published to the status display.
+ *
+ * @param[in]  sources  The sources, ownership passes to the fan-in source
+ * @param[in]  names    Names of the sources for the display
+ * @param[in]  n        Number of sources, 1 to RC_MOCAP_MAX_SOURCES
+ *
+ * @return     the source, NULL on failure
+ */
+MocapSource* rc_mocap_fanin_source_create(MocapSource** sources, const char** names, int n);
+
+/**
+ * @brief      Runs a source on an acquisition thread of its own.
+ *
+ *             The thread waits on the source and copies each frame into a
+ *             slot, then calls on_frame, for example rc_loop_wakeup. The
+ *             returned source's next_frame never waits: it returns the slot's
+ *             frame, RC_MOCAP_NO_FRAME while the thread is still waiting, or
+ *             RC_MOCAP_END once the source has ended. The thread waits for the
+ *             slot to be taken before copying the next frame, so replays
+ *             still deliver every frame.
+ *
+ * @param[in]  source    The source, ownership passes to the threaded source
+ * @param[in]  on_frame  Called from the thread after each frame and at the
+ *                       end, NULL for none
+ *
+ * @return     the source, NULL on failure
+ */
+MocapSource* rc_mocap_threaded_source_create(MocapSource* source, void (*on_frame)());
+
+
+#endif /* RC_MOCAP_SOURCE_H */
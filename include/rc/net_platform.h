@@ -0,0 +1,171 @@
+/**
+ * @file net_platform.h
+ *
+ * @brief      The few socket and clock calls that differ between WinSock and
+ *             POSIX, so the UDP and event loop code is written once.
+ *
+ *             Sockets are rc_socket_t, SOCKET on Windows and a file
+ *             descriptor elsewhere, and RC_INVALID_SOCKET when not open.
+ *             rc_net_init and rc_net_cleanup pair up WSAStartup and
+ *             WSACleanup, which count their callers, and do nothing on POSIX.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_NET_PLATFORM_H
+#define RC_NET_PLATFORM_H
+
+#include <stdint.h>	// for specific integer types
+#include <chrono>
+#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#ifdef _WIN32
+typedef SOCKET rc_socket_t;
+typedef int rc_socklen_t;
+#define RC_INVALID_SOCKET	INVALID_SOCKET
+#else
+typedef int rc_socket_t;
+typedef socklen_t rc_socklen_t;
+#define RC_INVALID_SOCKET	(-1)
+#endif
+
+
+/**
+ * @brief      Starts the socket library, once per rc_net_cleanup.
+ *
+ * @return     0 on success, -1 on failure
+ */
+inline int rc_net_init()
+{
+#ifdef _WIN32
+	WSADATA wsa;
+	if(WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return -1;
+#endif
+	return 0;
+}
+
+/**
+ * @brief      Releases the socket library after rc_net_init.
+ */
+inline void rc_net_cleanup()
+{
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+/**
+ * @brief      Closes a socket.
+ */
+inline void rc_sock_close(rc_socket_t sock)
+{
+#ifdef _WIN32
+	closesocket(sock);
+#else
+	close(sock);
+#endif
+}
+
+/**
+ * @brief      Makes calls on a socket return instead of waiting.
+ *
+ * @return     0 on success, -1 on failure
+ */
+inline int rc_sock_set_nonblocking(rc_socket_t sock)
+{
+#ifdef _WIN32
+	u_long on = 1;
+	return ioctlsocket(sock, FIONBIO, &on) == 0 ? 0 : -1;
+#else
+	int flags = fcntl(sock, F_GETFL, 0);
+	if(flags < 0) return -1;
+	return fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0 ? 0 : -1;
+#endif
+}
+
+/**
+ * @brief      Tells whether the last call on a non-blocking socket failed
+ *             only because it would have had to wait.
+ */
+inline int rc_sock_would_block()
+{
+#ifdef _WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+/**
+ * @brief      Waits for room to send on a socket.
+ *
+ * @param[in]  sock        The socket
+ * @param[in]  timeout_ms  How long to wait at most
+ *
+ * @return     1 when it can send, 0 on timeout, -1 on failure
+ */
+inline int rc_sock_wait_writable(rc_socket_t sock, int timeout_ms)
+{
+#ifdef _WIN32
+	WSAPOLLFD p;
+	p.fd = sock;
+	p.events = POLLWRNORM;
+	p.revents = 0;
+	return WSAPoll(&p, 1, timeout_ms);
+#else
+	struct pollfd p;
+	p.fd = sock;
+	p.events = POLLOUT;
+	p.revents = 0;
+	return poll(&p, 1, timeout_ms);
+#endif
+}
+
+/**
+ * @brief      Waits for data to read on a socket.
+ *
+ * @param[in]  sock        The socket
+ * @param[in]  timeout_ms  How long to wait at most
+ *
+ * @return     1 when there is data, 0 on timeout, -1 on failure
+ */
+inline int rc_sock_wait_readable(rc_socket_t sock, int timeout_ms)
+{
+#ifdef _WIN32
+	WSAPOLLFD p;
+	p.fd = sock;
+	p.events = POLLRDNORM;
+	p.revents = 0;
+	return WSAPoll(&p, 1, timeout_ms);
+#else
+	struct pollfd p;
+	p.fd = sock;
+	p.events = POLLIN;
+	p.revents = 0;
+	return poll(&p, 1, timeout_ms);
+#endif
+}
+
+/**
+ * @brief      Microseconds since the UNIX epoch from the system clock, the
+ *             clock mocap frames are stamped with.
+ */
+inline uint64_t rc_net_time_usec()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+#endif /* RC_NET_PLATFORM_H */
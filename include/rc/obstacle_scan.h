@@ -0,0 +1,113 @@
+/**
+ * @file obstacle_scan.h
+ *
+ * @brief      Synthesized 360 degree range scans, as an OBSTACLE_DISTANCE
+ *             sensor on each vehicle would see the other tracked subjects and
+ *             the fixed obstacles of the room.
+ *
+ *             Every obstacle is a vertical cylinder: the other subjects with
+ *             the radius of a vehicle, as long as they fly within a height band
+ *             of the scanning one, and the fixed obstacles with their own
+ *             radius at any height. A scan has RC_SCAN_SECTORS sectors of
+ *             RC_SCAN_INCREMENT degrees, sector 0 centered on the vehicle's
+ *             forward (the subject's x axis) and going clockwise seen from
+ *             above, and holds the distance to the nearest obstacle overlapping
+ *             each sector.
+ *
+ *             rc_scan_build bins the subjects of a frame into squares the size
+ *             of the range, counting-sorted as in spatial_grid.h, so a scan only
+ *             looks at the 3 x 3 squares around the vehicle. For each obstacle
+ *             left the scan works out its bearing, angular half width and
+ *             nearest distance once, and then tests it against every sector in
+ *             one branch-free loop over a table of sector directions, which the
+ *             compiler turns into a few vector compares and minimums. An
+ *             obstacle overlapping a sector counts with its nearest distance
+ *             over the whole sector, which errs on the short side at its edges.
+ *
+ *             Positions are in millimeters in the SDK frame, z up. Scans only
+ *             read what rc_scan_build made and may run on every worker at once.
+ *             Building must not overlap them.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_OBSTACLE_SCAN_H
+#define RC_OBSTACLE_SCAN_H
+
+#include <stdint.h>	// for specific integer types
+
+#define RC_SCAN_SECTORS			72	// as many as OBSTACLE_DISTANCE holds
+#define RC_SCAN_INCREMENT		5	// degrees per sector
+#define RC_SCAN_MIN_CM			10	// closer obstacles read this
+#define RC_SCAN_DEFAULT_RANGE		10.0f	// meters
+#define RC_SCAN_DEFAULT_VEHICLE_RADIUS	0.3f	// meters
+#define RC_SCAN_DEFAULT_BAND		1.0f	// meters above or below that count
+
+/**
+ * What a scan sees
+ */
+typedef struct rc_scan_config_t{
+	float range_m;			///< farther obstacles are not seen
+	float vehicle_radius_m;		///< radius of the cylinder of another subject
+	float band_m;			///< subjects further above or below are not seen
+} rc_scan_config_t;
+
+/**
+ * A fixed obstacle, a vertical cylinder from floor to ceiling
+ */
+typedef struct rc_scan_obstacle_t{
+	float x;			///< center, millimeters
+	float y;			///< center, millimeters
+	float radius;			///< millimeters
+} rc_scan_obstacle_t;
+
+
+/**
+ * @brief      Fills a config with the RC_SCAN_DEFAULT_* values.
+ */
+void rc_scan_default_config(rc_scan_config_t* cfg);
+
+/**
+ * @brief      Prepares the scans of one frame.
+ *
+ * @param[in]  x, y, z    Position of every subject, millimeters
+ * @param[in]  n          Number of subjects, which are then known by their
+ *                        index
+ * @param[in]  fixed      Fixed obstacles, may be NULL if num_fixed is 0
+ * @param[in]  num_fixed  Number of fixed obstacles
+ * @param[in]  cfg        What the scans see
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_scan_build(const float* x, const float* y, const float* z, int n,
+			const rc_scan_obstacle_t* fixed, int num_fixed, const rc_scan_config_t* cfg);
+
+/**
+ * @brief      Scans around one position.
+ *
+ * @param[in]  p          The position, millimeters
+ * @param[in]  yaw        Heading of the vehicle, radians counterclockwise from
+ *                        the SDK x axis
+ * @param[in]  self       Subject to leave out, -1 for none
+ * @param[out] distances  Centimeters to the nearest obstacle of every sector,
+ *                        RC_SCAN_MIN_CM at least, and the range in centimeters
+ *                        plus one where there is none, as OBSTACLE_DISTANCE
+ *                        wants them
+ *
+ * @return     range in centimeters, for OBSTACLE_DISTANCE's max_distance
+ */
+uint16_t rc_scan_sectors(const float p[3], float yaw, int self, uint16_t distances[RC_SCAN_SECTORS]);
+
+/**
+ * @brief      Allocates the bins for up to n subjects now, so building them
+ *             for that many never allocates.
+ */
+void rc_scan_reserve(int n);
+
+/**
+ * @brief      Frees the bins.
+ */
+void rc_scan_cleanup();
+
+
+#endif /* RC_OBSTACLE_SCAN_H */
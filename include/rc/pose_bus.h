@@ -0,0 +1,190 @@
+/**
+ * @file pose_bus.h
+ *
+ * @brief      Shared-memory bus publishing every frame's pose table to other
+ *             processes on the same machine.
+ *
+ *             The bridge creates a named segment and publishes each frame
+ *             into the next of RC_POSEBUS_SLOTS frame slots. Every slot is a
+ *             struct of arrays (one array per pose component) guarded by its
+ *             own seqlock, and the header counts published frames. Readers map
+ *             the segment read-only and get pointers straight into the newest
+ *             slot, so reading a frame takes no copies and no system calls.
+ *             Because the writer only comes back to a slot RC_POSEBUS_SLOTS
+ *             frames later, a reader has that long to use a frame before
+ *             rc_posebus_frame_valid reports it overwritten.
+ *
+ *             Subject names change rarely and live in a separate table indexed
+ *             by the subject's stable index, with one seqlock for the table.
+ *
+ *             pose_bus.cpp needs no other source file, so local planners and
+ *             visualizers can build the reader with just it and the headers.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_POSE_BUS_H
+#define RC_POSE_BUS_H
+
+#include <stdint.h>	// for specific integer types
+#include <stddef.h>
+#include <atomic>
+#include "../rc/mocap_source.h"
+
+#define RC_POSEBUS_DEFAULT_NAME		"rc_mocap_poses"
+#define RC_POSEBUS_DEFAULT_CAPACITY	1024	// subjects per frame
+#define RC_POSEBUS_SLOTS		4	// frames kept in the segment
+#define RC_POSEBUS_MAGIC		0x53554250	// "PBUS"
+#define RC_POSEBUS_VERSION		1
+
+// return values of rc_posebus_read_latest
+#define RC_POSEBUS_FRAME	0	// frame filled in
+#define RC_POSEBUS_NO_FRAME	-1	// nothing published yet
+#define RC_POSEBUS_CLOSED	1	// the bridge closed the bus
+
+/**
+ * Start of the segment. The offsets are from the start of the segment and
+ * every array is 64 byte aligned.
+ */
+typedef struct rc_posebus_header_t{
+	uint32_t magic;			///< RC_POSEBUS_MAGIC
+	uint32_t version;		///< RC_POSEBUS_VERSION
+	uint32_t capacity;		///< subjects per slot and entries in the name table
+	uint32_t num_slots;		///< RC_POSEBUS_SLOTS
+	uint64_t size;			///< size of the whole segment in bytes
+	uint64_t names_offset;		///< capacity names of RC_MOCAP_NAME_LEN bytes
+	uint64_t slots_offset;		///< first slot
+	uint64_t slot_size;		///< bytes from one slot to the next
+	alignas(64) std::atomic<uint64_t> published;	///< frames published, newest is in slot (published-1) % num_slots
+	std::atomic<uint32_t> open;			///< cleared when the bridge closes the bus
+	alignas(64) std::atomic<uint32_t> names_seq;	///< seqlock of the name table
+} rc_posebus_header_t;
+
+/**
+ * Header of one frame slot, followed by its arrays of capacity entries in the
+ * order index, occluded, x, y, z, q[0], q[1], q[2], q[3]
+ */
+typedef struct rc_posebus_slot_t{
+	alignas(64) std::atomic<uint32_t> seq;	///< odd while the slot is being written
+	uint32_t subject_count;		///< entries used in each array
+	uint64_t frame_number;		///< frame number from the mocap source
+	uint64_t capture_usec;		///< microseconds since the epoch when captured
+	uint64_t publish_ns;		///< steady clock at publish, for latency on this machine
+	double latency_s;		///< mocap system latency reported with the frame
+} rc_posebus_slot_t;
+
+/**
+ * A frame as seen by a reader. The arrays point into shared memory and hold
+ * subject_count entries of the raw mocap pose: positions in millimeters and
+ * rotations as the Vicon SDK's x, y, z, w quaternion, both in the mocap frame.
+ * Routes may send the drones a transformed NED pose instead (see routing.h).
+ */
+typedef struct rc_posebus_frame_t{
+	uint64_t frame_number;
+	uint64_t capture_usec;
+	uint64_t publish_ns;
+	double latency_s;
+	uint32_t subject_count;
+	const uint16_t* index;		///< stable subject index, see rc_posebus_subject_name
+	const uint8_t* occluded;
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* q[4];		///< q[k][i] is element k of the SDK quaternion, x, y, z, w order
+	const rc_posebus_slot_t* slot;	///< private, used by rc_posebus_frame_valid
+	uint32_t seq;			///< private
+} rc_posebus_frame_t;
+
+/**
+ * A reader's mapping of the bus
+ */
+typedef struct rc_posebus_reader_t{
+	const rc_posebus_header_t* header;	///< NULL if not open
+	size_t size;				///< bytes mapped
+	void* handle;				///< platform specific, don't touch
+} rc_posebus_reader_t;
+
+
+/**
+ * @brief      Creates the named segment and starts publishing to it.
+ *
+ *             Only one bus can be published per process. Subjects whose
+ *             stable index is capacity or more are left out. Fails if another
+ *             bridge has the name open, on Linux a segment left by a bridge
+ *             that closed its bus is replaced.
+ *
+ * @param[in]  name      Name of the segment, for example RC_POSEBUS_DEFAULT_NAME
+ * @param[in]  capacity  Largest number of subjects per frame
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_posebus_create(const char* name, int capacity);
+
+/**
+ * @brief      Publishes a frame's poses to the bus.
+ *
+ * @param[in]  frame  The frame
+ *
+ * @return     number of subjects published, -1 if the bus is not created
+ */
+int rc_posebus_publish(const rc_mocap_frame_t* frame);
+
+/**
+ * @brief      Marks the bus closed for readers and removes the segment.
+ */
+void rc_posebus_destroy();
+
+/**
+ * @brief      Maps a bus created by the bridge read-only.
+ *
+ * @param[in]  name    Name the bridge created the bus with
+ * @param[out] reader  The mapping
+ *
+ * @return     0 on success, -1 if there is no such bus or it doesn't match
+ *             this version
+ */
+int rc_posebus_open(const char* name, rc_posebus_reader_t* reader);
+
+/**
+ * @brief      Points frame at the newest consistent frame on the bus.
+ *
+ *             Check rc_posebus_frame_valid after using the arrays, a slow
+ *             reader may have had the slot overwritten underneath it.
+ *
+ * @param[in]  reader  The mapping
+ * @param[out] frame   The frame
+ *
+ * @return     RC_POSEBUS_FRAME, RC_POSEBUS_NO_FRAME or RC_POSEBUS_CLOSED
+ */
+int rc_posebus_read_latest(const rc_posebus_reader_t* reader, rc_posebus_frame_t* frame);
+
+/**
+ * @brief      Checks the frame was not overwritten since it was read.
+ *
+ * @param[in]  frame  Frame from rc_posebus_read_latest
+ *
+ * @return     1 if everything read from the frame so far is consistent, 0 if
+ *             the frame must be read again
+ */
+int rc_posebus_frame_valid(const rc_posebus_frame_t* frame);
+
+/**
+ * @brief      Copies the name of a subject.
+ *
+ * @param[in]  reader  The mapping
+ * @param[in]  index   Stable subject index from rc_posebus_frame_t::index
+ * @param[out] name    At least RC_MOCAP_NAME_LEN bytes
+ *
+ * @return     0 on success, -1 if the index is out of range
+ */
+int rc_posebus_subject_name(const rc_posebus_reader_t* reader, int index, char* name);
+
+/**
+ * @brief      Unmaps the bus.
+ *
+ * @param      reader  The mapping
+ */
+void rc_posebus_close(rc_posebus_reader_t* reader);
+
+
+#endif /* RC_POSE_BUS_H */
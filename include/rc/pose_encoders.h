@@ -0,0 +1,350 @@
+/**
+ * @file pose_encoders.h
+ *
+ * @brief      The messages a pose can be sent as, one per destination.
+ *
+ *             The bridge fills one rc_pose_t per subject and frame and hands it
+ *             to rc_pose_pack with the format of each destination (see
+ *             RC_ROUTE_FORMAT_* in routing.h). Every format is a specialization
+ *             of rc_pose_encoder, and rc_pose_pack switches on the format to
+ *             the one specialization compiled for it, so a destination only
+ *             pays for what its message needs: the Euler angles, velocity,
+ *             covariance or geodetic position are worked out inside the
+ *             encoders that send them and nowhere else. Adding a format is a
+ *             specialization and a case in rc_pose_pack. The encoders fill
+ *             the message struct and pack it with rc_mav_pack (see
+ *             mavlink_traits.h).
+ *
+ *             Variances come from the bridge's velocity filter: the position
+ *             variance is the running variance of the difference between each
+ *             frame and the one predicted from the frame before, and the
+ *             velocity variance what the low-pass filter leaves of it.
+ *
+ *             Formats that need north-east-down meters, LOCAL_POSITION_NED,
+ *             GPS_INPUT and HIL_GPS, take the route's frame=ned frame, or for
+ *             raw routes north along the SDK x axis and up along its z axis.
+ *             The geodetic positions of GPS_INPUT and HIL_GPS are converted
+ *             for every subject of a frame at once by the bridge (see
+ *             geodetic.h) and only worked out here for poses averaged over
+ *             several frames.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_POSE_ENCODERS_H
+#define RC_POSE_ENCODERS_H
+
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <math.h>
+#include "../rc/mavlink_traits.h"
+#include "../rc/routing.h"
+#include "../rc/geodetic.h"
+
+#define RC_POSE_GPS_EPOCH_S	315964800ull	// 1980-01-06 in UNIX time
+#define RC_POSE_GPS_LEAP_S	18ull		// GPS time ahead of UTC
+#define RC_POSE_GPS_SATELLITES	20		// reported with GPS_INPUT and HIL_GPS
+#define RC_POSE_CDEG_PER_RAD	5729.5779513f	// course over ground in HIL_GPS
+
+/**
+ * Everything any format may send of one subject in one frame
+ */
+typedef struct rc_pose_t{
+	uint64_t time_usec;			///< from rc_mav_time_usec
+	const rc_route_transform_t* transform;	///< the route's frame
+	float pos[3];				///< in the route's frame
+	float q[4];				///< as the route sends it, x y z w raw, w x y z ned
+	const float* vel;			///< SDK frame, mm/s
+	const float* var_pos;			///< SDK frame per axis, mm^2
+	const float* var_vel;			///< SDK frame per axis, (mm/s)^2
+	int has_lla;				///< lla is pos converted already
+	double lla[3];				///< degrees, degrees, meters
+} rc_pose_t;
+
+
+/**
+ * Roll, pitch and yaw of the pose's quaternion, in the route's frame
+ */
+inline void rc_pose_euler(const rc_pose_t* p, float rpy[3])
+{
+	float w, x, y, z, s;
+
+	if(p->transform->ned){
+		w = p->q[0]; x = p->q[1]; y = p->q[2]; z = p->q[3];
+	}
+	else{
+		x = p->q[0]; y = p->q[1]; z = p->q[2]; w = p->q[3];
+	}
+	s = 2.0f * (w * y - z * x);
+	s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+	rpy[0] = atan2f(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y));
+	rpy[1] = asinf(s);
+	rpy[2] = atan2f(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z));
+}
+
+/**
+ * The transform to north-east-down meters for a route, its own with
+ * frame=ned, north along x and down along -z for raw routes
+ */
+inline const rc_route_transform_t* rc_pose_ned_transform(const rc_route_transform_t* route)
+{
+	static const rc_route_transform_t sdk_ned = {1,
+		{0.001f, 0.0f, 0.0f, 0.0f, -0.001f, 0.0f, 0.0f, 0.0f, -0.001f},
+		{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f, 0.0f}};
+
+	return route->ned ? route : &sdk_ned;
+}
+
+/**
+ * Position, velocity and their variances in north-east-down meters, the
+ * covariances as upper triangles xx xy xz yy yz zz, NULL if not wanted
+ */
+inline void rc_pose_ned(const rc_pose_t* p, float pos[3], float vel[3], float cov_pos[6], float cov_vel[6])
+{
+	const rc_route_transform_t* t = rc_pose_ned_transform(p->transform);
+	int k;
+
+	if(p->transform->ned){
+		for(k=0; k<3; k++) pos[k] = p->pos[k];
+	}
+	else rc_route_transform_vector(t, p->pos, 0, pos);
+	rc_route_transform_vector(t, p->vel, 0, vel);
+	if(cov_pos != NULL) rc_route_transform_covariance(t, p->var_pos, cov_pos);
+	if(cov_vel != NULL) rc_route_transform_covariance(t, p->var_vel, cov_vel);
+}
+
+/**
+ * Geodetic position of the pose, from the bridge if it has it
+ */
+inline void rc_pose_lla(const rc_pose_t* p, const float ned[3], double lla[3])
+{
+	if(p->has_lla){
+		lla[0] = p->lla[0];
+		lla[1] = p->lla[1];
+		lla[2] = p->lla[2];
+	}
+	else rc_geo_point(ned, lla);
+}
+
+/**
+ * GPS week and milliseconds into it of a UNIX time
+ */
+inline void rc_pose_gps_time(uint64_t time_usec, uint16_t* week, uint32_t* week_ms)
+{
+	uint64_t gps_ms = (time_usec / 1000000ull - RC_POSE_GPS_EPOCH_S + RC_POSE_GPS_LEAP_S) * 1000ull
+			+ time_usec / 1000 % 1000;
+
+	*week = (uint16_t)(gps_ms / 604800000ull);
+	*week_ms = (uint32_t)(gps_ms % 604800000ull);
+}
+
+
+/**
+ * One specialization per RC_ROUTE_FORMAT_*, each packing the pose into its
+ * message
+ */
+template<int FORMAT> struct rc_pose_encoder;
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_ATT_POS_MOCAP>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		mavlink_att_pos_mocap_t msg;
+
+		msg.time_usec = p->time_usec;
+		memcpy(msg.q, p->q, sizeof(msg.q));
+		msg.x = p->pos[0];
+		msg.y = p->pos[1];
+		msg.z = p->pos[2];
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_VISION_POSITION_ESTIMATE>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		mavlink_vision_position_estimate_t msg;
+		float rpy[3];
+
+		rc_pose_euler(p, rpy);
+		msg.usec = p->time_usec;
+		msg.x = p->pos[0];
+		msg.y = p->pos[1];
+		msg.z = p->pos[2];
+		msg.roll = rpy[0];
+		msg.pitch = rpy[1];
+		msg.yaw = rpy[2];
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_VICON_POSITION_ESTIMATE>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		mavlink_vicon_position_estimate_t msg;
+		float rpy[3];
+
+		rc_pose_euler(p, rpy);
+		msg.usec = p->time_usec;
+		msg.x = p->pos[0];
+		msg.y = p->pos[1];
+		msg.z = p->pos[2];
+		msg.roll = rpy[0];
+		msg.pitch = rpy[1];
+		msg.yaw = rpy[2];
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_LOCAL_POSITION_NED>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		mavlink_local_position_ned_t msg;
+		float pos[3], vel[3];
+
+		rc_pose_ned(p, pos, vel, NULL, NULL);
+		msg.time_boot_ms = (uint32_t)(p->time_usec / 1000);
+		msg.x = pos[0];
+		msg.y = pos[1];
+		msg.z = pos[2];
+		msg.vx = vel[0];
+		msg.vy = vel[1];
+		msg.vz = vel[2];
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_LOCAL_POSITION_NED_COV>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		// first entry of each row of the 9 x 9 upper triangle
+		static const int row[9] = {0, 9, 17, 24, 30, 35, 39, 42, 44};
+		mavlink_local_position_ned_cov_t msg;
+		float pos[3], vel[3], cov_pos[6], cov_vel[6];
+		float cov[45];
+
+		rc_pose_ned(p, pos, vel, cov_pos, cov_vel);
+		memset(&msg, 0, sizeof(msg));
+		msg.time_usec = p->time_usec;
+		msg.estimator_type = MAV_ESTIMATOR_TYPE_VISION;
+		msg.x = pos[0];
+		msg.y = pos[1];
+		msg.z = pos[2];
+		msg.vx = vel[0];
+		msg.vy = vel[1];
+		msg.vz = vel[2];
+		// position and velocity are estimated apart, acceleration not at all
+		memset(cov, 0, sizeof(cov));
+		cov[row[0]] = cov_pos[0];	cov[row[0] + 1] = cov_pos[1];	cov[row[0] + 2] = cov_pos[2];
+		cov[row[1]] = cov_pos[3];	cov[row[1] + 1] = cov_pos[4];
+		cov[row[2]] = cov_pos[5];
+		cov[row[3]] = cov_vel[0];	cov[row[3] + 1] = cov_vel[1];	cov[row[3] + 2] = cov_vel[2];
+		cov[row[4]] = cov_vel[3];	cov[row[4] + 1] = cov_vel[4];
+		cov[row[5]] = cov_vel[5];
+		cov[row[6]] = cov[row[7]] = cov[row[8]] = NAN;
+		memcpy(msg.covariance, cov, sizeof(cov));
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_GPS_INPUT>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		mavlink_gps_input_t msg;
+		float pos[3], vel[3], cov_pos[6], cov_vel[6];
+		double lla[3];
+		uint16_t week;
+		uint32_t week_ms;
+
+		rc_pose_ned(p, pos, vel, cov_pos, cov_vel);
+		rc_pose_lla(p, pos, lla);
+		rc_pose_gps_time(p->time_usec, &week, &week_ms);
+		memset(&msg, 0, sizeof(msg));
+		msg.time_usec = p->time_usec;
+		msg.time_week = week;
+		msg.time_week_ms = week_ms;
+		msg.lat = rc_geo_e7(lla[0]);
+		msg.lon = rc_geo_e7(lla[1]);
+		msg.alt = (float)lla[2];
+		msg.vn = vel[0];
+		msg.ve = vel[1];
+		msg.vd = vel[2];
+		msg.horiz_accuracy = sqrtf(cov_pos[0] + cov_pos[3]);
+		msg.vert_accuracy = sqrtf(cov_pos[5]);
+		msg.speed_accuracy = sqrtf(cov_vel[0] + cov_vel[3] + cov_vel[5]);
+		msg.ignore_flags = GPS_INPUT_IGNORE_FLAG_HDOP | GPS_INPUT_IGNORE_FLAG_VDOP;
+		msg.fix_type = GPS_FIX_TYPE_RTK_FIXED;
+		msg.satellites_visible = RC_POSE_GPS_SATELLITES;
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+template<> struct rc_pose_encoder<RC_ROUTE_FORMAT_HIL_GPS>{
+	static int pack(rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid, uint8_t seq,
+			const rc_pose_t* p)
+	{
+		mavlink_hil_gps_t msg;
+		float pos[3], vel[3], cov_pos[6], speed, cog;
+		double lla[3];
+
+		rc_pose_ned(p, pos, vel, cov_pos, NULL);
+		rc_pose_lla(p, pos, lla);
+		speed = sqrtf(vel[0] * vel[0] + vel[1] * vel[1]);
+		cog = atan2f(vel[1], vel[0]) * RC_POSE_CDEG_PER_RAD;
+		msg.time_usec = p->time_usec;
+		msg.lat = rc_geo_e7(lla[0]);
+		msg.lon = rc_geo_e7(lla[1]);
+		msg.alt = (int32_t)llround(lla[2] * 1000.0);
+		// centimeters, the deviations standing in for the dilutions
+		msg.eph = (uint16_t)fminf(sqrtf(cov_pos[0] + cov_pos[3]) * 100.0f, (float)UINT16_MAX - 1.0f);
+		msg.epv = (uint16_t)fminf(sqrtf(cov_pos[5]) * 100.0f, (float)UINT16_MAX - 1.0f);
+		msg.vel = (uint16_t)fminf(speed * 100.0f, (float)UINT16_MAX - 1.0f);
+		msg.vn = (int16_t)fmaxf(fminf(vel[0] * 100.0f, (float)INT16_MAX), (float)-INT16_MAX);
+		msg.ve = (int16_t)fmaxf(fminf(vel[1] * 100.0f, (float)INT16_MAX), (float)-INT16_MAX);
+		msg.vd = (int16_t)fmaxf(fminf(vel[2] * 100.0f, (float)INT16_MAX), (float)-INT16_MAX);
+		msg.cog = (uint16_t)(cog < 0.0f ? cog + 36000.0f : cog) % 36000;
+		msg.fix_type = GPS_FIX_TYPE_RTK_FIXED;
+		msg.satellites_visible = RC_POSE_GPS_SATELLITES;
+		return rc_mav_pack(pkt, addr, port, sysid, seq, msg);
+	}
+};
+
+
+/**
+ * @brief      Packs a pose in one destination's format.
+ *
+ * @param[in]  format  RC_ROUTE_FORMAT_* of the destination
+ *
+ *             The other arguments are those of rc_mav_pack_msg.
+ *
+ * @return     0 on success, -1 on failure
+ */
+inline int rc_pose_pack(int format, rc_mav_packet_t* pkt, uint32_t addr, uint16_t port, uint8_t sysid,
+			uint8_t seq, const rc_pose_t* p)
+{
+	switch(format){
+	case RC_ROUTE_FORMAT_ATT_POS_MOCAP:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_ATT_POS_MOCAP>::pack(pkt, addr, port, sysid, seq, p);
+	case RC_ROUTE_FORMAT_VISION_POSITION_ESTIMATE:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_VISION_POSITION_ESTIMATE>::pack(pkt, addr, port, sysid, seq, p);
+	case RC_ROUTE_FORMAT_VICON_POSITION_ESTIMATE:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_VICON_POSITION_ESTIMATE>::pack(pkt, addr, port, sysid, seq, p);
+	case RC_ROUTE_FORMAT_LOCAL_POSITION_NED:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_LOCAL_POSITION_NED>::pack(pkt, addr, port, sysid, seq, p);
+	case RC_ROUTE_FORMAT_LOCAL_POSITION_NED_COV:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_LOCAL_POSITION_NED_COV>::pack(pkt, addr, port, sysid, seq, p);
+	case RC_ROUTE_FORMAT_GPS_INPUT:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_GPS_INPUT>::pack(pkt, addr, port, sysid, seq, p);
+	case RC_ROUTE_FORMAT_HIL_GPS:
+		return rc_pose_encoder<RC_ROUTE_FORMAT_HIL_GPS>::pack(pkt, addr, port, sysid, seq, p);
+	}
+	return -1;
+}
+
+
+#endif /* RC_POSE_ENCODERS_H */
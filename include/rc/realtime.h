@@ -0,0 +1,121 @@
+/**
+ * @file realtime.h
+ *
+ * @brief      Deterministic real-time mode for the bridge's threads.
+ *
+ *             Tail latency in the frame loop comes from page faults, the
+ *             scheduler moving threads between cores and the heap growing.
+ *             rc_rt_start locks every current and future page of the process
+ *             in memory, stops malloc from giving memory back to the system
+ *             or serving large blocks from fresh mappings, and touches a
+ *             block of heap and the calling thread's stack so they are
+ *             resident before the first frame. After that each thread that
+ *             is on the path from frame to wire calls rc_rt_enter with its
+ *             role when it starts, which pins it to the role's core, gives it
+ *             the role's SCHED_FIFO priority and prefaults its stack.
+ *
+ *             Per-subject buffers are preallocated separately by the modules
+ *             that own them (see rc_bridge_reserve in bridge_pipeline.h and
+ *             MocapSource::reserve in mocap_source.h).
+ *
+ *             SCHED_FIFO and mlockall need root, CAP_SYS_NICE and
+ *             CAP_IPC_LOCK, or a big enough rtprio and memlock in
+ *             /etc/security/limits.conf. Whatever is refused is reported and
+ *             the bridge carries on without it. On Windows threads are pinned
+ *             with SetThreadAffinityMask and a priority above 0 becomes
+ *             THREAD_PRIORITY_TIME_CRITICAL, memory is only prefaulted.
+ *
+ *             Until rc_rt_start is called rc_rt_enter does nothing, so the
+ *             threads can call it unconditionally.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_REALTIME_H
+#define RC_REALTIME_H
+
+#include <stddef.h>
+
+#define RC_RT_ANY_CORE			-1
+#define RC_RT_DEFAULT_PRIORITY_ACQUISITION	80
+#define RC_RT_DEFAULT_PRIORITY_SEND	70	// workers join the frame at the same priority
+#define RC_RT_DEFAULT_PRIORITY_RECEIVE	60
+#define RC_RT_DEFAULT_STACK_BYTES	(256 * 1024)	// prefaulted per thread
+#define RC_RT_DEFAULT_HEAP_BYTES	(32 * 1024 * 1024)	// prefaulted once
+
+/**
+ * The threads on the path from frame to wire
+ */
+typedef enum rc_rt_role_t{
+	RC_RT_ACQUISITION,	///< waits for mocap frames, see rc_mocap_threaded_source_create
+	RC_RT_SEND,		///< runs the frame loop and sends the packets
+	RC_RT_RECEIVE,		///< receives telemetry, see rc_mav_receive_start
+	RC_RT_WORKER,		///< worker pool threads packing subjects
+	RC_RT_NUM_ROLES
+} rc_rt_role_t;
+
+typedef struct rc_rt_config_t{
+	int core[RC_RT_NUM_ROLES];	///< core each role is pinned to, or RC_RT_ANY_CORE
+	int priority[RC_RT_NUM_ROLES];	///< SCHED_FIFO priority 1-99, 0 for the normal scheduler
+	int lock_memory;		///< 1 to mlockall
+	size_t stack_bytes;		///< stack each thread prefaults
+	size_t heap_bytes;		///< heap prefaulted and kept by malloc
+} rc_rt_config_t;
+
+
+/**
+ * @brief      Fills a config with the default priorities, no pinning, and
+ *             memory locked.
+ *
+ * @param[out] cfg   The config
+ */
+void rc_rt_default_config(rc_rt_config_t* cfg);
+
+/**
+ * @brief      Sets the cores of the acquisition, send and receive threads from
+ *             a list like "1,2,3". Cores left out of the list, or given as -1,
+ *             aren't pinned. Workers stay unpinned.
+ *
+ * @param[in]  list  Comma separated cores in role order
+ * @param      cfg   The config to change
+ *
+ * @return     0 on success, -1 if the list doesn't parse
+ */
+int rc_rt_parse_cores(const char* list, rc_rt_config_t* cfg);
+
+/**
+ * @brief      Enters real-time mode for the process.
+ *
+ *             Locks and prefaults memory as configured. Call it before
+ *             starting any thread that calls rc_rt_enter, the calling thread
+ *             still has to call rc_rt_enter for its own role.
+ *
+ * @param[in]  cfg   The config, copied
+ *
+ * @return     0 on success, -1 if some of it was refused
+ */
+int rc_rt_start(const rc_rt_config_t* cfg);
+
+/**
+ * @brief      Indicates if rc_rt_start has been called.
+ */
+int rc_rt_is_enabled();
+
+/**
+ * @brief      Pins the calling thread, sets its priority and prefaults its
+ *             stack for its role. Does nothing before rc_rt_start.
+ *
+ * @param[in]  role  What the thread does
+ *
+ * @return     0 on success or when not enabled, -1 if some of it was refused
+ */
+int rc_rt_enter(rc_rt_role_t role);
+
+/**
+ * @brief      Unlocks memory and leaves real-time mode. Threads keep the
+ *             priority and core they were given.
+ */
+void rc_rt_stop();
+
+
+#endif /* RC_REALTIME_H */
@@ -0,0 +1,82 @@
+/**
+ * @file relative_pose.h
+ *
+ * @brief      Pose of a target subject, such as a landing pad or a person to
+ *             follow, as seen from a vehicle, for LANDING_TARGET and
+ *             FOLLOW_TARGET without cameras on the vehicles.
+ *
+ *             The (vehicle, target) pairs of a frame are added one by one and
+ *             then computed in one pass over arrays of each coordinate: the
+ *             vector to the target rotated into the vehicle's body frame,
+ *             forward-right-down, its length, and the two angles a downward
+ *             camera would measure with the top of its image towards the
+ *             front of the vehicle, angle_x to the right and angle_y towards
+ *             the back. A target above the vehicle has angles beyond 90
+ *             degrees. The target's velocity is carried along so the workers
+ *             packing the results don't read it while it is being updated.
+ *
+ *             Positions are in millimeters and quaternions x y z w in the SDK
+ *             frame, as the subject records hold them.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_RELATIVE_POSE_H
+#define RC_RELATIVE_POSE_H
+
+#include <stdint.h>	// for specific integer types
+
+/**
+ * Where the target is, from the vehicle
+ */
+typedef struct rc_relpose_t{
+	float body[3];			///< meters forward, right and down
+	float distance;			///< meters
+	float angle_x;			///< radians right of the image center
+	float angle_y;			///< radians back from the image center
+	float target_vel[3];		///< velocity of the target as given, mm/s
+} rc_relpose_t;
+
+
+/**
+ * @brief      Forgets the pairs of the last frame.
+ */
+void rc_relpose_clear();
+
+/**
+ * @brief      Adds a pair to the next rc_relpose_compute.
+ *
+ * @param[in]  vehicle_pos  Vehicle position, millimeters
+ * @param[in]  vehicle_q    Vehicle attitude, x y z w
+ * @param[in]  target_pos   Target position, millimeters
+ * @param[in]  target_vel   Target velocity, millimeters per second
+ *
+ * @return     index of the pair
+ */
+int rc_relpose_add(const double vehicle_pos[3], const double vehicle_q[4], const double target_pos[3],
+			const float target_vel[3]);
+
+/**
+ * @brief      Computes every pair added since rc_relpose_clear.
+ */
+void rc_relpose_compute();
+
+/**
+ * @brief      Result of a pair, valid until the next rc_relpose_clear.
+ *             Only reads, may be called from every worker at once.
+ */
+const rc_relpose_t* rc_relpose_get(int pair);
+
+/**
+ * @brief      Allocates room for n pairs now, so adding that many never
+ *             allocates.
+ */
+void rc_relpose_reserve(int n);
+
+/**
+ * @brief      Frees the pairs.
+ */
+void rc_relpose_cleanup();
+
+
+#endif /* RC_RELATIVE_POSE_H */
@@ -0,0 +1,271 @@
+/**
+ * @file routing.h
+ *
+ * @brief      Routing table saying where and how each subject's poses are
+ *             sent, loaded from a text file and reloaded when it changes.
+ *
+ *             Each non-empty line that does not start with '#' routes one
+ *             subject:
+ *
+ *             <subject> <ip[:port][/format]>[,...] [key=value ...]
+ *
+ *             format         message the pose is sent as to that destination,
+ *                            att_pos_mocap (default), vision_position_estimate,
+ *                            vicon_position_estimate, local_position_ned,
+ *                            local_position_ned_cov, gps_input or hil_gps,
+ *                            see pose_encoders.h. Vehicles getting gps_input
+ *                            or hil_gps are first sent the origin as
+ *                            SET_GPS_GLOBAL_ORIGIN
+ *             sysid=N        system id of the packets (default: the bridge's)
+ *             msgs=a,b       messages to send, att_pos_mocap (default, the
+ *                            pose in each destination's format),
+ *                            vision_speed_estimate, neighbors, collision,
+ *                            obstacle_distance, landing_target and
+ *                            follow_target
+ *             rate=Hz        send poses at most this often (default every
+ *                            frame)
+ *             filter=mean|drop  with rate, mean sends the average pose of the
+ *                            frames since the last one sent (default), drop
+ *                            sends the latest frame and skips the others
+ *             speed_rate=Hz  rate of vision_speed_estimate (default 30)
+ *             scan_rate=Hz   rate of obstacle_distance (default 10)
+ *             neighbors=K    with msgs=neighbors, how many of the nearest
+ *                            other subjects are sent with each pose (default
+ *                            4), see bridge_pipeline.h
+ *             target=name    subject whose pose landing_target and
+ *                            follow_target send, see relative_pose.h
+ *             frame=raw|ned  raw sends the SDK millimeters and quaternion as
+ *                            they are (default), ned converts to meters in a
+ *                            north-east-down frame with a w-first quaternion
+ *             yaw=deg        with frame=ned, heading of the Vicon x axis in
+ *                            degrees east of north
+ *             offset=x,y,z   with frame=ned, added to the position in meters
+ *
+ *             For example "cf12 192.168.5.12,127.0.0.1:14560 sysid=12 rate=100
+ *             frame=ned yaw=90". Subjects not in the file keep being routed
+ *             by their name@IPaddress name.
+ *
+ *             Lines of the form "obstacle <x>,<y> <radius>" instead give a
+ *             fixed obstacle for obstacle_distance, a vertical cylinder with
+ *             its center and radius in meters in the SDK frame, so no subject
+ *             can be called obstacle. A line "origin <lat>,<lon> <alt>" gives
+ *             the geodetic position in degrees and meters above sea level of
+ *             the NED origin, for follow_target, gps_input and hil_gps (see
+ *             geodetic.h). Without one it is 0,0 at 0m.
+ *
+ *             The file compiles into an immutable table of flat arrays: the
+ *             routes, every destination of every route back to back, and an
+ *             open addressing hash of the subject names. A watcher thread
+ *             polls the file and swaps a freshly compiled table in with one
+ *             atomic store. The frame loop holds a table for exactly one frame
+ *             between rc_route_acquire and rc_route_release, so the old table
+ *             is freed once a frame has ended after the swap and the stream
+ *             never waits for a reload. A file with errors is reported and the
+ *             previous table kept.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_ROUTING_H
+#define RC_ROUTING_H
+
+#include <stdint.h>	// for specific integer types
+#include "../rc/mocap_source.h"
+#include "../rc/obstacle_scan.h"
+
+#define RC_ROUTE_MAX_DESTS	8	// destinations per subject
+#define RC_ROUTE_POLL_MS	500	// how often the file is checked for changes
+#define RC_ROUTE_DEFAULT_SPEED_HZ	30.0
+#define RC_ROUTE_DEFAULT_SCAN_HZ	10.0
+#define RC_ROUTE_DEFAULT_NEIGHBORS	4
+#define RC_ROUTE_MAX_NEIGHBORS		16
+
+// messages a route can send, combined in rc_route_t::messages
+#define RC_ROUTE_MSG_ATT_POS_MOCAP		(1u << 0)
+#define RC_ROUTE_MSG_VISION_SPEED_ESTIMATE	(1u << 1)
+#define RC_ROUTE_MSG_NEIGHBORS			(1u << 2)
+#define RC_ROUTE_MSG_COLLISION			(1u << 3)
+#define RC_ROUTE_MSG_OBSTACLE_DISTANCE		(1u << 4)
+#define RC_ROUTE_MSG_LANDING_TARGET		(1u << 5)
+#define RC_ROUTE_MSG_FOLLOW_TARGET		(1u << 6)
+
+// message a destination gets the pose as, rc_route_dest_t::format
+#define RC_ROUTE_FORMAT_ATT_POS_MOCAP			0
+#define RC_ROUTE_FORMAT_VISION_POSITION_ESTIMATE	1
+#define RC_ROUTE_FORMAT_VICON_POSITION_ESTIMATE		2
+#define RC_ROUTE_FORMAT_LOCAL_POSITION_NED		3
+#define RC_ROUTE_FORMAT_LOCAL_POSITION_NED_COV		4
+#define RC_ROUTE_FORMAT_GPS_INPUT			5
+#define RC_ROUTE_FORMAT_HIL_GPS				6
+// the formats sending geodetic positions, as bits of rc_route_t::formats
+#define RC_ROUTE_FORMATS_GEODETIC	((1u << RC_ROUTE_FORMAT_GPS_INPUT) | (1u << RC_ROUTE_FORMAT_HIL_GPS))
+
+// how frames between two sends at a lower rate are used
+#define RC_ROUTE_FILTER_MEAN	0
+#define RC_ROUTE_FILTER_DROP	1
+
+/**
+ * One destination of a route
+ */
+typedef struct rc_route_dest_t{
+	uint32_t addr;			///< IPv4 address, network byte order
+	uint16_t port;			///< 0 for the bridge's port
+	uint8_t format;			///< RC_ROUTE_FORMAT_*
+} rc_route_dest_t;
+
+/**
+ * How a subject's pose is converted before it is sent
+ */
+typedef struct rc_route_transform_t{
+	int ned;			///< 0 to send the SDK values as they are
+	float m[9];			///< rotation and millimeters to meters, row major
+	float offset[3];		///< meters added after m
+	float q[4];			///< world rotation applied to the attitude, w x y z
+} rc_route_transform_t;
+
+/**
+ * Everything needed to send one subject, sized to stay within two cache lines
+ */
+typedef struct rc_route_t{
+	uint32_t messages;		///< RC_ROUTE_MSG_* flags
+	uint32_t period_usec;		///< minimum time between poses, 0 for every frame
+	uint32_t speed_period_usec;	///< period of vision_speed_estimate
+	uint32_t scan_period_usec;	///< period of obstacle_distance
+	uint16_t first_dest;		///< index of the first destination in the table
+	uint8_t num_dests;		///< 1 to RC_ROUTE_MAX_DESTS
+	uint8_t sysid;			///< 0 for the bridge's system id
+	uint8_t filter;			///< RC_ROUTE_FILTER_*
+	uint8_t neighbors;		///< nearest subjects sent with msgs=neighbors
+	uint8_t formats;		///< 1 << RC_ROUTE_FORMAT_* of every destination
+	int16_t target;			///< for rc_route_target, -1 for none
+	rc_route_transform_t transform;
+} rc_route_t;
+
+typedef struct rc_route_table_t rc_route_table_t;
+
+
+/**
+ * @brief      Loads the routing file and starts watching it for changes.
+ *
+ *             A missing file is not an error, every subject is then routed by
+ *             its name until the file appears.
+ *
+ * @param[in]  path  Path of the routing file
+ *
+ * @return     number of routes loaded, -1 if the file has errors
+ */
+int rc_route_start(const char* path);
+
+/**
+ * @brief      Stops watching the file and frees every table.
+ */
+void rc_route_stop();
+
+/**
+ * @brief      Returns the current table for the frame about to be processed.
+ *
+ *             Must be paired with rc_route_release once the frame is done,
+ *             and only be called from the frame loop.
+ *
+ * @return     the table, NULL if routing was not started
+ */
+const rc_route_table_t* rc_route_acquire();
+
+/**
+ * @brief      Marks the end of the frame started with rc_route_acquire.
+ */
+void rc_route_release();
+
+/**
+ * @brief      Finds the route of a subject.
+ *
+ * @param[in]  table  Table from rc_route_acquire, may be NULL
+ * @param[in]  name   Subject name
+ *
+ * @return     the route, NULL if the subject has none
+ */
+const rc_route_t* rc_route_find(const rc_route_table_t* table, const char* name);
+
+/**
+ * @brief      Returns the destinations of a route, num_dests of them.
+ */
+const rc_route_dest_t* rc_route_dests(const rc_route_table_t* table, const rc_route_t* route);
+
+/**
+ * @brief      Returns the name of a route's target subject, NULL if it has
+ *             none.
+ */
+const char* rc_route_target(const rc_route_table_t* table, const rc_route_t* route);
+
+/**
+ * @brief      Every RC_ROUTE_MSG_* flag used by at least one route.
+ *
+ * @param[in]  table  Table from rc_route_acquire, may be NULL
+ */
+uint32_t rc_route_messages(const rc_route_table_t* table);
+
+/**
+ * @brief      Every rc_route_t::formats bit used by at least one route.
+ *
+ * @param[in]  table  Table from rc_route_acquire, may be NULL
+ */
+uint32_t rc_route_formats(const rc_route_table_t* table);
+
+/**
+ * @brief      Returns the fixed obstacles of the table.
+ *
+ * @param[in]  table  Table from rc_route_acquire, may be NULL
+ * @param[out] count  Number of obstacles
+ */
+const rc_scan_obstacle_t* rc_route_obstacles(const rc_route_table_t* table, int* count);
+
+/**
+ * @brief      Returns the geodetic position of the NED origin.
+ *
+ * @param[in]  table    Table from rc_route_acquire, may be NULL
+ * @param[out] lat_deg  Latitude, degrees
+ * @param[out] lon_deg  Longitude, degrees
+ * @param[out] alt_m    Altitude above mean sea level, meters
+ */
+void rc_route_origin(const rc_route_table_t* table, double* lat_deg, double* lon_deg, double* alt_m);
+
+/**
+ * @brief      Number of tables loaded so far, including the first.
+ */
+uint64_t rc_route_generation();
+
+/**
+ * @brief      Converts a pose as a route asks.
+ *
+ * @param[in]  t     The transform
+ * @param[in]  xyz   Translation from the subject record
+ * @param[in]  q_in  Quaternion from the subject record
+ * @param[out] pos   Position to send
+ * @param[out] q     Quaternion to send
+ */
+void rc_route_transform(const rc_route_transform_t* t, const double xyz[3],
+			const double q_in[4], float pos[3], float q[4]);
+
+/**
+ * @brief      Converts a position or a velocity as a route asks.
+ *
+ * @param[in]  t          The transform
+ * @param[in]  in         Vector in the SDK frame and units
+ * @param[in]  translate  1 for a position, 0 for a velocity which is only
+ *                        rotated and scaled
+ * @param[out] out        Converted vector
+ */
+void rc_route_transform_vector(const rc_route_transform_t* t, const float in[3], int translate, float out[3]);
+
+/**
+ * @brief      Converts per-axis variances in the SDK frame as a route asks.
+ *
+ * @param[in]  t    The transform
+ * @param[in]  var  Variance along x, y and z in SDK units squared
+ * @param[out] cov  Covariance in the route's frame and units, upper triangle
+ *                  xx xy xz yy yz zz
+ */
+void rc_route_transform_covariance(const rc_route_transform_t* t, const float var[3], float cov[6]);
+
+
+#endif /* RC_ROUTING_H */
@@ -0,0 +1,73 @@
+/**
+ * @file spatial_grid.h
+ *
+ * @brief      Uniform spatial hash grid over the subject positions of one
+ *             frame, for finding each vehicle's nearest neighbors.
+ *
+ *             Space is cut into cubes of one size and each cube hashed
+ *             into a table about twice the number of points. rc_grid_build
+ *             counting-sorts the points by table entry, so a rebuild is O(N)
+ *             with no allocation once the arrays have grown, and the points of
+ *             a cube sit next to each other. rc_grid_nearest searches shells
+ *             of cubes outwards from the query point and stops as soon as the
+ *             K found are closer than anything further out can be, so with
+ *             vehicles spread over the room a query touches a few dozen points
+ *             whatever the total. Left to rc_grid_build, the cube size follows
+ *             the density of the frame so that holds for a tight formation as
+ *             well as for vehicles spread over the room.
+ *
+ *             Queries only read the grid and may run on every worker at once.
+ *             Building must not overlap them.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_SPATIAL_GRID_H
+#define RC_SPATIAL_GRID_H
+
+#define RC_GRID_AUTO_CELL	0.0f	// size the cubes from the points
+#define RC_GRID_DEFAULT_CELL	2000.0f	// cube size for fewer than two points
+#define RC_GRID_POINTS_PER_CELL	8.0f	// average aimed for by RC_GRID_AUTO_CELL
+#define RC_GRID_MAX_SHELLS	4	// neighbors beyond this many cubes are ignored
+
+
+/**
+ * @brief      Rebuilds the grid over n points.
+ *
+ * @param[in]  x     x of every point
+ * @param[in]  y     y of every point
+ * @param[in]  z     z of every point
+ * @param[in]  n     Number of points, which are then known by their index
+ * @param[in]  cell  Cube size in the units of the points, or
+ *                   RC_GRID_AUTO_CELL
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_grid_build(const float* x, const float* y, const float* z, int n, float cell);
+
+/**
+ * @brief      Finds the points nearest to a position.
+ *
+ * @param[in]  p     The position
+ * @param[in]  self  Point to leave out, -1 for none
+ * @param[in]  k     Number of points wanted
+ * @param[out] out   Indices of the points found, nearest first, room for k
+ *
+ * @return     number of points found, less than k if there are fewer within
+ *             RC_GRID_MAX_SHELLS cubes
+ */
+int rc_grid_nearest(const float p[3], int self, int k, int* out);
+
+/**
+ * @brief      Allocates the grid for up to n points now, so building it for
+ *             that many never allocates.
+ */
+void rc_grid_reserve(int n);
+
+/**
+ * @brief      Frees the grid.
+ */
+void rc_grid_cleanup();
+
+
+#endif /* RC_SPATIAL_GRID_H */
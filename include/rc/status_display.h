@@ -0,0 +1,100 @@
+/**
+ * @file status_display.h
+ *
+ * @brief      Asynchronous, rate-limited status table for the bridge.
+ *
+ *             The frame loop publishes pose and counters for each subject into
+ *             a shared slot with no formatting or console I/O. A separate
+ *             display thread wakes at a fixed rate, takes a consistent
+ *             snapshot of every slot and renders one table row per subject
+ *             with output rate, latency, occlusion and dropped packets.
+ *
+ *             Each slot is guarded by a seqlock with a single writer, the
+ *             thread processing that subject, and any number of readers.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_STATUS_DISPLAY_H
+#define RC_STATUS_DISPLAY_H
+
+#include <stdint.h>	// for specific integer types
+
+#define RC_DISPLAY_MAX_SUBJECTS	1024
+#define RC_DISPLAY_DEFAULT_HZ	10.0
+#define RC_DISPLAY_NAME_LEN	64
+#define RC_DISPLAY_MAX_SERVERS	8
+
+
+/**
+ * @brief      Starts the display thread.
+ *
+ * @param[in]  hz    Refresh rate of the table, for example
+ *                   RC_DISPLAY_DEFAULT_HZ
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_display_start(double hz);
+
+/**
+ * @brief      Stops the display thread.
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_display_stop();
+
+/**
+ * @brief      Publishes frame-level information shown above the table.
+ *
+ * @param[in]  frame_number   The Vicon frame number
+ * @param[in]  subject_count  Number of subjects in the frame
+ */
+void rc_display_publish_frame(uint32_t frame_number, unsigned int subject_count);
+
+/**
+ * @brief      Publishes the state of one mocap server when several are merged.
+ *
+ *             Servers are shown above the table once published.
+ *
+ * @param[in]  server        The server index, 0 to RC_DISPLAY_MAX_SERVERS-1
+ * @param[in]  name          Host or file the server frames come from
+ * @param[in]  frame_number  Latest frame number from this server
+ * @param[in]  lag_s         How far this server's latest frame trails the
+ *                           newest frame of any server, in seconds
+ * @param[in]  latency_s     Latency reported by the server's SDK in seconds
+ */
+void rc_display_publish_server(int server, const char* name, uint64_t frame_number,
+			double lag_s, double latency_s);
+
+/**
+ * @brief      Sets a one-line status message shown above the table.
+ *
+ *             Only the pointer is stored so msg must be a string literal or
+ *             otherwise outlive the display. Pass NULL to clear it.
+ *
+ * @param[in]  msg   The message
+ */
+void rc_display_set_status(const char* msg);
+
+/**
+ * @brief      Publishes the latest pose of a subject that was just sent.
+ *
+ * @param[in]  subject     The subject index, 0 to RC_DISPLAY_MAX_SUBJECTS-1
+ * @param[in]  name        The subject name
+ * @param[in]  q           Attitude quaternion, w, x, y, z order
+ * @param[in]  xyz         Position in millimeters
+ * @param[in]  occluded    1 if the subject was occluded in this frame
+ * @param[in]  latency_s   Capture to send latency in seconds
+ */
+void rc_display_publish_pose(int subject, const char* name, const float q[4],
+			const double xyz[3], int occluded, double latency_s);
+
+/**
+ * @brief      Counts a packet for a subject that failed to send.
+ *
+ * @param[in]  subject  The subject index
+ */
+void rc_display_count_drop(int subject);
+
+
+#endif /* RC_STATUS_DISPLAY_H */
@@ -0,0 +1,108 @@
+/**
+ * @file timer_wheel.h
+ *
+ * @brief      Hierarchical timer wheel for periodic work driven from the frame
+ *             loop, such as heartbeats and lower rate messages.
+ *
+ *             Time advances in ticks of RC_TIMER_TICK_USEC. Level 0 has one
+ *             slot per tick for the next RC_TIMER_SLOTS ticks, and each level
+ *             above has slots RC_TIMER_SLOTS times longer, so four levels of 64
+ *             slots cover about 4.6 hours at 1ms. A timer sits in the list of
+ *             the slot it expires in and drops to a lower level when the wheel
+ *             reaches that slot. Adding, cancelling and every tick are O(1)
+ *             however many timers there are, and stretches with no timers are
+ *             skipped. Timers live in one pool and their lists are linked by
+ *             index, so nothing is allocated once the pool has grown.
+ *
+ *             Callbacks run on the thread calling rc_timer_advance and may add
+ *             or cancel timers, including their own. The wheel is not thread
+ *             safe, use it from one thread.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_TIMER_WHEEL_H
+#define RC_TIMER_WHEEL_H
+
+#include <stdint.h>	// for specific integer types
+
+#define RC_TIMER_TICK_USEC	1000
+#define RC_TIMER_LEVELS		4
+#define RC_TIMER_SLOT_BITS	6
+#define RC_TIMER_SLOTS		(1 << RC_TIMER_SLOT_BITS)
+
+/**
+ * Handle of a timer, 0 is never a valid timer
+ */
+typedef uint64_t rc_timer_id_t;
+
+/**
+ * Timer callback. A periodic timer keeps running while it returns 0 and is
+ * removed when it returns anything else. The return value of one-shot timers
+ * is ignored.
+ */
+typedef int (*rc_timer_func_t)(rc_timer_id_t id, void* ctx, uint64_t now_usec);
+
+
+/**
+ * @brief      Starts an empty wheel.
+ *
+ * @param[in]  now_usec  Current time, the same clock as rc_timer_advance
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_timer_init(uint64_t now_usec);
+
+/**
+ * @brief      Adds a timer.
+ *
+ * @param[in]  first_usec   When it first fires, times already past fire on the
+ *                          next tick
+ * @param[in]  period_usec  Period after that, 0 for a one-shot timer
+ * @param[in]  func         The callback
+ * @param      ctx          Passed to func
+ *
+ * @return     the timer, 0 on failure
+ */
+rc_timer_id_t rc_timer_add(uint64_t first_usec, uint32_t period_usec, rc_timer_func_t func, void* ctx);
+
+/**
+ * @brief      Removes a timer.
+ *
+ * @param[in]  id    The timer
+ *
+ * @return     0 on success, -1 if the timer has already finished
+ */
+int rc_timer_cancel(rc_timer_id_t id);
+
+/**
+ * @brief      Fires every timer due up to now_usec.
+ *
+ *             A periodic timer that fell more than a period behind, for
+ *             example while the loop was blocked, fires once and then keeps
+ *             its period from now rather than firing repeatedly to catch up.
+ *
+ * @param[in]  now_usec  Current time
+ *
+ * @return     number of callbacks run
+ */
+int rc_timer_advance(uint64_t now_usec);
+
+/**
+ * @brief      Number of timers waiting to fire.
+ */
+int rc_timer_count();
+
+/**
+ * @brief      Grows the pool to hold n timers now, so adding that many
+ *             never allocates.
+ */
+void rc_timer_reserve(int n);
+
+/**
+ * @brief      Removes every timer and frees the pool.
+ */
+void rc_timer_cleanup();
+
+
+#endif /* RC_TIMER_WHEEL_H */
@@ -0,0 +1,164 @@
+/**
+ * @file tlog_replay.h
+ *
+ * @brief      Indexed, memory-mapped access to tlog files and paced replay of
+ *             their packets through the rc_mav send path.
+ *
+ *             rc_tlog_open maps the whole file read-only and makes a single
+ *             pass over it to build an index of every packet with its
+ *             timestamp, sysid and msgid. Entries are sorted by time, and a
+ *             secondary index lists the entries of each sysid, so seeking to
+ *             a time or iterating one vehicle's packets never touches the
+ *             rest of the file. Packet bytes are returned as pointers into the
+ *             mapping, nothing is copied.
+ *
+ *             rc_tlog_replay re-emits a range of the log with
+ *             rc_mav_send_buffer at real time, at a multiple of real time, or
+ *             as fast as possible. Pacing sleeps until shortly before each
+ *             packet is due and spins the remainder, so packets leave within
+ *             a few microseconds of their scheduled time.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_TLOG_REPLAY_H
+#define RC_TLOG_REPLAY_H
+
+#include <stdint.h>	// for specific integer types
+#include <stddef.h>
+
+#define RC_TLOG_SPEED_AFAP	0.0	// replay as fast as possible
+#define RC_TLOG_ANY_SYSID	-1
+
+/**
+ * One packet in a tlog
+ */
+typedef struct rc_tlog_entry_t{
+	uint64_t time_usec;	///< recorded timestamp, usec since the unix epoch
+	uint64_t offset;	///< offset of the packet bytes in the file
+	uint32_t msgid;		///< MAVLink message id
+	uint16_t len;		///< packet length in bytes
+	uint8_t sysid;		///< sender system id
+	uint8_t compid;		///< sender component id
+} rc_tlog_entry_t;
+
+/**
+ * Opaque handle to an open, indexed tlog
+ */
+typedef struct rc_tlog_t rc_tlog_t;
+
+/**
+ * Replay configuration, see rc_tlog_replay
+ */
+typedef struct rc_tlog_replay_config_t{
+	double speed;		///< 1.0 for real time, N for N times, RC_TLOG_SPEED_AFAP
+	int sysid;		///< only replay this sysid, or RC_TLOG_ANY_SYSID
+	uint64_t start_usec;	///< skip packets before this log time, 0 for start
+	uint64_t end_usec;	///< stop at this log time, 0 for end
+	/**
+	 * Called before each packet is sent, for example to select its
+	 * destination with rc_mav_set_dest_ip. Return non-zero to skip it.
+	 */
+	int (*before_send)(const rc_tlog_entry_t* entry, void* ctx);
+	void* ctx;		///< passed to before_send
+	volatile int* running;	///< replay stops early when this becomes 0
+} rc_tlog_replay_config_t;
+
+/**
+ * Results of a replay
+ */
+typedef struct rc_tlog_replay_stats_t{
+	uint64_t sent;		///< packets sent
+	uint64_t failed;	///< packets that failed to send
+	double duration_s;	///< wall time of the replay
+	double late_mean_us;	///< mean lateness relative to schedule
+	double late_max_us;	///< worst lateness relative to schedule
+} rc_tlog_replay_stats_t;
+
+
+/**
+ * @brief      Maps and indexes a tlog file.
+ *
+ *             Bytes that don't parse as a MAVLink packet are skipped until the
+ *             next plausible record, so truncated or partially corrupt logs
+ *             still open.
+ *
+ * @param[in]  path  Path of the tlog
+ *
+ * @return     a handle on success, NULL on failure
+ */
+rc_tlog_t* rc_tlog_open(const char* path);
+
+/**
+ * @brief      Unmaps the file and frees the index.
+ *
+ * @param      log   The log handle
+ */
+void rc_tlog_close(rc_tlog_t* log);
+
+/**
+ * @brief      Returns the number of packets in the log.
+ *
+ * @param[in]  log   The log handle
+ *
+ * @return     number of packets
+ */
+size_t rc_tlog_count(const rc_tlog_t* log);
+
+/**
+ * @brief      Returns the i'th packet in time order.
+ *
+ * @param[in]  log   The log handle
+ * @param[in]  i     Index from 0 to rc_tlog_count-1
+ *
+ * @return     the entry, or NULL if i is out of range
+ */
+const rc_tlog_entry_t* rc_tlog_entry(const rc_tlog_t* log, size_t i);
+
+/**
+ * @brief      Returns the raw bytes of a packet.
+ *
+ * @param[in]  log    The log handle
+ * @param[in]  entry  An entry from this log
+ *
+ * @return     pointer into the mapped file, valid until rc_tlog_close
+ */
+const uint8_t* rc_tlog_packet(const rc_tlog_t* log, const rc_tlog_entry_t* entry);
+
+/**
+ * @brief      Finds the first packet at or after a log time.
+ *
+ * @param[in]  log        The log handle
+ * @param[in]  time_usec  The log time
+ *
+ * @return     index of the packet, rc_tlog_count if there is none
+ */
+size_t rc_tlog_seek_time(const rc_tlog_t* log, uint64_t time_usec);
+
+/**
+ * @brief      Returns the time-ordered entry indices of one sysid.
+ *
+ * @param[in]  log    The log handle
+ * @param[in]  sysid  The system id
+ * @param[out] count  Number of indices returned
+ *
+ * @return     array of indices for rc_tlog_entry, NULL if count is 0
+ */
+const uint32_t* rc_tlog_sysid_index(const rc_tlog_t* log, uint8_t sysid, size_t* count);
+
+/**
+ * @brief      Replays packets through rc_mav_send_buffer.
+ *
+ *             rc_mav_init must have been called first.
+ *
+ * @param[in]  log     The log handle
+ * @param[in]  config  The replay configuration
+ * @param[out] stats   Results of the replay, may be NULL
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_tlog_replay(const rc_tlog_t* log, const rc_tlog_replay_config_t* config,
+			rc_tlog_replay_stats_t* stats);
+
+
+#endif /* RC_TLOG_REPLAY_H */
@@ -0,0 +1,68 @@
+/**
+ * @file worker_pool.h
+ *
+ * @brief      Fixed pool of threads running a parallel for over an index range
+ *             with work stealing.
+ *
+ *             rc_pool_run splits [0, n) evenly between the workers, the
+ *             calling thread being worker 0. Each worker takes chunks from the
+ *             front of its own range, and once that is empty steals the back
+ *             half of another worker's remaining range, so subjects that cost
+ *             more than others (signing, extra messages) don't leave the rest
+ *             of the pool idle. A range is a single 64 bit word updated with
+ *             compare-and-swap, so taking and stealing need no locks.
+ *             rc_pool_run returns once every worker has finished, which makes
+ *             it a per-frame barrier.
+ *
+ * @date       10/18/2026
+ */
+
+#ifndef RC_WORKER_POOL_H
+#define RC_WORKER_POOL_H
+
+#define RC_POOL_MAX_WORKERS	64
+
+/**
+ * Work function, called with consecutive indices [begin, end) on the thread
+ * numbered worker
+ */
+typedef void (*rc_pool_func_t)(int begin, int end, int worker, void* ctx);
+
+
+/**
+ * @brief      Starts the pool threads.
+ *
+ * @param[in]  workers  Number of workers including the calling thread, 1 to
+ *                      RC_POOL_MAX_WORKERS. With 1 no threads are started and
+ *                      rc_pool_run simply calls func.
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_pool_init(int workers);
+
+/**
+ * @brief      Returns the number of workers including the calling thread.
+ */
+int rc_pool_num_workers();
+
+/**
+ * @brief      Runs func over [0, n) on all workers and waits for it to finish.
+ *
+ *             Must only be called from the thread that called rc_pool_init.
+ *
+ * @param[in]  n      Number of indices
+ * @param[in]  chunk  Indices taken at a time, at least 1
+ * @param[in]  func   The work function
+ * @param      ctx    Passed to func
+ *
+ * @return     0 on success, -1 on failure
+ */
+int rc_pool_run(int n, int chunk, rc_pool_func_t func, void* ctx);
+
+/**
+ * @brief      Stops and joins the pool threads.
+ */
+void rc_pool_cleanup();
+
+
+#endif /* RC_WORKER_POOL_H */
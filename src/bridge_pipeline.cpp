@@ -0,0 +1,1109 @@
+/**
+ * @file bridge_pipeline.cpp
+ *
+ * @brief      Per-frame processing of every subject from mocap frame to sent
+ *             packet. See bridge_pipeline.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/mavlink_traits.h"
+#include "../include/rc/latency_stats.h"
+#include "../include/rc/status_display.h"
+#include "../include/rc/worker_pool.h"
+#include "../include/rc/routing.h"
+#include "../include/rc/timer_wheel.h"
+#include "../include/rc/spatial_grid.h"
+#include "../include/rc/collision.h"
+#include "../include/rc/obstacle_scan.h"
+#include "../include/rc/relative_pose.h"
+#include "../include/rc/geodetic.h"
+#include "../include/rc/pose_encoders.h"
+#include "../include/rc/bridge_pipeline.h"
+
+#define MAX_SUBJECT_INDEX	65536	// rc_mocap_subject_t index is 16 bits
+#define HEARTBEAT_USEC		1000000	// 1Hz to every destination
+#define DEST_IDLE_USEC		5000000	// heartbeats stop after this long unused
+#define SPEED_STALE_USEC	500000	// speed stops after this long unseen
+#define SPEED_TAU_USEC		20000.0	// time constant of the velocity filter
+#define VAR_TAU_USEC		1000000.0	// time constant of the variances
+#define VAR_UNKNOWN		1.0e6f	// variance while there is no estimate, mm^2
+#define CONFLICTS_PER_VEHICLE	8	// room for this many conflicts on average
+#define RESERVE_PACKETS		4	// per subject and worker rc_bridge_reserve makes room for
+
+// what the workers need for one frame
+typedef struct bridge_frame_t{
+	const rc_mocap_subject_t* subjects;
+	const rc_route_table_t* routes;
+	uint64_t capture_usec;
+	uint8_t* prepared;		// 1 if packets were built for the subject
+	int grid;			// 1 if the neighbor grid was built for this frame
+	int collisions;			// 1 if conflicts were searched for this frame
+	int scans;			// 1 if the obstacle scans were built for this frame
+	int targets;			// 1 if the targets were found for this frame
+	int geodetic;			// 1 if the geodetic positions were converted
+	uint64_t generation;		// of the routing table, no newer than routes
+} bridge_frame_t;
+
+// running sums of the poses since the last send at a lower rate, padded to
+// 8 floats so the whole update is one or two vector operations
+typedef struct bridge_mean_t{
+	float pos[3];
+	float count;
+	float q[4];
+} bridge_mean_t;
+
+// a destination packets were sent to, kept alive with heartbeats
+typedef struct bridge_dest_t{
+	uint64_t key;			// address << 16 | port
+	uint64_t last_used_usec;
+	uint8_t seq;
+} bridge_dest_t;
+
+// a subject with a vision_speed_estimate timer
+typedef struct bridge_speed_t{
+	rc_timer_id_t timer;
+	char name[RC_MOCAP_NAME_LEN];
+} bridge_speed_t;
+
+static int chunk_size;
+// packets built by each worker, flushed together after the barrier
+static std::vector<rc_mav_packet_t> packets[RC_POOL_MAX_WORKERS];
+static std::vector<uint8_t> prepared;
+// per subject state, each written only by the worker that has that subject
+// in the current frame
+static std::vector<uint8_t> seq;
+static std::vector<uint64_t> next_due;
+static std::vector<uint64_t> scan_due;
+static std::vector<uint8_t> failed;
+static std::vector<bridge_mean_t> mean;
+static std::vector<uint64_t> mean_start_usec;
+// velocity estimate in the SDK frame, mm/s, for vision_speed_estimate and
+// neighbors, and the variances the pose formats with a covariance send
+static std::vector<float> pos_prev;	// 3 per subject
+static std::vector<float> vel;		// 3 per subject
+static std::vector<float> pos_var;	// 3 per subject, mm^2
+static std::vector<float> vel_var;	// 3 per subject, (mm/s)^2
+static std::vector<uint64_t> state_usec;
+static std::vector<uint8_t> speed_wanted;
+// written by the frame loop between frames only
+static std::vector<uint32_t> speed_period;	// of the subject's timer, 0 for none
+static std::vector<uint8_t> neighbor_seq;
+static std::vector<uint8_t> threat_prev;	// highest threat level last frame
+
+// subjects with a system id, snapshot for the neighbor grid and the
+// conflict search of one frame
+static std::vector<float> nb_pos[3];
+static std::vector<float> nb_vel[3];
+static std::vector<uint8_t> nb_sysid;
+static std::vector<int> nb_point;	// grid point of each frame subject, -1 if none
+static std::vector<rc_collision_t> conflicts;
+static std::vector<int> conflict_first;	// conflicts of point m are conflict_list
+static std::vector<int> conflict_list;	// [conflict_first[m], conflict_first[m+1])
+static rc_collision_config_t collision_cfg;
+
+// every unoccluded subject, snapshot for the obstacle scans of one frame
+static std::vector<float> sc_pos[3];
+static std::vector<int> sc_point;	// scan point of each frame subject, -1 if none
+static rc_scan_config_t scan_cfg;
+
+// landing and follow targets of one frame
+static std::vector<int> target_pair;	// relpose pair of each frame subject, -1 if none
+static std::vector<int> target_of;	// frame subject that is its target
+static std::vector<int> target_hint;	// per subject, where its target was last frame
+
+// geodetic positions of one frame for gps_input and hil_gps
+static std::vector<float> geo_ned[3];
+static std::vector<double> geo_lla[3];
+static std::vector<int> geo_point;	// position of each frame subject, -1 if none
+static std::vector<uint64_t> origin_gen;	// per subject, table generation it got the origin of
+
+// timers and everything they touch belong to the frame loop thread
+static std::vector<rc_mav_packet_t> periodic;
+static std::vector<rc_mav_packet_t> heartbeats;	// apart so they don't count as use
+static std::unordered_map<uint64_t, bridge_dest_t> dests;
+static std::unordered_map<int, bridge_speed_t> speeds;
+static const rc_route_table_t* timer_routes;
+static uint64_t last_capture_usec;
+static uint64_t last_frame_usec;
+
+
+// private local function declarations;
+static uint64_t __steady_usec();
+static int __due(uint64_t* next, uint32_t period_usec, uint64_t capture_usec);
+static void __accumulate(int idx, const rc_route_t* route, const float pos[3], const float q[4], uint64_t capture_usec);
+static void __take_mean(int idx, float pos[3], float q[4]);
+static void __update_velocity(int idx, const float pos[3], uint64_t capture_usec);
+static int __snapshot(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes);
+static int __find_conflicts(int m);
+static int __build_scans(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes);
+static int __find_subject(const rc_mocap_subject_t* subjects, int n, const char* name, int* hint);
+static void __find_targets(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes);
+static void __find_geodetic(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes);
+static int __max_threat(int point);
+static void __pack_collisions(std::vector<rc_mav_packet_t>& out, int point, int idx,
+			const rc_route_t* route, const rc_route_dest_t* dests);
+static void __pack_neighbors(std::vector<rc_mav_packet_t>& out, int i, int idx, const float p[3],
+			const rc_route_t* route, const rc_route_dest_t* dests);
+static void __pack_scan(std::vector<rc_mav_packet_t>& out, int i, int idx, const float p[3],
+			const double q[4], const rc_route_t* route, const rc_route_dest_t* dests);
+static void __pack_landing_target(std::vector<rc_mav_packet_t>& out, int i, int idx,
+			const rc_mocap_subject_t* target, const rc_route_t* route, const rc_route_dest_t* dests);
+static void __pack_follow_target(std::vector<rc_mav_packet_t>& out, int i, int idx,
+			const rc_mocap_subject_t* target, const rc_route_t* route, const rc_route_dest_t* dests);
+static void __pack_gps_origin(std::vector<rc_mav_packet_t>& out, int idx, const rc_route_t* route,
+			const rc_route_dest_t* dests);
+static void __process_subjects(int begin, int end, int worker, void* ctx);
+static int __send_heartbeat(rc_timer_id_t id, void* ctx, uint64_t now_usec);
+static int __send_speed(rc_timer_id_t id, void* ctx, uint64_t now_usec);
+static void __track_dests(const std::vector<rc_mav_packet_t>& sent, uint64_t now_usec);
+static void __start_speed_timers(const rc_mocap_subject_t* subjects, int n, uint64_t now_usec);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+static uint64_t __steady_usec()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// rate limiting, keeps the average rate even when frames don't divide it
+static int __due(uint64_t* next, uint32_t period_usec, uint64_t capture_usec)
+{
+	if(period_usec == 0) return 1;
+	if(capture_usec < *next) return 0;
+	if(*next == 0 || capture_usec - *next >= period_usec){
+		*next = capture_usec + period_usec;
+	}
+	else *next += period_usec;
+	return 1;
+}
+
+
+// adds a pose to the mean, with the quaternion flipped into the same
+// hemisphere as the sum so q and -q don't cancel
+static void __accumulate(int idx, const rc_route_t* route, const float pos[3], const float q[4], uint64_t capture_usec)
+{
+	bridge_mean_t* m = &mean[idx];
+	float in[8];
+	float* sum = (float*)m;
+	float dot;
+	int k;
+
+	// frames from before a gap in the stream don't belong to this interval
+	if(m->count == 0.0f || capture_usec - mean_start_usec[idx] >= 2ull * route->period_usec){
+		memset(m, 0, sizeof(*m));
+		mean_start_usec[idx] = capture_usec;
+	}
+	dot = m->q[0] * q[0] + m->q[1] * q[1] + m->q[2] * q[2] + m->q[3] * q[3];
+	in[0] = pos[0];
+	in[1] = pos[1];
+	in[2] = pos[2];
+	in[3] = 1.0f;
+	for(k=0; k<4; k++) in[4 + k] = dot < 0.0f ? -q[k] : q[k];
+	for(k=0; k<8; k++) sum[k] += in[k];
+}
+
+
+// the mean of the poses since the last send, normalized, and starts over.
+// Leaves pos and q alone if every frame was occluded.
+static void __take_mean(int idx, float pos[3], float q[4])
+{
+	bridge_mean_t* m = &mean[idx];
+	float norm;
+	int k;
+
+	if(m->count == 0.0f) return;
+	norm = sqrtf(m->q[0] * m->q[0] + m->q[1] * m->q[1] + m->q[2] * m->q[2] + m->q[3] * m->q[3]);
+	for(k=0; k<3; k++) pos[k] = m->pos[k] / m->count;
+	if(norm > 0.0f){
+		for(k=0; k<4; k++) q[k] = m->q[k] / norm;
+	}
+	m->count = 0.0f;
+}
+
+
+// low-pass filtered finite difference, restarts after a gap. The position
+// variance is the running mean of half the squared miss of the constant
+// velocity prediction, half because the miss holds the noise of two frames,
+// and the velocity variance what the filter passes of that noise.
+static void __update_velocity(int idx, const float pos[3], uint64_t capture_usec)
+{
+	float* p = &pos_prev[3 * idx];
+	float* v = &vel[3 * idx];
+	float* pv = &pos_var[3 * idx];
+	float* vv = &vel_var[3 * idx];
+	double dt_usec = (double)(capture_usec - state_usec[idx]);
+	float alpha, beta, dt, r;
+	int k;
+
+	if(state_usec[idx] == 0 || capture_usec <= state_usec[idx] || dt_usec > SPEED_STALE_USEC){
+		for(k=0; k<3; k++){
+			v[k] = 0.0f;
+			pv[k] = VAR_UNKNOWN;
+			vv[k] = VAR_UNKNOWN;
+		}
+	}
+	else{
+		alpha = (float)(dt_usec / (SPEED_TAU_USEC + dt_usec));
+		dt = (float)(dt_usec / 1000000.0);
+		for(k=0; k<3; k++){
+			// the first miss after a restart starts the mean
+			beta = pv[k] == VAR_UNKNOWN ? 1.0f : (float)(dt_usec / (VAR_TAU_USEC + dt_usec));
+			r = pos[k] - (p[k] + v[k] * dt);
+			pv[k] += beta * (0.5f * r * r - pv[k]);
+			vv[k] = alpha / (2.0f - alpha) * 2.0f * pv[k] / (dt * dt);
+			v[k] += alpha * ((pos[k] - p[k]) / dt - v[k]);
+		}
+	}
+	p[0] = pos[0];
+	p[1] = pos[1];
+	p[2] = pos[2];
+	state_usec[idx] = capture_usec;
+}
+
+
+// every unoccluded subject whose route gives it a system id, which is how
+// the vehicles tell each other apart, returns how many
+static int __snapshot(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes)
+{
+	const rc_route_t* route;
+	int i, k, m = 0;
+
+	nb_point.resize(n);
+	for(k=0; k<3; k++){
+		nb_pos[k].resize(n);
+		nb_vel[k].resize(n);
+	}
+	nb_sysid.resize(n);
+	for(i=0; i<n; i++){
+		nb_point[i] = -1;
+		if(subjects[i].occluded) continue;
+		route = rc_route_find(routes, subjects[i].name);
+		if(route == NULL || route->sysid == 0) continue;
+		for(k=0; k<3; k++){
+			nb_pos[k][m] = (float)subjects[i].translation[k];
+			// from the frames before, the workers update it during this one
+			nb_vel[k][m] = vel[3 * subjects[i].index + k];
+		}
+		nb_sysid[m] = route->sysid;
+		nb_point[i] = m++;
+	}
+	return m;
+}
+
+
+// conflicts between the m points of the snapshot, indexed by point, the
+// most urgent ones when there are more than the list has room for
+static int __find_conflicts(int m)
+{
+	int i, found;
+
+	conflicts.resize((size_t)m * CONFLICTS_PER_VEHICLE);
+	found = rc_collision_detect(nb_pos[0].data(), nb_pos[1].data(), nb_pos[2].data(),
+		nb_vel[0].data(), nb_vel[1].data(), nb_vel[2].data(), m, &collision_cfg,
+		conflicts.data(), (int)conflicts.size());
+	if(found < 0) return -1;
+	conflict_first.assign(m + 1, 0);
+	for(i=0; i<found; i++){
+		conflict_first[conflicts[i].a + 1]++;
+		conflict_first[conflicts[i].b + 1]++;
+	}
+	for(i=0; i<m; i++) conflict_first[i + 1] += conflict_first[i];
+	conflict_list.resize(2 * found);
+	for(i=0; i<found; i++){
+		conflict_list[conflict_first[conflicts[i].a]++] = i;
+		conflict_list[conflict_first[conflicts[i].b]++] = i;
+	}
+	for(i=m; i>0; i--) conflict_first[i] = conflict_first[i - 1];
+	conflict_first[0] = 0;
+	return 0;
+}
+
+
+// every unoccluded subject is an obstacle to the others, whether routed or
+// not, and the table's fixed obstacles with them
+static int __build_scans(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes)
+{
+	const rc_scan_obstacle_t* fixed;
+	int i, k, num_fixed, m = 0;
+
+	sc_point.resize(n);
+	for(k=0; k<3; k++) sc_pos[k].resize(n);
+	for(i=0; i<n; i++){
+		sc_point[i] = -1;
+		if(subjects[i].occluded) continue;
+		for(k=0; k<3; k++) sc_pos[k][m] = (float)subjects[i].translation[k];
+		sc_point[i] = m++;
+	}
+	fixed = rc_route_obstacles(routes, &num_fixed);
+	return rc_scan_build(sc_pos[0].data(), sc_pos[1].data(), sc_pos[2].data(), m,
+			fixed, num_fixed, &scan_cfg);
+}
+
+
+// frames mostly list the subjects in the same order, so the hint from the
+// last frame nearly always saves the search
+static int __find_subject(const rc_mocap_subject_t* subjects, int n, const char* name, int* hint)
+{
+	int i;
+
+	if(*hint >= 0 && *hint < n && strcmp(subjects[*hint].name, name) == 0) return *hint;
+	for(i=0; i<n; i++){
+		if(strcmp(subjects[i].name, name) == 0){
+			*hint = i;
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+// pairs every unoccluded subject whose route wants landing_target or
+// follow_target with its unoccluded target, and works them all out at once
+static void __find_targets(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes)
+{
+	const rc_route_t* route;
+	const char* name;
+	int i, j, idx;
+
+	rc_relpose_clear();
+	target_pair.resize(n);
+	target_of.resize(n);
+	for(i=0; i<n; i++){
+		target_pair[i] = -1;
+		if(subjects[i].occluded) continue;
+		route = rc_route_find(routes, subjects[i].name);
+		if(route == NULL || !(route->messages & (RC_ROUTE_MSG_LANDING_TARGET | RC_ROUTE_MSG_FOLLOW_TARGET))) continue;
+		name = rc_route_target(routes, route);
+		if(name == NULL) continue;
+		idx = subjects[i].index;
+		j = __find_subject(subjects, n, name, &target_hint[idx]);
+		if(j < 0 || j == i || subjects[j].occluded) continue;
+		// from the frames before, the workers update it during this one
+		target_pair[i] = rc_relpose_add(subjects[i].translation, subjects[i].quaternion,
+				subjects[j].translation, &vel[3 * subjects[j].index]);
+		target_of[i] = j;
+	}
+	rc_relpose_compute();
+}
+
+
+// every unoccluded subject whose route sends a geodetic format, converted in
+// one pass as the encoders would
+static void __find_geodetic(const rc_mocap_subject_t* subjects, int n, const rc_route_table_t* routes)
+{
+	const rc_route_t* route;
+	float raw[3], ned[3];
+	int i, k, m = 0;
+
+	geo_point.resize(n);
+	for(k=0; k<3; k++){
+		geo_ned[k].resize(n);
+		geo_lla[k].resize(n);
+	}
+	for(i=0; i<n; i++){
+		geo_point[i] = -1;
+		if(subjects[i].occluded) continue;
+		route = rc_route_find(routes, subjects[i].name);
+		if(route == NULL || !(route->formats & RC_ROUTE_FORMATS_GEODETIC)) continue;
+		for(k=0; k<3; k++) raw[k] = (float)subjects[i].translation[k];
+		rc_route_transform_vector(rc_pose_ned_transform(&route->transform), raw, 1, ned);
+		for(k=0; k<3; k++) geo_ned[k][m] = ned[k];
+		geo_point[i] = m++;
+	}
+	rc_geo_from_ned(geo_ned[0].data(), geo_ned[1].data(), geo_ned[2].data(), m,
+			geo_lla[0].data(), geo_lla[1].data(), geo_lla[2].data());
+}
+
+
+static int __max_threat(int point)
+{
+	int j, threat = 0;
+
+	for(j=conflict_first[point]; j<conflict_first[point + 1]; j++){
+		if(conflicts[conflict_list[j]].threat > threat) threat = conflicts[conflict_list[j]].threat;
+	}
+	return threat;
+}
+
+
+// one COLLISION per vehicle in conflict with this one, identified by its
+// system id
+static void __pack_collisions(std::vector<rc_mav_packet_t>& out, int point, int idx,
+			const rc_route_t* route, const rc_route_dest_t* dests)
+{
+	const rc_collision_t* c;
+	mavlink_collision_t msg;
+	int j, k;
+
+	msg.src = MAV_COLLISION_SRC_MAVLINK_GPS_GLOBAL_INT;
+	msg.action = MAV_COLLISION_ACTION_REPORT;
+	for(j=conflict_first[point]; j<conflict_first[point + 1]; j++){
+		c = &conflicts[conflict_list[j]];
+		msg.id = nb_sysid[c->a == point ? c->b : c->a];
+		msg.time_to_minimum_delta = c->time_s;
+		msg.altitude_minimum_delta = c->vertical_m;
+		msg.horizontal_minimum_delta = c->horizontal_m;
+		msg.threat_level = c->threat;
+		for(k=0; k<route->num_dests; k++){
+			out.emplace_back();
+			if(rc_mav_pack(&out.back(), dests[k].addr, dests[k].port, route->sysid,
+					seq[idx], msg)){
+				out.pop_back();
+			}
+		}
+		seq[idx]++;
+	}
+}
+
+
+// one LOCAL_POSITION_NED per neighbor, from the neighbor's system id and in
+// the receiving route's frame
+static void __pack_neighbors(std::vector<rc_mav_packet_t>& out, int i, int idx, const float p[3],
+			const rc_route_t* route, const rc_route_dest_t* dests)
+{
+	mavlink_local_position_ned_t msg;
+	int near[RC_ROUTE_MAX_NEIGHBORS];
+	float v[3], out_v[3];
+	int j, k, m, found;
+
+	found = rc_grid_nearest(p, nb_point[i], route->neighbors, near);
+	msg.time_boot_ms = (uint32_t)(rc_mav_time_usec() / 1000);
+	for(j=0; j<found; j++){
+		m = near[j];
+		v[0] = nb_pos[0][m];
+		v[1] = nb_pos[1][m];
+		v[2] = nb_pos[2][m];
+		rc_route_transform_vector(&route->transform, v, 1, out_v);
+		msg.x = out_v[0];
+		msg.y = out_v[1];
+		msg.z = out_v[2];
+		v[0] = nb_vel[0][m];
+		v[1] = nb_vel[1][m];
+		v[2] = nb_vel[2][m];
+		rc_route_transform_vector(&route->transform, v, 0, out_v);
+		msg.vx = out_v[0];
+		msg.vy = out_v[1];
+		msg.vz = out_v[2];
+		for(k=0; k<route->num_dests; k++){
+			out.emplace_back();
+			if(rc_mav_pack(&out.back(), dests[k].addr, dests[k].port, nb_sysid[m],
+					neighbor_seq[idx], msg)){
+				out.pop_back();
+			}
+		}
+		neighbor_seq[idx]++;
+	}
+}
+
+
+// the scan around the subject, turned with its heading
+static void __pack_scan(std::vector<rc_mav_packet_t>& out, int i, int idx, const float p[3],
+			const double q[4], const rc_route_t* route, const rc_route_dest_t* dests)
+{
+	mavlink_obstacle_distance_t msg;
+	uint16_t distances[RC_SCAN_SECTORS];
+	float yaw;
+	int k;
+
+	// SDK quaternions are x y z w
+	yaw = (float)atan2(2.0 * (q[3] * q[2] + q[0] * q[1]), 1.0 - 2.0 * (q[1] * q[1] + q[2] * q[2]));
+	msg.max_distance = rc_scan_sectors(p, yaw, sc_point[i], distances);
+	// the message is packed, so not written through a pointer
+	memcpy(msg.distances, distances, sizeof(distances));
+	msg.time_usec = rc_mav_time_usec();
+	msg.min_distance = RC_SCAN_MIN_CM;
+	msg.sensor_type = MAV_DISTANCE_SENSOR_LASER;
+	msg.increment = RC_SCAN_INCREMENT;
+	for(k=0; k<route->num_dests; k++){
+		out.emplace_back();
+		if(rc_mav_pack(&out.back(), dests[k].addr, dests[k].port, route->sysid,
+				seq[idx], msg)){
+			out.pop_back();
+		}
+	}
+	seq[idx]++;
+}
+
+
+// the target as a downward camera on the vehicle would see it, and where
+// it is in the route's frame if that is ned
+static void __pack_landing_target(std::vector<rc_mav_packet_t>& out, int i, int idx,
+			const rc_mocap_subject_t* target, const rc_route_t* route, const rc_route_dest_t* dests)
+{
+	const rc_relpose_t* r = rc_relpose_get(target_pair[i]);
+	mavlink_landing_target_t msg;
+	float pos[3], q[4];
+	int k;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.time_usec = rc_mav_time_usec();
+	msg.angle_x = r->angle_x;
+	msg.angle_y = r->angle_y;
+	msg.distance = r->distance;
+	msg.frame = MAV_FRAME_LOCAL_NED;
+	msg.type = LANDING_TARGET_TYPE_VISION_OTHER;
+	msg.q[0] = 1.0f;
+	if(route->transform.ned){
+		rc_route_transform(&route->transform, target->translation, target->quaternion, pos, q);
+		msg.x = pos[0];
+		msg.y = pos[1];
+		msg.z = pos[2];
+		for(k=0; k<4; k++) msg.q[k] = q[k];
+		msg.position_valid = 1;
+	}
+	for(k=0; k<route->num_dests; k++){
+		out.emplace_back();
+		if(rc_mav_pack(&out.back(), dests[k].addr, dests[k].port, route->sysid,
+				seq[idx], msg)){
+			out.pop_back();
+		}
+	}
+	seq[idx]++;
+}
+
+
+// the target's geodetic position, velocity and attitude. Routes in the raw
+// frame get north along the SDK x axis and no attitude.
+static void __pack_follow_target(std::vector<rc_mav_packet_t>& out, int i, int idx,
+			const rc_mocap_subject_t* target, const rc_route_t* route, const rc_route_dest_t* dests)
+{
+	const rc_relpose_t* r = rc_relpose_get(target_pair[i]);
+	mavlink_follow_target_t msg;
+	float pos[3], q[4], v[3];
+	double lla[3];
+	int k;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.timestamp = rc_mav_time_usec() / 1000;
+	msg.attitude_q[0] = 1.0f;
+	msg.est_capabilities = (1 << 0) | (1 << 1);	// position and velocity
+	if(route->transform.ned){
+		rc_route_transform(&route->transform, target->translation, target->quaternion, pos, q);
+		rc_route_transform_vector(&route->transform, r->target_vel, 0, v);
+		for(k=0; k<4; k++) msg.attitude_q[k] = q[k];
+		msg.est_capabilities |= 1 << 3;
+	}
+	else{
+		for(k=0; k<3; k++){
+			pos[k] = (float)target->translation[k] / (k == 0 ? 1000.0f : -1000.0f);
+			v[k] = r->target_vel[k] / (k == 0 ? 1000.0f : -1000.0f);
+		}
+	}
+	for(k=0; k<3; k++) msg.vel[k] = v[k];
+	rc_geo_point(pos, lla);
+	msg.lat = rc_geo_e7(lla[0]);
+	msg.lon = rc_geo_e7(lla[1]);
+	msg.alt = (float)lla[2];
+	for(k=0; k<route->num_dests; k++){
+		out.emplace_back();
+		if(rc_mav_pack(&out.back(), dests[k].addr, dests[k].port, route->sysid,
+				seq[idx], msg)){
+			out.pop_back();
+		}
+	}
+	seq[idx]++;
+}
+
+
+// the origin, to the destinations taking geodetic positions
+static void __pack_gps_origin(std::vector<rc_mav_packet_t>& out, int idx, const rc_route_t* route,
+			const rc_route_dest_t* dests)
+{
+	mavlink_set_gps_global_origin_t msg;
+	double lat, lon, alt;
+	int k;
+
+	rc_geo_origin(&lat, &lon, &alt);
+	msg.latitude = rc_geo_e7(lat);
+	msg.longitude = rc_geo_e7(lon);
+	msg.altitude = (int32_t)llround(alt * 1000.0);
+	msg.target_system = route->sysid;
+	msg.time_usec = rc_mav_time_usec();
+	for(k=0; k<route->num_dests; k++){
+		if(!((1u << dests[k].format) & RC_ROUTE_FORMATS_GEODETIC)) continue;
+		out.emplace_back();
+		if(rc_mav_pack(&out.back(), dests[k].addr, dests[k].port, route->sysid,
+				seq[idx], msg)){
+			out.pop_back();
+		}
+	}
+	seq[idx]++;
+}
+
+
+static void __process_subjects(int begin, int end, int worker, void* ctx)
+{
+	bridge_frame_t* job = (bridge_frame_t*)ctx;
+	std::vector<rc_mav_packet_t>& out = packets[worker];
+	const rc_mocap_subject_t* subject;
+	const rc_route_t* route;
+	const rc_route_dest_t* dests;
+	rc_route_t name_route;
+	rc_route_dest_t name_dest;
+	rc_pose_t pose;
+	const char* at;
+	uint64_t t;
+	float pos[3], q[4], raw[3];
+	size_t first;
+	int i, k, idx, decimate, due, threat, escalated, scan;
+
+	// subjects routed by name get the defaults with one destination
+	memset(&name_route, 0, sizeof(name_route));
+	name_route.messages = RC_ROUTE_MSG_ATT_POS_MOCAP;
+	name_route.target = -1;
+	name_route.num_dests = 1;
+	name_dest.port = 0;
+	name_dest.format = RC_ROUTE_FORMAT_ATT_POS_MOCAP;
+
+	for(i=begin; i<end; i++){
+		subject = &job->subjects[i];
+		idx = subject->index;
+		job->prepared[i] = 0;
+		rc_lat_set_subject(idx);
+		t = rc_lat_now();
+
+		// the velocity needs every frame, not only those sent, and a target
+		// needs it even if it isn't sent anywhere
+		raw[0] = (float)subject->translation[0];
+		raw[1] = (float)subject->translation[1];
+		raw[2] = (float)subject->translation[2];
+		if(!subject->occluded) __update_velocity(idx, raw, job->capture_usec);
+
+		route = rc_route_find(job->routes, subject->name);
+		if(route != NULL){
+			dests = rc_route_dests(job->routes, route);
+		}
+		else{
+			// subject names are name@IPaddress, use everything after the last @
+			at = strrchr(subject->name, '@');
+			if(rc_mav_parse_ip(at != NULL ? at + 1 : subject->name, &name_dest.addr)){
+				rc_display_set_status("ERROR setting dest ip, add the subject to the routing file or name it name@IPaddress");
+				rc_display_count_drop(idx);
+				continue;
+			}
+			route = &name_route;
+			dests = &name_dest;
+		}
+
+		rc_route_transform(&route->transform, subject->translation, subject->quaternion, pos, q);
+		if(!subject->occluded && (route->messages & RC_ROUTE_MSG_VISION_SPEED_ESTIMATE) &&
+				speed_period[idx] != route->speed_period_usec){
+			speed_wanted[idx] = 1;
+		}
+		// a conflict becoming more serious goes out in this frame even if
+		// the pose isn't due
+		threat = 0;
+		if((route->messages & RC_ROUTE_MSG_COLLISION) && job->collisions && nb_point[i] >= 0){
+			threat = __max_threat(nb_point[i]);
+		}
+		escalated = threat > threat_prev[idx];
+		threat_prev[idx] = (uint8_t)threat;
+
+		decimate = route->period_usec != 0 && route->filter == RC_ROUTE_FILTER_MEAN;
+		if(decimate && !subject->occluded){
+			__accumulate(idx, route, pos, q, job->capture_usec);
+		}
+		due = __due(&next_due[idx], route->period_usec, job->capture_usec);
+		// the scans have their own rate
+		scan = (route->messages & RC_ROUTE_MSG_OBSTACLE_DISTANCE) && job->scans &&
+			!subject->occluded && __due(&scan_due[idx], route->scan_period_usec, job->capture_usec);
+		if(!due && !escalated && !scan){
+			rc_lat_record(RC_LAT_TRANSFORM, idx, t);
+			continue;
+		}
+		if(due && decimate) __take_mean(idx, pos, q);
+		rc_lat_record(RC_LAT_TRANSFORM, idx, t);
+
+		// pack and sign are timed inside the rc_mav library, every
+		// destination gets the same sequence number
+		first = out.size();
+		// vehicles navigating on the geodetic formats first get the origin,
+		// and again after the file is reloaded
+		if(due && (route->formats & RC_ROUTE_FORMATS_GEODETIC) &&
+				(route->messages & RC_ROUTE_MSG_ATT_POS_MOCAP) && origin_gen[idx] != job->generation){
+			__pack_gps_origin(out, idx, route, dests);
+			origin_gen[idx] = job->generation;
+		}
+		if(due && (route->messages & RC_ROUTE_MSG_ATT_POS_MOCAP)){
+			pose.time_usec = rc_mav_time_usec();
+			pose.transform = &route->transform;
+			for(k=0; k<3; k++) pose.pos[k] = pos[k];
+			for(k=0; k<4; k++) pose.q[k] = q[k];
+			pose.vel = &vel[3 * idx];
+			pose.var_pos = &pos_var[3 * idx];
+			pose.var_vel = &vel_var[3 * idx];
+			// an average of several frames isn't what was converted
+			pose.has_lla = job->geodetic && geo_point[i] >= 0 && !decimate;
+			if(pose.has_lla){
+				for(k=0; k<3; k++) pose.lla[k] = geo_lla[k][geo_point[i]];
+			}
+			for(k=0; k<route->num_dests; k++){
+				out.emplace_back();
+				if(rc_pose_pack(dests[k].format, &out.back(), dests[k].addr, dests[k].port,
+						route->sysid, seq[idx], &pose)){
+					out.pop_back();
+				}
+			}
+		}
+		if(due && (route->messages & RC_ROUTE_MSG_NEIGHBORS) && job->grid){
+			__pack_neighbors(out, i, idx, raw, route, dests);
+		}
+		if(due) seq[idx]++;
+		if(due && job->targets && target_pair[i] >= 0){
+			if(route->messages & RC_ROUTE_MSG_LANDING_TARGET){
+				__pack_landing_target(out, i, idx, &job->subjects[target_of[i]], route, dests);
+			}
+			if(route->messages & RC_ROUTE_MSG_FOLLOW_TARGET){
+				__pack_follow_target(out, i, idx, &job->subjects[target_of[i]], route, dests);
+			}
+		}
+		if(threat && (due || escalated)) __pack_collisions(out, nb_point[i], idx, route, dests);
+		if(scan) __pack_scan(out, i, idx, raw, subject->quaternion, route, dests);
+		if(out.size() == first){
+			rc_display_count_drop(idx);
+			continue;
+		}
+		job->prepared[i] = 1;
+	}
+	rc_lat_set_subject(RC_LAT_ALL_SUBJECTS);
+}
+
+
+static int __send_heartbeat(rc_timer_id_t id, void* ctx, uint64_t now_usec)
+{
+	bridge_dest_t* d = (bridge_dest_t*)ctx;
+	mavlink_heartbeat_t hb;
+
+	if(now_usec - d->last_used_usec > DEST_IDLE_USEC){
+		dests.erase(d->key);
+		return 1;
+	}
+	memset(&hb, 0, sizeof(hb));
+	hb.type = MAV_TYPE_GCS;
+	hb.autopilot = MAV_AUTOPILOT_INVALID;
+	hb.system_status = MAV_STATE_ACTIVE;
+	hb.mavlink_version = 3;
+	heartbeats.emplace_back();
+	if(rc_mav_pack(&heartbeats.back(), (uint32_t)(d->key >> 16), (uint16_t)d->key,
+			0, d->seq++, hb)){
+		heartbeats.pop_back();
+	}
+	return 0;
+}
+
+
+// sends the filtered velocity to every destination of the subject's route,
+// and stops once the subject or its route is gone
+static int __send_speed(rc_timer_id_t id, void* ctx, uint64_t now_usec)
+{
+	int idx = (int)(intptr_t)ctx;
+	std::unordered_map<int, bridge_speed_t>::iterator it = speeds.find(idx);
+	const rc_route_t* route;
+	const rc_route_dest_t* d;
+	mavlink_vision_speed_estimate_t msg;
+	float v[3];
+	int k;
+
+	if(it == speeds.end() || it->second.timer != id) return 1;
+	route = rc_route_find(timer_routes, it->second.name);
+	if(route == NULL || !(route->messages & RC_ROUTE_MSG_VISION_SPEED_ESTIMATE) ||
+			route->speed_period_usec != speed_period[idx] ||
+			last_capture_usec - state_usec[idx] > SPEED_STALE_USEC ||
+			now_usec - last_frame_usec > SPEED_STALE_USEC){
+		speed_period[idx] = 0;
+		speeds.erase(it);
+		return 1;
+	}
+	d = rc_route_dests(timer_routes, route);
+	msg.usec = rc_mav_time_usec();
+	rc_route_transform_vector(&route->transform, &vel[3 * idx], 0, v);
+	msg.x = v[0];
+	msg.y = v[1];
+	msg.z = v[2];
+	for(k=0; k<route->num_dests; k++){
+		periodic.emplace_back();
+		if(rc_mav_pack(&periodic.back(), d[k].addr, d[k].port, route->sysid, seq[idx], msg)){
+			periodic.pop_back();
+		}
+	}
+	seq[idx]++;
+	return 0;
+}
+
+
+// a destination seen for the first time gets a heartbeat timer
+static void __track_dests(const std::vector<rc_mav_packet_t>& sent, uint64_t now_usec)
+{
+	bridge_dest_t* d;
+	uint64_t key;
+
+	for(const rc_mav_packet_t& p : sent){
+		if(p.len == 0) continue;
+		key = ((uint64_t)p.dest_addr << 16) | p.dest_port;
+		d = &dests[key];
+		if(d->key != key){
+			d->key = key;
+			d->seq = 0;
+			// node addresses stay valid while the map grows
+			if(rc_timer_add(now_usec, HEARTBEAT_USEC, __send_heartbeat, d) == 0){
+				dests.erase(key);
+				continue;
+			}
+		}
+		d->last_used_usec = now_usec;
+	}
+}
+
+
+// subjects the workers flagged get a timer at their route's speed_rate
+static void __start_speed_timers(const rc_mocap_subject_t* subjects, int n, uint64_t now_usec)
+{
+	const rc_route_t* route;
+	bridge_speed_t* s;
+	int i, idx;
+
+	for(i=0; i<n; i++){
+		idx = subjects[i].index;
+		if(!speed_wanted[idx]) continue;
+		speed_wanted[idx] = 0;
+		route = rc_route_find(timer_routes, subjects[i].name);
+		if(route == NULL) continue;
+		s = &speeds[idx];
+		if(s->timer != 0) rc_timer_cancel(s->timer);
+		strcpy(s->name, subjects[i].name);
+		s->timer = rc_timer_add(now_usec, route->speed_period_usec, __send_speed, (void*)(intptr_t)idx);
+		if(s->timer == 0){
+			speeds.erase(idx);
+			continue;
+		}
+		speed_period[idx] = route->speed_period_usec;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR bridge_pipeline.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_bridge_init(int workers, int chunk)
+{
+	if(chunk < 1){
+		fprintf(stderr, "ERROR: in rc_bridge_init, chunk must be at least 1\n");
+		return -1;
+	}
+	if(rc_pool_init(workers)) return -1;
+	chunk_size = chunk;
+	seq.assign(MAX_SUBJECT_INDEX, 0);
+	next_due.assign(MAX_SUBJECT_INDEX, 0);
+	scan_due.assign(MAX_SUBJECT_INDEX, 0);
+	failed.assign(MAX_SUBJECT_INDEX, 0);
+	mean.assign(MAX_SUBJECT_INDEX, bridge_mean_t());
+	mean_start_usec.assign(MAX_SUBJECT_INDEX, 0);
+	pos_prev.assign(3 * MAX_SUBJECT_INDEX, 0.0f);
+	vel.assign(3 * MAX_SUBJECT_INDEX, 0.0f);
+	pos_var.assign(3 * MAX_SUBJECT_INDEX, VAR_UNKNOWN);
+	vel_var.assign(3 * MAX_SUBJECT_INDEX, VAR_UNKNOWN);
+	state_usec.assign(MAX_SUBJECT_INDEX, 0);
+	speed_wanted.assign(MAX_SUBJECT_INDEX, 0);
+	speed_period.assign(MAX_SUBJECT_INDEX, 0);
+	neighbor_seq.assign(MAX_SUBJECT_INDEX, 0);
+	threat_prev.assign(MAX_SUBJECT_INDEX, 0);
+	target_hint.assign(MAX_SUBJECT_INDEX, -1);
+	origin_gen.assign(MAX_SUBJECT_INDEX, 0);
+	rc_collision_default_config(&collision_cfg);
+	rc_scan_default_config(&scan_cfg);
+	if(rc_timer_init(__steady_usec())){
+		rc_pool_cleanup();
+		return -1;
+	}
+	return 0;
+}
+
+
+int rc_bridge_reserve(int max_subjects)
+{
+	size_t packets_each;
+	int w, k;
+
+	if(max_subjects < 1 || max_subjects > MAX_SUBJECT_INDEX){
+		fprintf(stderr, "ERROR: in rc_bridge_reserve, subjects must be between 1 and %d\n", MAX_SUBJECT_INDEX);
+		return -1;
+	}
+	if(prepared.size() < (size_t)max_subjects) prepared.resize(max_subjects);
+	// a worker may steal every chunk of a frame
+	packets_each = (size_t)max_subjects * RESERVE_PACKETS;
+	for(w=0; w<rc_pool_num_workers(); w++) packets[w].reserve(packets_each);
+	for(k=0; k<3; k++){
+		nb_pos[k].reserve(max_subjects);
+		nb_vel[k].reserve(max_subjects);
+		sc_pos[k].reserve(max_subjects);
+		geo_ned[k].reserve(max_subjects);
+		geo_lla[k].reserve(max_subjects);
+	}
+	nb_sysid.reserve(max_subjects);
+	nb_point.reserve(max_subjects);
+	conflicts.reserve((size_t)max_subjects * CONFLICTS_PER_VEHICLE);
+	conflict_first.reserve(max_subjects + 1);
+	conflict_list.reserve(2 * (size_t)max_subjects * CONFLICTS_PER_VEHICLE);
+	sc_point.reserve(max_subjects);
+	target_pair.reserve(max_subjects);
+	target_of.reserve(max_subjects);
+	geo_point.reserve(max_subjects);
+	periodic.reserve(max_subjects);
+	heartbeats.reserve(max_subjects);
+	dests.reserve(max_subjects);
+	speeds.reserve(max_subjects);
+	rc_grid_reserve(max_subjects);
+	rc_collision_reserve(max_subjects);
+	rc_scan_reserve(max_subjects);
+	rc_relpose_reserve(max_subjects);
+	// a heartbeat per destination and a speed estimate per subject
+	rc_timer_reserve(2 * max_subjects);
+	return 0;
+}
+
+
+int rc_bridge_process_frame(const rc_mocap_frame_t* frame)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const rc_mocap_subject_t* subjects = rc_mocap_frame_subjects(frame);
+	bridge_frame_t job;
+	float q[4];
+	double latency_s;
+	double lat, lon, alt;
+	uint32_t messages;
+	int n = (int)frame->subject_count;
+	int i, m, w, ret, sent = 0;
+
+	if(prepared.size() < (size_t)n) prepared.resize(n);
+	for(w=0; w<rc_pool_num_workers(); w++) packets[w].clear();
+	job.subjects = subjects;
+	job.generation = rc_route_generation();
+	job.routes = rc_route_acquire();
+	job.capture_usec = frame->capture_usec;
+	job.prepared = prepared.data();
+	job.grid = 0;
+	job.collisions = 0;
+	job.scans = 0;
+	job.targets = 0;
+	job.geodetic = 0;
+	messages = rc_route_messages(job.routes);
+	// for follow_target and the geodetic formats, refitted only when the
+	// reloaded table moves it
+	rc_route_origin(job.routes, &lat, &lon, &alt);
+	rc_geo_set_origin(lat, lon, alt);
+	if(messages & (RC_ROUTE_MSG_NEIGHBORS | RC_ROUTE_MSG_COLLISION)){
+		m = __snapshot(subjects, n, job.routes);
+		if(messages & RC_ROUTE_MSG_NEIGHBORS){
+			job.grid = rc_grid_build(nb_pos[0].data(), nb_pos[1].data(), nb_pos[2].data(), m, RC_GRID_AUTO_CELL) == 0;
+		}
+		if(messages & RC_ROUTE_MSG_COLLISION) job.collisions = __find_conflicts(m) == 0;
+	}
+	if(messages & RC_ROUTE_MSG_OBSTACLE_DISTANCE){
+		job.scans = __build_scans(subjects, n, job.routes) == 0;
+	}
+	if(messages & (RC_ROUTE_MSG_LANDING_TARGET | RC_ROUTE_MSG_FOLLOW_TARGET)){
+		__find_targets(subjects, n, job.routes);
+		job.targets = 1;
+	}
+	if(rc_route_formats(job.routes) & RC_ROUTE_FORMATS_GEODETIC){
+		__find_geodetic(subjects, n, job.routes);
+		job.geodetic = 1;
+	}
+	ret = rc_pool_run(n, chunk_size, __process_subjects, &job);
+	if(ret){
+		rc_route_release();
+		return -1;
+	}
+	last_capture_usec = frame->capture_usec;
+	last_frame_usec = __steady_usec();
+	timer_routes = job.routes;
+	__start_speed_timers(subjects, n, last_frame_usec);
+	timer_routes = NULL;
+	rc_route_release();
+
+	// everyone is past the barrier, flush the whole frame at once
+	for(w=0; w<rc_pool_num_workers(); w++){
+		if(packets[w].empty()) continue;
+		ret = rc_mav_send_packets(packets[w].data(), (int)packets[w].size());
+		if(ret < 0) return -1;
+		sent += ret;
+		for(rc_mav_packet_t& p : packets[w]){
+			if(p.len == 0 && p.subject >= 0) failed[p.subject] = 1;
+		}
+		__track_dests(packets[w], last_frame_usec);
+	}
+
+	// hand the poses to the display thread, no formatting in this loop
+	latency_s = frame->latency_s + std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	for(i=0; i<n; i++){
+		if(!prepared[i]) continue;
+		if(failed[subjects[i].index]){
+			failed[subjects[i].index] = 0;
+			rc_display_count_drop(subjects[i].index);
+			continue;
+		}
+		// the SDK's x, y, z, w to the display's w, x, y, z
+		q[0] = (float)subjects[i].quaternion[3];
+		q[1] = (float)subjects[i].quaternion[0];
+		q[2] = (float)subjects[i].quaternion[1];
+		q[3] = (float)subjects[i].quaternion[2];
+		rc_display_publish_pose(subjects[i].index, subjects[i].name, q,
+			subjects[i].translation, subjects[i].occluded, latency_s);
+	}
+	return sent;
+}
+
+
+int rc_bridge_run_timers()
+{
+	uint64_t now = __steady_usec();
+	int ret, sent = 0;
+
+	periodic.clear();
+	heartbeats.clear();
+	timer_routes = rc_route_acquire();
+	rc_timer_advance(now);
+	timer_routes = NULL;
+	rc_route_release();
+	if(!periodic.empty()){
+		ret = rc_mav_send_packets(periodic.data(), (int)periodic.size());
+		if(ret < 0) return -1;
+		sent += ret;
+		__track_dests(periodic, now);
+	}
+	if(!heartbeats.empty()){
+		ret = rc_mav_send_packets(heartbeats.data(), (int)heartbeats.size());
+		if(ret < 0) return -1;
+		sent += ret;
+	}
+	return sent;
+}
+
+
+void rc_bridge_cleanup()
+{
+	rc_pool_cleanup();
+	rc_timer_cleanup();
+	rc_grid_cleanup();
+	rc_collision_cleanup();
+	rc_scan_cleanup();
+	rc_relpose_cleanup();
+	dests.clear();
+	speeds.clear();
+}
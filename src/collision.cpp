@@ -0,0 +1,307 @@
+/**
+ * @file collision.cpp
+ *
+ * @brief      Finds pairs of vehicles about to come closer than a safety
+ *             radius. See collision.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/collision.h"
+
+// swept boxes, one array per axis and side
+static std::vector<float> lo[3];
+static std::vector<float> hi[3];
+// vehicles in increasing lo[0], kept between calls
+static std::vector<int> order;
+// the boxes copied into that order so the sweep reads memory in sequence
+static std::vector<float> sorted_lo[3];
+static std::vector<float> sorted_hi[3];
+// pairs left by the broadphase, relative position and velocity of b to a
+static std::vector<int> pa, pb;
+static std::vector<float> d[3];
+static std::vector<float> w[3];
+static std::vector<float> t_min, d2_min;
+// candidates closer than the radius, cut to the soonest when out is full
+static std::vector<int> hits;
+static int num_candidates = 0;
+
+
+// private local function declarations;
+static void __sweep_boxes(const float* p[3], const float* v[3], int n, float horizon, float half);
+static void __sort_order(int n);
+static void __sweep(int n);
+static void __gather(int count, const float* p[3], const float* v[3]);
+static void __closest_points(int count, float horizon);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// box covering the vehicle from now to the horizon, grown by half the radius
+// on every side so two boxes overlap whenever the vehicles can come within
+// the radius
+static void __sweep_boxes(const float* p[3], const float* v[3], int n, float horizon, float half)
+{
+	float a, b;
+	int k, i;
+
+	for(k=0; k<3; k++){
+		lo[k].resize(n);
+		hi[k].resize(n);
+		for(i=0; i<n; i++){
+			a = p[k][i];
+			b = p[k][i] + v[k][i] * horizon;
+			lo[k][i] = (a < b ? a : b) - half;
+			hi[k][i] = (a < b ? b : a) + half;
+		}
+	}
+}
+
+
+// insertion sort, close to linear since vehicles barely move between frames
+static void __sort_order(int n)
+{
+	const float* x = lo[0].data();
+	int i, j, v;
+
+	if((int)order.size() != n){
+		order.resize(n);
+		for(i=0; i<n; i++) order[i] = i;
+	}
+	for(i=1; i<n; i++){
+		v = order[i];
+		for(j=i; j>0 && x[order[j - 1]] > x[v]; j--) order[j] = order[j - 1];
+		order[j] = v;
+	}
+}
+
+
+// pairs overlapping on every axis, kept as positions in the sorted order
+static void __sweep(int n)
+{
+	const float* xl;
+	const float* xh;
+	const float* yl;
+	const float* yh;
+	const float* zl;
+	const float* zh;
+	int i, j, k;
+
+	for(k=0; k<3; k++){
+		sorted_lo[k].resize(n);
+		sorted_hi[k].resize(n);
+		for(i=0; i<n; i++){
+			sorted_lo[k][i] = lo[k][order[i]];
+			sorted_hi[k][i] = hi[k][order[i]];
+		}
+	}
+	xl = sorted_lo[0].data();
+	xh = sorted_hi[0].data();
+	yl = sorted_lo[1].data();
+	yh = sorted_hi[1].data();
+	zl = sorted_lo[2].data();
+	zh = sorted_hi[2].data();
+	for(i=0; i<n; i++){
+		for(j=i+1; j<n && xl[j] <= xh[i]; j++){
+			if((yl[j] > yh[i]) | (yl[i] > yh[j]) | (zl[j] > zh[i]) | (zl[i] > zh[j])) continue;
+			pa.push_back(i);
+			pb.push_back(j);
+		}
+	}
+}
+
+
+// back from sorted positions to vehicles, and their relative motion
+static void __gather(int count, const float* p[3], const float* v[3])
+{
+	int i, k, a, b;
+
+	for(i=0; i<count; i++){
+		a = order[pa[i]];
+		b = order[pb[i]];
+		pa[i] = a < b ? a : b;
+		pb[i] = a < b ? b : a;
+	}
+	for(k=0; k<3; k++){
+		d[k].resize(count);
+		w[k].resize(count);
+		for(i=0; i<count; i++){
+			d[k][i] = p[k][pb[i]] - p[k][pa[i]];
+			w[k][i] = v[k][pb[i]] - v[k][pa[i]];
+		}
+	}
+}
+
+
+// time and squared distance of the closest point of every candidate,
+// written without branches so it vectorizes
+static void __closest_points(int count, float horizon)
+{
+	const float* dx = d[0].data();
+	const float* dy = d[1].data();
+	const float* dz = d[2].data();
+	const float* wx = w[0].data();
+	const float* wy = w[1].data();
+	const float* wz = w[2].data();
+	float* t_out = t_min.data();
+	float* d2_out = d2_min.data();
+	float ww, dw, t, cx, cy, cz;
+	int i;
+
+	for(i=0; i<count; i++){
+		ww = wx[i] * wx[i] + wy[i] * wy[i] + wz[i] * wz[i];
+		dw = dx[i] * wx[i] + dy[i] * wy[i] + dz[i] * wz[i];
+		// the small constant keeps vehicles flying in formation at t = 0
+		t = -dw / (ww + 1e-6f);
+		t = t < 0.0f ? 0.0f : t;
+		t = t > horizon ? horizon : t;
+		cx = dx[i] + wx[i] * t;
+		cy = dy[i] + wy[i] * t;
+		cz = dz[i] + wz[i] * t;
+		t_out[i] = t;
+		d2_out[i] = cx * cx + cy * cy + cz * cz;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR collision.h
+////////////////////////////////////////////////////////////////////////////////
+
+void rc_collision_default_config(rc_collision_config_t* cfg)
+{
+	cfg->radius_m = RC_COLLISION_DEFAULT_RADIUS;
+	cfg->horizon_s = RC_COLLISION_DEFAULT_HORIZON;
+	cfg->high_s = RC_COLLISION_DEFAULT_HIGH;
+}
+
+
+int rc_collision_detect(const float* x, const float* y, const float* z,
+			const float* vx, const float* vy, const float* vz, int n,
+			const rc_collision_config_t* cfg, rc_collision_t* out, int max)
+{
+	const float* p[3] = {x, y, z};
+	const float* v[3] = {vx, vy, vz};
+	float radius = cfg->radius_m * 1000.0f;
+	float cx, cy, cz;
+	int i, k, count, found = 0;
+
+	if(n < 0 || max < 0 || cfg->radius_m <= 0.0f || cfg->horizon_s < 0.0f){
+		fprintf(stderr, "ERROR: in rc_collision_detect, invalid arguments\n");
+		return -1;
+	}
+	pa.clear();
+	pb.clear();
+
+	__sweep_boxes(p, v, n, cfg->horizon_s, radius / 2.0f);
+	__sort_order(n);
+	__sweep(n);
+	count = (int)pa.size();
+	__gather(count, p, v);
+	num_candidates = count;
+	t_min.resize(count);
+	d2_min.resize(count);
+	__closest_points(count, cfg->horizon_s);
+
+	hits.clear();
+	for(i=0; i<count; i++){
+		if(d2_min[i] < radius * radius) hits.push_back(i);
+	}
+	// the soonest closest points matter most, then the closest ones
+	if((int)hits.size() > max){
+		std::nth_element(hits.begin(), hits.begin() + max, hits.end(), [](int a, int b){
+			return t_min[a] < t_min[b] || (t_min[a] == t_min[b] && d2_min[a] < d2_min[b]);
+		});
+		hits.resize(max);
+	}
+
+	for(k=0; k<(int)hits.size(); k++){
+		i = hits[k];
+		cx = d[0][i] + w[0][i] * t_min[i];
+		cy = d[1][i] + w[1][i] * t_min[i];
+		cz = d[2][i] + w[2][i] * t_min[i];
+		out[found].a = pa[i];
+		out[found].b = pb[i];
+		out[found].time_s = t_min[i];
+		out[found].horizontal_m = sqrtf(cx * cx + cy * cy) / 1000.0f;
+		out[found].vertical_m = fabsf(cz) / 1000.0f;
+		out[found].threat = t_min[i] < cfg->high_s ? MAV_COLLISION_THREAT_LEVEL_HIGH : MAV_COLLISION_THREAT_LEVEL_LOW;
+		found++;
+	}
+	return found;
+}
+
+
+int rc_collision_candidates()
+{
+	return num_candidates;
+}
+
+
+void rc_collision_reserve(int n)
+{
+	size_t pairs;
+	int k;
+
+	if(n < 0) return;
+	pairs = (size_t)n * RC_COLLISION_RESERVE_PAIRS;
+	for(k=0; k<3; k++){
+		lo[k].reserve(n);
+		hi[k].reserve(n);
+		sorted_lo[k].reserve(n);
+		sorted_hi[k].reserve(n);
+		d[k].reserve(pairs);
+		w[k].reserve(pairs);
+	}
+	order.reserve(n);
+	pa.reserve(pairs);
+	pb.reserve(pairs);
+	t_min.reserve(pairs);
+	d2_min.reserve(pairs);
+	hits.reserve(pairs);
+}
+
+
+void rc_collision_cleanup()
+{
+	int k;
+
+	for(k=0; k<3; k++){
+		lo[k].clear();
+		lo[k].shrink_to_fit();
+		hi[k].clear();
+		hi[k].shrink_to_fit();
+		d[k].clear();
+		d[k].shrink_to_fit();
+		w[k].clear();
+		w[k].shrink_to_fit();
+	}
+	order.clear();
+	order.shrink_to_fit();
+	for(k=0; k<3; k++){
+		sorted_lo[k].clear();
+		sorted_lo[k].shrink_to_fit();
+		sorted_hi[k].clear();
+		sorted_hi[k].shrink_to_fit();
+	}
+	pa.clear();
+	pa.shrink_to_fit();
+	pb.clear();
+	pb.shrink_to_fit();
+	t_min.clear();
+	t_min.shrink_to_fit();
+	hits.clear();
+	hits.shrink_to_fit();
+	d2_min.clear();
+	d2_min.shrink_to_fit();
+	num_candidates = 0;
+}
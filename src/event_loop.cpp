@@ -0,0 +1,383 @@
+/**
+ * @file event_loop.cpp
+ *
+ * @brief      Single-threaded reactor over epoll or WSAPoll. See event_loop.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include "../include/rc/event_loop.h"
+#ifndef _WIN32
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+typedef std::chrono::steady_clock loop_clock;
+
+typedef struct loop_socket_t{
+	int used;
+	rc_socket_t sock;
+	rc_loop_callback_t func;
+	void* ctx;
+} loop_socket_t;
+
+typedef struct loop_timer_t{
+	loop_clock::time_point next;
+	loop_clock::duration period;
+	rc_loop_callback_t func;
+	void* ctx;
+} loop_timer_t;
+
+static loop_socket_t sockets[RC_LOOP_MAX_SOCKETS];
+static loop_timer_t timers[RC_LOOP_MAX_TIMERS];
+static int num_timers;
+static rc_loop_callback_t wakeup_func;
+static void* wakeup_ctx;
+// set by the first rc_loop_wakeup after the last drain, later ones skip the syscall
+static std::atomic<int> wakeup_pending(0);
+static int initialized = 0;
+#ifdef _WIN32
+static rc_socket_t wake_sock = RC_INVALID_SOCKET;
+static WSAPOLLFD fds[RC_LOOP_MAX_SOCKETS + 1];
+#else
+static int epoll_fd = -1;
+static int wake_fd = -1;
+#endif
+
+
+// private local function declarations;
+static int __find(rc_socket_t sock);
+static int __wake_open();
+static void __wake_drain();
+static int __wait(int timeout_ms, int* ready, int max_ready);
+static int __run_timers(loop_clock::time_point now);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+static int __find(rc_socket_t sock)
+{
+	int i;
+
+	for(i=0; i<RC_LOOP_MAX_SOCKETS; i++){
+		if(sockets[i].used && sockets[i].sock == sock) return i;
+	}
+	return -1;
+}
+
+
+#ifdef _WIN32
+// WSAPoll only waits on sockets, so wakeups are datagrams a loopback socket
+// sends to itself
+static int __wake_open()
+{
+	struct sockaddr_in addr;
+	int len = sizeof(addr);
+
+	wake_sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if(wake_sock == RC_INVALID_SOCKET) return -1;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	if(bind(wake_sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+	   getsockname(wake_sock, (struct sockaddr*)&addr, &len) != 0 ||
+	   connect(wake_sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+	   rc_sock_set_nonblocking(wake_sock) < 0){
+		rc_sock_close(wake_sock);
+		wake_sock = RC_INVALID_SOCKET;
+		return -1;
+	}
+	return 0;
+}
+
+
+static void __wake_drain()
+{
+	char buf[16];
+	while(recv(wake_sock, buf, sizeof(buf), 0) > 0);
+}
+
+
+// fds[0] is the wakeup socket, ready gets slot indices or -1 for it
+static int __wait(int timeout_ms, int* ready, int max_ready)
+{
+	int slot[RC_LOOP_MAX_SOCKETS + 1];
+	int i, n = 1, ret, count = 0;
+
+	fds[0].fd = wake_sock;
+	fds[0].events = POLLRDNORM;
+	fds[0].revents = 0;
+	slot[0] = -1;
+	for(i=0; i<RC_LOOP_MAX_SOCKETS; i++){
+		if(!sockets[i].used) continue;
+		fds[n].fd = sockets[i].sock;
+		fds[n].events = POLLRDNORM;
+		fds[n].revents = 0;
+		slot[n++] = i;
+	}
+	ret = WSAPoll(fds, n, timeout_ms);
+	if(ret < 0){
+		fprintf(stderr, "ERROR: in rc_loop_run_once, WSAPoll failed with %d\n", WSAGetLastError());
+		return -1;
+	}
+	for(i=0; i<n && count<max_ready; i++){
+		if(fds[i].revents) ready[count++] = slot[i];
+	}
+	return count;
+}
+
+#else
+
+static int __wake_open()
+{
+	struct epoll_event ev;
+
+	wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(wake_fd < 0) return -1;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u32 = (uint32_t)-1;
+	if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) != 0){
+		close(wake_fd);
+		wake_fd = -1;
+		return -1;
+	}
+	return 0;
+}
+
+
+static void __wake_drain()
+{
+	uint64_t count;
+	while(read(wake_fd, &count, sizeof(count)) > 0);
+}
+
+
+// ready gets slot indices or -1 for the eventfd
+static int __wait(int timeout_ms, int* ready, int max_ready)
+{
+	struct epoll_event evs[RC_LOOP_MAX_SOCKETS + 1];
+	int i, ret;
+
+	ret = epoll_wait(epoll_fd, evs, max_ready, timeout_ms);
+	if(ret < 0){
+		// a signal, such as ctrl-c, only ends the wait early
+		if(errno == EINTR) return 0;
+		perror("ERROR: in rc_loop_run_once, epoll_wait failed");
+		return -1;
+	}
+	for(i=0; i<ret; i++) ready[i] = (int)evs[i].data.u32;
+	return ret;
+}
+#endif
+
+
+// late timers run once and are rescheduled a period from now
+static int __run_timers(loop_clock::time_point now)
+{
+	int i, ran = 0;
+
+	for(i=0; i<num_timers; i++){
+		if(timers[i].next > now) continue;
+		timers[i].next += timers[i].period;
+		if(timers[i].next <= now) timers[i].next = now + timers[i].period;
+		timers[i].func(timers[i].ctx);
+		ran++;
+	}
+	return ran;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR event_loop.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_loop_init(rc_loop_callback_t on_wakeup, void* ctx)
+{
+	if(initialized){
+		fprintf(stderr, "ERROR: in rc_loop_init, already initialized\n");
+		return -1;
+	}
+	if(rc_net_init() < 0){
+		fprintf(stderr, "ERROR: in rc_loop_init, failed to start sockets\n");
+		return -1;
+	}
+#ifndef _WIN32
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if(epoll_fd < 0){
+		perror("ERROR: in rc_loop_init, epoll_create1 failed");
+		return -1;
+	}
+#endif
+	if(__wake_open() < 0){
+		fprintf(stderr, "ERROR: in rc_loop_init, failed to create the wakeup\n");
+#ifndef _WIN32
+		close(epoll_fd);
+		epoll_fd = -1;
+#endif
+		rc_net_cleanup();
+		return -1;
+	}
+	memset(sockets, 0, sizeof(sockets));
+	num_timers = 0;
+	wakeup_func = on_wakeup;
+	wakeup_ctx = ctx;
+	wakeup_pending.store(0);
+	initialized = 1;
+	return 0;
+}
+
+
+int rc_loop_add_socket(rc_socket_t sock, rc_loop_callback_t on_readable, void* ctx)
+{
+	int i;
+
+	if(!initialized || on_readable == NULL){
+		fprintf(stderr, "ERROR: in rc_loop_add_socket, loop not initialized or no callback\n");
+		return -1;
+	}
+	if(__find(sock) >= 0){
+		fprintf(stderr, "ERROR: in rc_loop_add_socket, socket already added\n");
+		return -1;
+	}
+	for(i=0; i<RC_LOOP_MAX_SOCKETS && sockets[i].used; i++);
+	if(i == RC_LOOP_MAX_SOCKETS){
+		fprintf(stderr, "ERROR: in rc_loop_add_socket, more than %d sockets\n", RC_LOOP_MAX_SOCKETS);
+		return -1;
+	}
+#ifndef _WIN32
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u32 = (uint32_t)i;
+	if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &ev) != 0){
+		perror("ERROR: in rc_loop_add_socket, epoll_ctl failed");
+		return -1;
+	}
+#endif
+	sockets[i].sock = sock;
+	sockets[i].func = on_readable;
+	sockets[i].ctx = ctx;
+	sockets[i].used = 1;
+	return 0;
+}
+
+
+int rc_loop_remove_socket(rc_socket_t sock)
+{
+	int i = __find(sock);
+
+	if(i < 0) return -1;
+#ifndef _WIN32
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, sock, NULL);
+#endif
+	sockets[i].used = 0;
+	return 0;
+}
+
+
+int rc_loop_add_timer(uint32_t period_usec, rc_loop_callback_t on_timer, void* ctx)
+{
+	if(!initialized || on_timer == NULL){
+		fprintf(stderr, "ERROR: in rc_loop_add_timer, loop not initialized or no callback\n");
+		return -1;
+	}
+	// the waits are in milliseconds
+	if(period_usec < 1000){
+		fprintf(stderr, "ERROR: in rc_loop_add_timer, period must be at least 1000us\n");
+		return -1;
+	}
+	if(num_timers == RC_LOOP_MAX_TIMERS){
+		fprintf(stderr, "ERROR: in rc_loop_add_timer, more than %d timers\n", RC_LOOP_MAX_TIMERS);
+		return -1;
+	}
+	timers[num_timers].period = std::chrono::duration_cast<loop_clock::duration>(
+					std::chrono::microseconds(period_usec));
+	timers[num_timers].next = loop_clock::now() + timers[num_timers].period;
+	timers[num_timers].func = on_timer;
+	timers[num_timers].ctx = ctx;
+	num_timers++;
+	return 0;
+}
+
+
+void rc_loop_wakeup()
+{
+	if(!initialized || wakeup_pending.exchange(1) != 0) return;
+#ifdef _WIN32
+	char c = 0;
+	send(wake_sock, &c, 1, 0);
+#else
+	uint64_t one = 1;
+	if(write(wake_fd, &one, sizeof(one)) < 0) wakeup_pending.store(0);
+#endif
+}
+
+
+int rc_loop_run_once(int timeout_ms)
+{
+	int ready[RC_LOOP_MAX_SOCKETS + 1];
+	int i, n, ran = 0;
+	loop_clock::time_point now;
+
+	if(!initialized){
+		fprintf(stderr, "ERROR: in rc_loop_run_once, loop not initialized\n");
+		return -1;
+	}
+
+	// never sleep past the next timer, rounding up so it is due on waking
+	now = loop_clock::now();
+	for(i=0; i<num_timers; i++){
+		long long ms = std::chrono::duration_cast<std::chrono::microseconds>(
+					timers[i].next - now).count();
+		ms = ms <= 0 ? 0 : (ms + 999) / 1000;
+		if(timeout_ms < 0 || ms < timeout_ms) timeout_ms = (int)ms;
+	}
+
+	n = __wait(timeout_ms, ready, RC_LOOP_MAX_SOCKETS + 1);
+	if(n < 0) return -1;
+	for(i=0; i<n; i++){
+		if(ready[i] < 0){
+			// clear before the callback so a wakeup during it isn't lost
+			__wake_drain();
+			wakeup_pending.store(0);
+			if(wakeup_func != NULL) wakeup_func(wakeup_ctx);
+			ran++;
+		}
+		// a callback may have removed a later socket
+		else if(sockets[ready[i]].used){
+			sockets[ready[i]].func(sockets[ready[i]].ctx);
+			ran++;
+		}
+	}
+	ran += __run_timers(loop_clock::now());
+	return ran;
+}
+
+
+void rc_loop_cleanup()
+{
+	if(!initialized) return;
+#ifdef _WIN32
+	rc_sock_close(wake_sock);
+	wake_sock = RC_INVALID_SOCKET;
+#else
+	close(wake_fd);
+	close(epoll_fd);
+	wake_fd = -1;
+	epoll_fd = -1;
+#endif
+	memset(sockets, 0, sizeof(sockets));
+	num_timers = 0;
+	initialized = 0;
+	rc_net_cleanup();
+}
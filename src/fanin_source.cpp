@@ -0,0 +1,312 @@
+/**
+ * @file fanin_source.cpp
+ *
+ * @brief      MocapSource merging several sources, one acquisition thread
+ *             each, into a single subject table. See mocap_source.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "../include/rc/status_display.h"
+#include "../include/rc/mocap_source.h"
+#include "../include/rc/realtime.h"
+
+#define STALE_USEC	100000	// ignore servers whose latest frame is older than this
+#define HANDOVER_MARGIN	0.1	// quality a new server needs over the current owner
+#define WAIT_MS		100	// report no frame after waiting this long
+
+// one merged server, latest and seq are shared with its acquisition thread
+typedef struct fanin_server_t{
+	MocapSource* source;
+	std::string name;
+	std::thread thread;
+	std::vector<uint64_t> latest;	// uint64_t keeps the frame 8 byte aligned
+	uint64_t seq;
+	std::atomic<int> reserve;	// subjects the thread reserves its source for, 0 for none
+	// only touched by the merging thread
+	std::vector<uint64_t> snap;
+	uint64_t snap_seq;
+	uint64_t time_usec;		// estimated capture time of snap
+} fanin_server_t;
+
+// a subject of the merged table, resolved by name
+typedef struct fanin_subject_t{
+	int owner;			// server the last pose came from, -1 for none
+	uint64_t last_usec;		// capture time of the last pose returned
+} fanin_subject_t;
+
+/**
+ * Merges the latest frame of every server whenever one of them delivers
+ */
+class FanInMocapSource : public MocapSource
+{
+public:
+	FanInMocapSource() : running(1), pending(0), ended(0), frames(0) {}
+	~FanInMocapSource();
+
+	void start(MocapSource** sources, const char** names, int n);
+	int next_frame(const rc_mocap_frame_t** frame);
+	void reserve(int max_subjects);
+
+private:
+	void acquire(fanin_server_t* server);
+	const rc_mocap_frame_t* merge();
+
+	std::vector<fanin_server_t*> servers;
+	std::atomic<int> running;
+	std::mutex lock;
+	std::condition_variable cv;
+	uint64_t pending;		// frames delivered since the last merge
+	int ended;			// servers that have run out of frames
+
+	std::unordered_map<std::string, int> by_name;
+	std::vector<fanin_subject_t> subjects;
+	std::vector<const rc_mocap_subject_t*> candidates;	// subject x server
+	std::vector<uint64_t> out;
+	uint64_t frames;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR FanInMocapSource
+////////////////////////////////////////////////////////////////////////////////
+
+FanInMocapSource::~FanInMocapSource()
+{
+	size_t i;
+
+	running.store(0);
+	for(i=0; i<servers.size(); i++){
+		if(servers[i]->thread.joinable()) servers[i]->thread.join();
+		delete servers[i]->source;
+		delete servers[i];
+	}
+}
+
+
+void FanInMocapSource::start(MocapSource** sources, const char** names, int n)
+{
+	int i;
+
+	for(i=0; i<n; i++){
+		fanin_server_t* s = new fanin_server_t;
+		s->source = sources[i];
+		s->name = names[i];
+		s->seq = 0;
+		s->reserve.store(0);
+		s->snap_seq = 0;
+		s->time_usec = 0;
+		servers.push_back(s);
+	}
+	for(i=0; i<n; i++){
+		servers[i]->thread = std::thread(&FanInMocapSource::acquire, this, servers[i]);
+	}
+}
+
+
+void FanInMocapSource::acquire(fanin_server_t* server)
+{
+	const rc_mocap_frame_t* f;
+	int n, ret;
+
+	rc_rt_enter(RC_RT_ACQUISITION);
+	while(running.load()){
+		// the source is only ever touched from this thread
+		n = server->reserve.exchange(0);
+		if(n > 0) server->source->reserve(n);
+		ret = server->source->next_frame(&f);
+		if(ret == RC_MOCAP_END) break;
+		if(ret != RC_MOCAP_FRAME) continue;
+		{
+			std::lock_guard<std::mutex> l(lock);
+			server->latest.assign((const uint64_t*)f, (const uint64_t*)f + (f->size + 7) / 8);
+			server->seq++;
+			pending++;
+		}
+		cv.notify_one();
+	}
+	{
+		std::lock_guard<std::mutex> l(lock);
+		ended++;
+	}
+	cv.notify_one();
+}
+
+
+int FanInMocapSource::next_frame(const rc_mocap_frame_t** frame)
+{
+	const rc_mocap_frame_t* f;
+	size_t i;
+
+	while(1){
+		{
+			std::unique_lock<std::mutex> l(lock);
+			if(!cv.wait_for(l, std::chrono::milliseconds(WAIT_MS),
+					[this]{ return pending > 0 || ended == (int)servers.size(); })){
+				return RC_MOCAP_NO_FRAME;
+			}
+			if(pending == 0) return RC_MOCAP_END;
+			pending = 0;
+			// copy out only the frames that changed, the rest are still current
+			for(i=0; i<servers.size(); i++){
+				fanin_server_t* s = servers[i];
+				if(s->seq == s->snap_seq) continue;
+				s->snap = s->latest;
+				s->snap_seq = s->seq;
+			}
+		}
+		f = merge();
+		// a server catching up with poses already passed on adds nothing
+		if(f->subject_count > 0 || subjects.empty()) break;
+	}
+	*frame = f;
+	return RC_MOCAP_FRAME;
+}
+
+
+void FanInMocapSource::reserve(int max_subjects)
+{
+	size_t words, i;
+
+	if(max_subjects <= 0) return;
+	words = (rc_mocap_frame_size(max_subjects) + 7) / 8;
+	{
+		std::lock_guard<std::mutex> l(lock);
+		for(i=0; i<servers.size(); i++) servers[i]->latest.reserve(words);
+	}
+	for(i=0; i<servers.size(); i++){
+		servers[i]->snap.reserve(words);
+		servers[i]->reserve.store(max_subjects);
+	}
+	by_name.reserve(max_subjects);
+	subjects.reserve(max_subjects);
+	candidates.reserve((size_t)max_subjects * servers.size());
+	out.reserve(words);
+}
+
+
+const rc_mocap_frame_t* FanInMocapSource::merge()
+{
+	const size_t n = servers.size();
+	const rc_mocap_frame_t* f;
+	const rc_mocap_frame_t* newest_frame = NULL;
+	const rc_mocap_subject_t* subj;
+	const rc_mocap_subject_t* c;
+	rc_mocap_frame_t* o;
+	rc_mocap_subject_t* os;
+	uint64_t newest = 0, arrival = 0;
+	double latency = 0.0;
+	uint32_t count = 0;
+	size_t i, m;
+	int best, owner;
+
+	// a server's frame time is its arrival minus the latency its SDK reports
+	for(i=0; i<n; i++){
+		fanin_server_t* s = servers[i];
+		if(s->snap.empty()) continue;
+		f = (const rc_mocap_frame_t*)s->snap.data();
+		s->time_usec = f->capture_usec - (uint64_t)(f->latency_s * 1e6);
+		if(s->time_usec > newest){
+			newest = s->time_usec;
+			newest_frame = f;
+		}
+	}
+
+	// gather every fresh server's view of each subject
+	std::fill(candidates.begin(), candidates.end(), (const rc_mocap_subject_t*)NULL);
+	for(i=0; i<n; i++){
+		fanin_server_t* s = servers[i];
+		if(s->snap.empty()) continue;
+		f = (const rc_mocap_frame_t*)s->snap.data();
+		rc_display_publish_server((int)i, s->name.c_str(), f->frame_number,
+			(double)(newest - s->time_usec) / 1e6, f->latency_s);
+		if(newest - s->time_usec > STALE_USEC) continue;
+
+		subj = rc_mocap_frame_subjects(f);
+		for(uint32_t j=0; j<f->subject_count; j++){
+			auto it = by_name.find(subj[j].name);
+			if(it == by_name.end()){
+				it = by_name.emplace(subj[j].name, (int)subjects.size()).first;
+				fanin_subject_t fresh = {-1, 0};
+				subjects.push_back(fresh);
+				candidates.resize(subjects.size() * n, NULL);
+			}
+			candidates[it->second * n + i] = &subj[j];
+		}
+	}
+
+	out.resize((rc_mocap_frame_size((uint32_t)subjects.size()) + 7) / 8);
+	o = (rc_mocap_frame_t*)out.data();
+	os = (rc_mocap_subject_t*)(o + 1);
+	for(m=0; m<subjects.size(); m++){
+		const rc_mocap_subject_t** cand = &candidates[m * n];
+
+		// stay with the owner unless another server sees the subject clearly better
+		owner = subjects[m].owner;
+		best = (owner >= 0 && cand[owner] != NULL && !cand[owner]->occluded) ? owner : -1;
+		for(i=0; i<n; i++){
+			c = cand[i];
+			if(c == NULL || c->occluded || (int)i == best) continue;
+			if(best < 0 || c->quality > cand[best]->quality + (best == owner ? HANDOVER_MARGIN : 0.0)){
+				best = (int)i;
+			}
+		}
+		// everyone has it occluded, pass on the owner's pose as the SDK would
+		if(best < 0){
+			if(owner >= 0 && cand[owner] != NULL) best = owner;
+			else for(i=0; i<n && best < 0; i++) if(cand[i] != NULL) best = (int)i;
+		}
+		if(best < 0) continue;
+
+		// only pass on poses newer than the last one for this subject
+		if(servers[best]->time_usec <= subjects[m].last_usec) continue;
+		subjects[m].owner = best;
+		subjects[m].last_usec = servers[best]->time_usec;
+
+		os[count] = *cand[best];
+		os[count].index = (uint16_t)m;
+		os[count].source = (uint16_t)best;
+		count++;
+		f = (const rc_mocap_frame_t*)servers[best]->snap.data();
+		if(f->capture_usec > arrival) arrival = f->capture_usec;
+		if(f->latency_s > latency) latency = f->latency_s;
+	}
+
+	o->size = rc_mocap_frame_size(count);
+	o->subject_count = count;
+	o->frame_number = ++frames;
+	o->capture_usec = arrival;
+	o->latency_s = latency;
+	if(newest_frame != NULL) o->timecode = newest_frame->timecode;
+	else memset(&o->timecode, 0, sizeof(o->timecode));
+	return o;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR mocap_source.h
+////////////////////////////////////////////////////////////////////////////////
+
+MocapSource* rc_mocap_fanin_source_create(MocapSource** sources, const char** names, int n)
+{
+	FanInMocapSource* source;
+
+	if(n < 1 || n > RC_MOCAP_MAX_SOURCES){
+		fprintf(stderr, "ERROR: in rc_mocap_fanin_source_create, n must be between 1 and %d\n", RC_MOCAP_MAX_SOURCES);
+		return NULL;
+	}
+	source = new FanInMocapSource;
+	source->start(sources, names, n);
+	return source;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file flight_recorder.cpp
+ *
+ * @brief      Binary flight recorder of every packet the bridge sends. See
+ *             flight_recorder.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../include/rc/mavlink/mavlink_types.h"
+#include "../include/rc/flight_recorder.h"
+
+#define BLOCK_SIZE	(1024*1024)	// bytes per write
+#define BLOCK_ALIGN	4096
+#define IDLE_SLEEP_US	500		// writer sleep when the ring is empty
+#define IDLE_FLUSH_MS	200		// flush a partial block after this long idle
+#define TLOG_STAMP_LEN	8
+
+typedef struct recorder_slot_t{
+	std::atomic<size_t> seq;
+	uint64_t time_usec;
+	uint16_t len;
+	uint8_t data[MAVLINK_MAX_PACKET_LEN];
+} recorder_slot_t;
+
+static recorder_slot_t* ring = NULL;
+static size_t ring_mask;
+static std::atomic<size_t> enqueue_pos(0);
+static size_t dequeue_pos;
+
+static std::atomic<int> running(0);	// writer keeps draining while set
+static std::atomic<int> accepting(0);	// rc_recorder_push takes packets while set
+static std::atomic<int> pushing(0);	// rc_recorder_push calls that may touch the ring
+static std::thread writer_thread;
+static std::atomic<uint64_t> written(0);
+static std::atomic<uint64_t> dropped(0);
+
+static char file_prefix[256];
+static int file_index;
+static FILE* file = NULL;
+static int open_failed;		// the last rotation couldn't open its file
+static size_t file_bytes;
+static size_t rotate_at;
+static uint8_t* block_mem = NULL;
+static uint8_t* block;
+static size_t block_used;
+
+
+// private local function declarations;
+static int __open_next_file();
+static int __flush_block();
+static void __append(const uint8_t* data, size_t len);
+static int __write_record(const recorder_slot_t* slot);
+static int __drain();
+static void __writer_loop();
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// retried on every record after a failure, only the first one is reported
+static int __open_next_file()
+{
+	char path[300];
+	if(file != NULL) fclose(file);
+	snprintf(path, sizeof(path), "%s_%04d.tlog", file_prefix, file_index);
+	file = fopen(path, "wb");
+	if(file == NULL){
+		if(!open_failed) fprintf(stderr, "ERROR: in flight recorder, failed to open %s, dropping packets\n", path);
+		open_failed = 1;
+		return -1;
+	}
+	if(open_failed) fprintf(stderr, "flight recorder resumed in %s\n", path);
+	open_failed = 0;
+	file_index++;
+	// we only ever write whole blocks, stdio buffering would just add a copy
+	setvbuf(file, NULL, _IONBF, 0);
+	file_bytes = 0;
+	return 0;
+}
+
+
+static int __flush_block()
+{
+	if(block_used == 0) return 0;
+	// nothing is appended while a rotation has no file
+	if(file == NULL){
+		block_used = 0;
+		return -1;
+	}
+	if(fwrite(block, 1, block_used, file) != block_used){
+		fprintf(stderr, "ERROR: in flight recorder, write failed\n");
+		block_used = 0;
+		return -1;
+	}
+	file_bytes += block_used;
+	block_used = 0;
+	return 0;
+}
+
+
+// records may straddle blocks so that every write but the last is full size
+static void __append(const uint8_t* data, size_t len)
+{
+	size_t n;
+	while(len > 0){
+		n = BLOCK_SIZE - block_used;
+		if(n > len) n = len;
+		memcpy(block + block_used, data, n);
+		block_used += n;
+		data += n;
+		len -= n;
+		if(block_used == BLOCK_SIZE) __flush_block();
+	}
+}
+
+
+static int __write_record(const recorder_slot_t* slot)
+{
+	uint8_t stamp[TLOG_STAMP_LEN];
+	int i;
+
+	// rotate only on record boundaries so every file is a valid tlog
+	if(file == NULL ||
+	   (rotate_at > 0 && file_bytes + block_used + TLOG_STAMP_LEN + slot->len > rotate_at)){
+		__flush_block();
+		if(__open_next_file()) return -1;
+	}
+	for(i=0; i<TLOG_STAMP_LEN; i++){
+		stamp[i] = (uint8_t)(slot->time_usec >> (8*(TLOG_STAMP_LEN-1-i)));
+	}
+	__append(stamp, TLOG_STAMP_LEN);
+	__append(slot->data, slot->len);
+	return 0;
+}
+
+
+// consumes everything currently in the ring, returns number of packets
+static int __drain()
+{
+	recorder_slot_t* slot;
+	int n = 0;
+	int w = 0;
+
+	for(;;){
+		slot = &ring[dequeue_pos & ring_mask];
+		if(slot->seq.load(std::memory_order_acquire) != dequeue_pos + 1) break;
+		if(__write_record(slot) == 0) w++;
+		else dropped.fetch_add(1, std::memory_order_relaxed);
+		// hand the slot back to producers one lap ahead
+		slot->seq.store(dequeue_pos + ring_mask + 1, std::memory_order_release);
+		dequeue_pos++;
+		n++;
+	}
+	written.fetch_add(w, std::memory_order_relaxed);
+	return n;
+}
+
+
+static void __writer_loop()
+{
+	auto last_data = std::chrono::steady_clock::now();
+
+	while(running.load(std::memory_order_acquire)){
+		if(__drain() > 0){
+			last_data = std::chrono::steady_clock::now();
+			continue;
+		}
+		// flush a partial block when traffic stops so an idle bridge's log is
+		// complete on disk
+		if(block_used > 0 && std::chrono::steady_clock::now() - last_data
+				> std::chrono::milliseconds(IDLE_FLUSH_MS)){
+			__flush_block();
+		}
+		std::this_thread::sleep_for(std::chrono::microseconds(IDLE_SLEEP_US));
+	}
+	__drain();
+	__flush_block();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR flight_recorder.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_recorder_start(const char* prefix, size_t slots, size_t rotate_bytes)
+{
+	size_t size = 2;
+	size_t i;
+
+	if(running.load()){
+		fprintf(stderr, "ERROR: in rc_recorder_start, recorder already running\n");
+		return -1;
+	}
+	if(prefix == NULL || strlen(prefix) >= sizeof(file_prefix) || slots < 1){
+		fprintf(stderr, "ERROR: in rc_recorder_start, invalid arguments\n");
+		return -1;
+	}
+	while(size < slots) size <<= 1;
+
+	strcpy(file_prefix, prefix);
+	file_index = 0;
+	rotate_at = rotate_bytes;
+	open_failed = 0;
+	if(__open_next_file()) return -1;
+
+	ring = new recorder_slot_t[size];
+	for(i=0; i<size; i++) ring[i].seq.store(i, std::memory_order_relaxed);
+	ring_mask = size - 1;
+	enqueue_pos.store(0);
+	dequeue_pos = 0;
+
+	block_mem = (uint8_t*)malloc(BLOCK_SIZE + BLOCK_ALIGN);
+	block = (uint8_t*)(((uintptr_t)block_mem + BLOCK_ALIGN - 1) & ~(uintptr_t)(BLOCK_ALIGN - 1));
+	block_used = 0;
+
+	written.store(0);
+	dropped.store(0);
+	running.store(1, std::memory_order_release);
+	writer_thread = std::thread(__writer_loop);
+	accepting.store(1);
+	return 0;
+}
+
+
+int rc_recorder_is_running()
+{
+	return running.load(std::memory_order_relaxed);
+}
+
+
+int rc_recorder_push(uint64_t time_usec, const uint8_t* buf, int len)
+{
+	recorder_slot_t* slot;
+	size_t pos, seq;
+	intptr_t diff;
+
+	if(len < 0 || len > MAVLINK_MAX_PACKET_LEN) return -1;
+	// counted before accepting is checked, both sequentially consistent, so
+	// rc_recorder_stop either sees this call or this call sees it stopping
+	pushing.fetch_add(1);
+	if(!accepting.load()){
+		pushing.fetch_sub(1);
+		return -1;
+	}
+
+	// claim a slot, bounded MPMC queue after Dmitry Vyukov
+	pos = enqueue_pos.load(std::memory_order_relaxed);
+	for(;;){
+		slot = &ring[pos & ring_mask];
+		seq = slot->seq.load(std::memory_order_acquire);
+		diff = (intptr_t)seq - (intptr_t)pos;
+		if(diff == 0){
+			if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if(diff < 0){
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			pushing.fetch_sub(1, std::memory_order_release);
+			return -1;
+		}
+		else{
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->time_usec = time_usec;
+	slot->len = (uint16_t)len;
+	memcpy(slot->data, buf, len);
+	slot->seq.store(pos + 1, std::memory_order_release);
+	pushing.fetch_sub(1, std::memory_order_release);
+	return 0;
+}
+
+
+int rc_recorder_stop()
+{
+	if(!accepting.exchange(0)) return -1;
+	// pushes already past the accepting check publish their slot, and only
+	// then is the writer told to do its last drain
+	while(pushing.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+	running.store(0, std::memory_order_release);
+	writer_thread.join();
+	if(file != NULL) fclose(file);
+	file = NULL;
+	delete[] ring;
+	ring = NULL;
+	free(block_mem);
+	block_mem = NULL;
+	return 0;
+}
+
+
+uint64_t rc_recorder_written()
+{
+	return written.load(std::memory_order_relaxed);
+}
+
+
+uint64_t rc_recorder_dropped()
+{
+	return dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file geodetic.cpp
+ *
+ * @brief      NED to WGS84 through a second order expansion around the
+ *             origin. See geodetic.h
+ *
+ * @date       10/18/2026
+ */
+
+#define _USE_MATH_DEFINES	// for M_PI
+#include <stdint.h>	// for specific integer types
+#include <math.h>
+#include "../include/rc/geodetic.h"
+
+#define WGS84_A		6378137.0		// equatorial radius, meters
+#define WGS84_E2	6.69437999014e-3	// first eccentricity squared
+#define LLA_ITERATIONS	8	// each gains a factor of about WGS84_E2
+#define FIT_STEP_M	100.0	// of the finite differences
+
+// terms of the expansion, in this order, times the coefficients
+enum { T_N, T_E, T_D, T_NN, T_EE, T_DD, T_NE, T_ND, T_ED, NUM_TERMS };
+
+static double origin[3] = {0.0, 0.0, 0.0};
+static int fitted = 0;
+// origin in earth centered coordinates and the north, east and down axes
+static double origin_ecef[3];
+static double axes[3][3];
+// degrees of latitude and longitude and meters of altitude per term
+static double coef[3][NUM_TERMS];
+
+
+// private local function declarations;
+static void __ecef(double lat_deg, double lon_deg, double alt_m, double xyz[3]);
+static void __lla(const double xyz[3], double lla[3]);
+static void __delta(double n, double e, double d, double out[3]);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static void __ecef(double lat_deg, double lon_deg, double alt_m, double xyz[3])
+{
+	double lat = lat_deg * M_PI / 180.0;
+	double lon = lon_deg * M_PI / 180.0;
+	double s = sin(lat);
+	double n = WGS84_A / sqrt(1.0 - WGS84_E2 * s * s);
+
+	xyz[0] = (n + alt_m) * cos(lat) * cos(lon);
+	xyz[1] = (n + alt_m) * cos(lat) * sin(lon);
+	xyz[2] = (n * (1.0 - WGS84_E2) + alt_m) * s;
+}
+
+
+// fixed point on the latitude, then the altitude measured along the normal
+// so it holds up at the poles too
+static void __lla(const double xyz[3], double lla[3])
+{
+	double p = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+	double lat = atan2(xyz[2], p * (1.0 - WGS84_E2));
+	double s, n, alt = 0.0;
+	int i;
+
+	for(i=0; i<LLA_ITERATIONS; i++){
+		s = sin(lat);
+		n = WGS84_A / sqrt(1.0 - WGS84_E2 * s * s);
+		alt = p * cos(lat) + xyz[2] * s - WGS84_A * sqrt(1.0 - WGS84_E2 * s * s);
+		lat = atan2(xyz[2], p * (1.0 - WGS84_E2 * n / (n + alt)));
+	}
+	s = sin(lat);
+	lla[0] = lat * 180.0 / M_PI;
+	lla[1] = atan2(xyz[1], xyz[0]) * 180.0 / M_PI;
+	lla[2] = p * cos(lat) + xyz[2] * s - WGS84_A * sqrt(1.0 - WGS84_E2 * s * s);
+}
+
+
+// exact change from the origin, longitude kept continuous across 180
+static void __delta(double n, double e, double d, double out[3])
+{
+	double ned[3] = {n, e, d};
+	double lla[3];
+	int k;
+
+	rc_geo_exact(ned, lla);
+	for(k=0; k<3; k++) out[k] = lla[k] - origin[k];
+	out[1] = remainder(out[1], 360.0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR geodetic.h
+////////////////////////////////////////////////////////////////////////////////
+
+void rc_geo_set_origin(double lat_deg, double lon_deg, double alt_m)
+{
+	const double h = FIT_STEP_M;
+	double lat = lat_deg * M_PI / 180.0;
+	double lon = lon_deg * M_PI / 180.0;
+	double f0[3], fp[3], fm[3], fpp[3], fpm[3], fmp[3], fmm[3];
+	double step[3][3] = {{h, 0.0, 0.0}, {0.0, h, 0.0}, {0.0, 0.0, h}};
+	static const int cross[3][3] = {{T_NE, 0, 1}, {T_ND, 0, 2}, {T_ED, 1, 2}};
+	int i, j, k, a, b;
+
+	if(fitted && lat_deg == origin[0] && lon_deg == origin[1] && alt_m == origin[2]) return;
+	origin[0] = lat_deg;
+	origin[1] = lon_deg;
+	origin[2] = alt_m;
+	__ecef(lat_deg, lon_deg, alt_m, origin_ecef);
+	axes[0][0] = -sin(lat) * cos(lon);	axes[0][1] = -sin(lat) * sin(lon);	axes[0][2] = cos(lat);
+	axes[1][0] = -sin(lon);			axes[1][1] = cos(lon);			axes[1][2] = 0.0;
+	axes[2][0] = -cos(lat) * cos(lon);	axes[2][1] = -cos(lat) * sin(lon);	axes[2][2] = -sin(lat);
+
+	// central differences, exact for the quadratic part
+	__delta(0.0, 0.0, 0.0, f0);
+	for(i=0; i<3; i++){
+		__delta(step[i][0], step[i][1], step[i][2], fp);
+		__delta(-step[i][0], -step[i][1], -step[i][2], fm);
+		for(k=0; k<3; k++){
+			coef[k][T_N + i] = (fp[k] - fm[k]) / (2.0 * h);
+			coef[k][T_NN + i] = (fp[k] - 2.0 * f0[k] + fm[k]) / (2.0 * h * h);
+		}
+	}
+	for(j=0; j<3; j++){
+		a = cross[j][1];
+		b = cross[j][2];
+		__delta(step[a][0] + step[b][0], step[a][1] + step[b][1], step[a][2] + step[b][2], fpp);
+		__delta(step[a][0] - step[b][0], step[a][1] - step[b][1], step[a][2] - step[b][2], fpm);
+		__delta(step[b][0] - step[a][0], step[b][1] - step[a][1], step[b][2] - step[a][2], fmp);
+		__delta(-step[a][0] - step[b][0], -step[a][1] - step[b][1], -step[a][2] - step[b][2], fmm);
+		for(k=0; k<3; k++) coef[k][cross[j][0]] = (fpp[k] - fpm[k] - fmp[k] + fmm[k]) / (4.0 * h * h);
+	}
+	fitted = 1;
+}
+
+
+void rc_geo_origin(double* lat_deg, double* lon_deg, double* alt_m)
+{
+	*lat_deg = origin[0];
+	*lon_deg = origin[1];
+	*alt_m = origin[2];
+}
+
+
+void rc_geo_from_ned(const float* n, const float* e, const float* d, int count,
+			double* lat_deg, double* lon_deg, double* alt_m)
+{
+	double x, y, z, xx, yy, zz, xy, xz, yz;
+	double c[3][NUM_TERMS];
+	int i, k, t;
+
+	if(!fitted) rc_geo_set_origin(0.0, 0.0, 0.0);
+	// a local copy the compiler knows nothing else writes to, and no
+	// branches, so it vectorizes
+	for(k=0; k<3; k++) for(t=0; t<NUM_TERMS; t++) c[k][t] = coef[k][t];
+	for(i=0; i<count; i++){
+		x = n[i];
+		y = e[i];
+		z = d[i];
+		xx = x * x;
+		yy = y * y;
+		zz = z * z;
+		xy = x * y;
+		xz = x * z;
+		yz = y * z;
+		lat_deg[i] = origin[0] + c[0][T_N] * x + c[0][T_E] * y + c[0][T_D] * z + c[0][T_NN] * xx
+			+ c[0][T_EE] * yy + c[0][T_DD] * zz + c[0][T_NE] * xy + c[0][T_ND] * xz + c[0][T_ED] * yz;
+		lon_deg[i] = origin[1] + c[1][T_N] * x + c[1][T_E] * y + c[1][T_D] * z + c[1][T_NN] * xx
+			+ c[1][T_EE] * yy + c[1][T_DD] * zz + c[1][T_NE] * xy + c[1][T_ND] * xz + c[1][T_ED] * yz;
+		alt_m[i] = origin[2] + c[2][T_N] * x + c[2][T_E] * y + c[2][T_D] * z + c[2][T_NN] * xx
+			+ c[2][T_EE] * yy + c[2][T_DD] * zz + c[2][T_NE] * xy + c[2][T_ND] * xz + c[2][T_ED] * yz;
+	}
+}
+
+
+void rc_geo_point(const float ned[3], double lla[3])
+{
+	rc_geo_from_ned(&ned[0], &ned[1], &ned[2], 1, &lla[0], &lla[1], &lla[2]);
+}
+
+
+void rc_geo_exact(const double ned[3], double lla[3])
+{
+	double xyz[3];
+	int k;
+
+	for(k=0; k<3; k++){
+		xyz[k] = origin_ecef[k] + ned[0] * axes[0][k] + ned[1] * axes[1][k] + ned[2] * axes[2][k];
+	}
+	__lla(xyz, lla);
+}
+
+
+int32_t rc_geo_e7(double deg)
+{
+	deg = remainder(deg, 360.0);
+	return (int32_t)llround(deg * 1e7);
+}
@@ -0,0 +1,281 @@
+/**
+ * @file latency_stats.cpp
+ *
+ * @brief      Low-overhead per-stage latency histograms for the bridge
+ *             pipeline. See latency_stats.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <atomic>
+#include <chrono>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "../include/rc/latency_stats.h"
+
+// values below 2*SUB_BUCKETS are stored exactly, above that each power of two
+// is split into SUB_BUCKETS linear buckets
+#define SUB_BITS	5
+#define SUB_BUCKETS	(1<<SUB_BITS)
+#define MAX_MSB		40	// ~18 minutes in ns, larger values are clamped
+#define NUM_BUCKETS	((MAX_MSB-SUB_BITS+2)*SUB_BUCKETS)
+
+typedef struct lat_histogram_t{
+	std::atomic<uint32_t> bucket[NUM_BUCKETS];
+	std::atomic<uint64_t> count;
+	std::atomic<uint64_t> max;
+} lat_histogram_t;
+
+typedef struct lat_subject_t{
+	lat_histogram_t stage[RC_LAT_NUM_STAGES];
+} lat_subject_t;
+
+static int enabled = 0;
+static lat_histogram_t totals[RC_LAT_NUM_STAGES];
+static std::atomic<lat_subject_t*> subjects[RC_LAT_MAX_SUBJECTS];
+static thread_local int current_subject = RC_LAT_ALL_SUBJECTS;
+
+static const char* stage_names[RC_LAT_NUM_STAGES] = {
+	"acquire",
+	"extract",
+	"transform",
+	"pack",
+	"crc/sign",
+	"syscall"
+};
+
+
+// private local function declarations;
+static int __msb(uint64_t v);
+static int __bucket_index(uint64_t v);
+static double __bucket_value(int index);
+static void __hist_add(lat_histogram_t* h, uint64_t ns);
+static void __hist_clear(lat_histogram_t* h);
+static lat_histogram_t* __get_hist(rc_lat_stage_t stage, int subject, int create);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// index of the most significant set bit, v must be non-zero
+static int __msb(uint64_t v)
+{
+#ifdef _MSC_VER
+	unsigned long i;
+	_BitScanReverse64(&i, v);
+	return (int)i;
+#else
+	return 63 - __builtin_clzll(v);
+#endif
+}
+
+
+static int __bucket_index(uint64_t v)
+{
+	int shift;
+	if(v < 2*SUB_BUCKETS) return (int)v;
+	if(v >> (MAX_MSB+1)) return NUM_BUCKETS-1;
+	shift = __msb(v) - SUB_BITS;
+	return shift*SUB_BUCKETS + (int)(v >> shift);
+}
+
+
+// midpoint of the range of values that map to a bucket
+static double __bucket_value(int index)
+{
+	int shift;
+	if(index < 2*SUB_BUCKETS) return (double)index;
+	shift = index/SUB_BUCKETS - 1;
+	uint64_t low = (uint64_t)(index - shift*SUB_BUCKETS) << shift;
+	return (double)low + (double)(1ULL << shift) / 2.0;
+}
+
+
+static void __hist_add(lat_histogram_t* h, uint64_t ns)
+{
+	uint64_t m;
+	h->bucket[__bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+	h->count.fetch_add(1, std::memory_order_relaxed);
+	m = h->max.load(std::memory_order_relaxed);
+	while(ns > m && !h->max.compare_exchange_weak(m, ns, std::memory_order_relaxed));
+}
+
+
+static void __hist_clear(lat_histogram_t* h)
+{
+	int i;
+	for(i=0; i<NUM_BUCKETS; i++) h->bucket[i].store(0, std::memory_order_relaxed);
+	h->count.store(0, std::memory_order_relaxed);
+	h->max.store(0, std::memory_order_relaxed);
+}
+
+
+static lat_histogram_t* __get_hist(rc_lat_stage_t stage, int subject, int create)
+{
+	lat_subject_t* s;
+	lat_subject_t* expected = NULL;
+	int i;
+
+	if(stage < 0 || stage >= RC_LAT_NUM_STAGES) return NULL;
+	if(subject == RC_LAT_ALL_SUBJECTS) return &totals[stage];
+	if(subject < 0 || subject >= RC_LAT_MAX_SUBJECTS) return NULL;
+
+	s = subjects[subject].load(std::memory_order_acquire);
+	if(s != NULL || !create) return s ? &s->stage[stage] : NULL;
+
+	// first sample for this subject, racing threads agree on one allocation
+	s = new lat_subject_t;
+	for(i=0; i<RC_LAT_NUM_STAGES; i++) __hist_clear(&s->stage[i]);
+	if(!subjects[subject].compare_exchange_strong(expected, s, std::memory_order_acq_rel)){
+		delete s;
+		s = expected;
+	}
+	return &s->stage[stage];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR latency_stats.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_lat_init(int enable)
+{
+	enabled = enable ? 1 : 0;
+	return 0;
+}
+
+
+int rc_lat_is_enabled()
+{
+	return enabled;
+}
+
+
+uint64_t rc_lat_now()
+{
+	if(!enabled) return 0;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void rc_lat_set_subject(int subject)
+{
+	current_subject = subject;
+}
+
+
+int rc_lat_current_subject()
+{
+	return current_subject;
+}
+
+
+uint64_t rc_lat_record(rc_lat_stage_t stage, int subject, uint64_t start)
+{
+	uint64_t now;
+	if(!enabled) return 0;
+	now = rc_lat_now();
+	rc_lat_record_ns(stage, subject, now > start ? now - start : 0);
+	return now;
+}
+
+
+void rc_lat_record_ns(rc_lat_stage_t stage, int subject, uint64_t ns)
+{
+	lat_histogram_t* h;
+	if(!enabled || stage < 0 || stage >= RC_LAT_NUM_STAGES) return;
+	__hist_add(&totals[stage], ns);
+	if(subject == RC_LAT_ALL_SUBJECTS) return;
+	h = __get_hist(stage, subject, 1);
+	if(h != NULL) __hist_add(h, ns);
+}
+
+
+void rc_lat_reserve(int n)
+{
+	int i;
+
+	if(!enabled) return;
+	for(i=0; i<n && i<RC_LAT_MAX_SUBJECTS; i++) __get_hist(RC_LAT_ACQUIRE, i, 1);
+}
+
+
+double rc_lat_percentile(rc_lat_stage_t stage, int subject, double p)
+{
+	lat_histogram_t* h = __get_hist(stage, subject, 0);
+	uint64_t total, target, seen = 0;
+	int i;
+
+	if(h == NULL) return 0.0;
+	total = h->count.load(std::memory_order_relaxed);
+	if(total == 0) return 0.0;
+	if(p >= 100.0) return (double)h->max.load(std::memory_order_relaxed);
+	if(p < 0.0) p = 0.0;
+
+	target = (uint64_t)(p / 100.0 * (double)total);
+	if(target < 1) target = 1;
+	for(i=0; i<NUM_BUCKETS; i++){
+		seen += h->bucket[i].load(std::memory_order_relaxed);
+		if(seen >= target) return __bucket_value(i);
+	}
+	return (double)h->max.load(std::memory_order_relaxed);
+}
+
+
+uint64_t rc_lat_count(rc_lat_stage_t stage, int subject)
+{
+	lat_histogram_t* h = __get_hist(stage, subject, 0);
+	if(h == NULL) return 0;
+	return h->count.load(std::memory_order_relaxed);
+}
+
+
+const char* rc_lat_stage_name(rc_lat_stage_t stage)
+{
+	if(stage < 0 || stage >= RC_LAT_NUM_STAGES) return "unknown";
+	return stage_names[stage];
+}
+
+
+void rc_lat_print(FILE* f)
+{
+	int i, s;
+	rc_lat_stage_t stage;
+
+	fprintf(f, "\nlatency (us)      samples      p50      p90      p99    p99.9      max\n");
+	for(s=RC_LAT_ALL_SUBJECTS; s<RC_LAT_MAX_SUBJECTS; s++){
+		if(s != RC_LAT_ALL_SUBJECTS && subjects[s].load() == NULL) continue;
+		if(s == RC_LAT_ALL_SUBJECTS) fprintf(f, "all subjects\n");
+		else fprintf(f, "subject %d\n", s);
+		for(i=0; i<RC_LAT_NUM_STAGES; i++){
+			stage = (rc_lat_stage_t)i;
+			if(rc_lat_count(stage, s) == 0) continue;
+			fprintf(f, "  %-12s %12llu %8.2f %8.2f %8.2f %8.2f %8.2f\n",
+				rc_lat_stage_name(stage),
+				(unsigned long long)rc_lat_count(stage, s),
+				rc_lat_percentile(stage, s, 50.0) / 1000.0,
+				rc_lat_percentile(stage, s, 90.0) / 1000.0,
+				rc_lat_percentile(stage, s, 99.0) / 1000.0,
+				rc_lat_percentile(stage, s, 99.9) / 1000.0,
+				rc_lat_percentile(stage, s, 100.0) / 1000.0);
+		}
+	}
+	fflush(f);
+}
+
+
+void rc_lat_cleanup()
+{
+	int i;
+	for(i=0; i<RC_LAT_NUM_STAGES; i++) __hist_clear(&totals[i]);
+	for(i=0; i<RC_LAT_MAX_SUBJECTS; i++){
+		delete subjects[i].exchange(NULL);
+	}
+}
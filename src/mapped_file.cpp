@@ -0,0 +1,98 @@
+/**
+ * @file mapped_file.cpp
+ *
+ * @brief      Read-only memory mapping of whole files on Windows and POSIX.
+ *             See mapped_file.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "../include/rc/mapped_file.h"
+
+
+int rc_map_file(const char* path, rc_mapped_file_t* file)
+{
+	memset(file, 0, sizeof(*file));
+#ifdef _WIN32
+	HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+				OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	LARGE_INTEGER size;
+	if(f == INVALID_HANDLE_VALUE){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to open %s\n", path);
+		return -1;
+	}
+	if(!GetFileSizeEx(f, &size)){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to get size of %s\n", path);
+		CloseHandle(f);
+		return -1;
+	}
+	file->size = (size_t)size.QuadPart;
+	if(file->size == 0){
+		CloseHandle(f);
+		return 0;
+	}
+	HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(f);
+	if(m == NULL){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to map %s\n", path);
+		return -1;
+	}
+	file->data = (const uint8_t*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+	if(file->data == NULL){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to map %s\n", path);
+		CloseHandle(m);
+		return -1;
+	}
+	file->handle = m;
+#else
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+	if(fd < 0){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to open %s\n", path);
+		return -1;
+	}
+	if(fstat(fd, &st) < 0){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to get size of %s\n", path);
+		close(fd);
+		return -1;
+	}
+	file->size = (size_t)st.st_size;
+	if(file->size == 0){
+		close(fd);
+		return 0;
+	}
+	void* p = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED){
+		fprintf(stderr, "ERROR: in rc_map_file, failed to map %s\n", path);
+		return -1;
+	}
+	// logs are read front to back
+	madvise(p, file->size, MADV_SEQUENTIAL);
+	file->data = (const uint8_t*)p;
+#endif
+	return 0;
+}
+
+
+void rc_unmap_file(rc_mapped_file_t* file)
+{
+	if(file->data == NULL) return;
+#ifdef _WIN32
+	UnmapViewOfFile(file->data);
+	CloseHandle((HANDLE)file->handle);
+#else
+	munmap((void*)file->data, file->size);
+#endif
+	memset(file, 0, sizeof(*file));
+}
@@ -0,0 +1,409 @@
+/**
+ * @file mavlink_signing.cpp
+ *
+ * @brief      Per-destination MAVLink2 packet signing and a hash-indexed
+ *             signing-stream table. See mavlink_signing.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <ctype.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../include/rc/mavlink_signing.h"
+
+// seconds between the unix epoch and 1st January 2015 GMT
+#define SIGNING_EPOCH_OFFSET_S	1420070400ULL
+// new streams are accepted only if their timestamp is at most a minute old
+#define NEW_STREAM_MAX_AGE	(6000*1000ULL)
+#define DEST_TABLE_SIZE		(RC_MAV_SIGNING_MAX_DESTS*2)
+// slot taken by a new stream whose timestamp isn't stored yet, above any key
+#define STREAM_CLAIMED		0xFFFFFFFFU
+
+// key configured for one destination address
+typedef struct signing_dest_t{
+	int used;
+	uint32_t addr;
+	uint8_t link_id;
+	uint8_t key[RC_MAV_SIGNING_KEY_LEN];
+	std::atomic<uint64_t> timestamp;	// last timestamp used to sign
+} signing_dest_t;
+
+// open-addressed table of signing streams, slot key 0 means empty and
+// STREAM_CLAIMED that the key is about to be published
+static std::atomic<uint32_t>* stream_keys = NULL;
+static std::atomic<uint64_t>* stream_stamps = NULL;
+static uint32_t stream_mask;
+static int max_streams;
+static std::atomic<int> num_streams(0);
+
+static signing_dest_t dests[DEST_TABLE_SIZE];
+static int num_dests = 0;
+
+
+// private local function declarations;
+static uint32_t __hash32(uint32_t x);
+static int __parse_ipv4(const char* ip, uint32_t* addr);
+static signing_dest_t* __find_dest(uint32_t addr);
+static int __hex_nibble(char c);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// finalizer from murmur3, good avalanche for small sequential keys
+static uint32_t __hash32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+	return x;
+}
+
+
+// parses a dotted quad into an address in network byte order
+static int __parse_ipv4(const char* ip, uint32_t* addr)
+{
+	unsigned int b[4];
+	uint8_t bytes[4];
+	char tail;
+	int i;
+	if(ip == NULL) return -1;
+	if(sscanf(ip, "%u.%u.%u.%u%c", &b[0], &b[1], &b[2], &b[3], &tail) != 4) return -1;
+	for(i=0; i<4; i++){
+		if(b[i] > 255) return -1;
+		bytes[i] = (uint8_t)b[i];
+	}
+	memcpy(addr, bytes, 4);
+	return 0;
+}
+
+
+static signing_dest_t* __find_dest(uint32_t addr)
+{
+	uint32_t i = __hash32(addr) & (DEST_TABLE_SIZE-1);
+	while(dests[i].used){
+		if(dests[i].addr == addr) return &dests[i];
+		i = (i+1) & (DEST_TABLE_SIZE-1);
+	}
+	return NULL;
+}
+
+
+static int __hex_nibble(char c)
+{
+	if(c >= '0' && c <= '9') return c - '0';
+	if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR mavlink_signing.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_mav_signing_init(int max)
+{
+	uint32_t size = 16;
+	uint32_t i;
+
+	if(max < 1){
+		fprintf(stderr, "ERROR: in rc_mav_signing_init, max_streams must be >= 1\n");
+		return -1;
+	}
+	while(size < (uint32_t)max*2) size <<= 1;
+
+	delete[] stream_keys;
+	delete[] stream_stamps;
+	stream_keys = new std::atomic<uint32_t>[size];
+	stream_stamps = new std::atomic<uint64_t>[size];
+	for(i=0; i<size; i++){
+		stream_keys[i].store(0, std::memory_order_relaxed);
+		stream_stamps[i].store(0, std::memory_order_relaxed);
+	}
+	stream_mask = size - 1;
+	max_streams = max;
+	num_streams.store(0);
+	return 0;
+}
+
+
+int rc_mav_signing_set_key(const char* dest_ip, uint8_t link_id,
+			const uint8_t key[RC_MAV_SIGNING_KEY_LEN])
+{
+	uint32_t addr, i;
+	signing_dest_t* d;
+
+	if(key == NULL || __parse_ipv4(dest_ip, &addr)){
+		fprintf(stderr, "ERROR: in rc_mav_signing_set_key, invalid ip or key\n");
+		return -1;
+	}
+	d = __find_dest(addr);
+	if(d == NULL){
+		if(num_dests >= RC_MAV_SIGNING_MAX_DESTS){
+			fprintf(stderr, "ERROR: in rc_mav_signing_set_key, too many destinations\n");
+			return -1;
+		}
+		i = __hash32(addr) & (DEST_TABLE_SIZE-1);
+		while(dests[i].used) i = (i+1) & (DEST_TABLE_SIZE-1);
+		d = &dests[i];
+		d->used = 1;
+		d->addr = addr;
+		num_dests++;
+	}
+	d->link_id = link_id;
+	memcpy(d->key, key, RC_MAV_SIGNING_KEY_LEN);
+	d->timestamp.store(0);
+	return 0;
+}
+
+
+int rc_mav_signing_load_file(const char* path)
+{
+	FILE* f;
+	char line[256];
+	char ip[64];
+	char hex[128];
+	unsigned int link_id;
+	uint8_t key[RC_MAV_SIGNING_KEY_LEN];
+	int i, hi, lo, bad;
+	int line_num = 0;
+	int loaded = 0;
+
+	f = fopen(path, "r");
+	if(f == NULL) return -1;
+
+	while(fgets(line, sizeof(line), f) != NULL){
+		line_num++;
+		char* p = line;
+		while(isspace((unsigned char)*p)) p++;
+		if(*p == 0 || *p == '#') continue;
+
+		if(sscanf(p, "%63s %u %127s", ip, &link_id, hex) != 3 || link_id > 255
+				|| strlen(hex) != 2*RC_MAV_SIGNING_KEY_LEN){
+			fprintf(stderr, "WARNING: %s:%d malformed signing key line, skipping\n", path, line_num);
+			continue;
+		}
+		bad = 0;
+		for(i=0; i<RC_MAV_SIGNING_KEY_LEN; i++){
+			hi = __hex_nibble(hex[2*i]);
+			lo = __hex_nibble(hex[2*i+1]);
+			if(hi < 0 || lo < 0){
+				bad = 1;
+				break;
+			}
+			key[i] = (uint8_t)((hi << 4) | lo);
+		}
+		if(bad || rc_mav_signing_set_key(ip, (uint8_t)link_id, key)){
+			fprintf(stderr, "WARNING: %s:%d invalid signing key, skipping\n", path, line_num);
+			continue;
+		}
+		loaded++;
+	}
+	fclose(f);
+	return loaded;
+}
+
+
+int rc_mav_signing_num_dests()
+{
+	return num_dests;
+}
+
+
+int rc_mav_sign_msg(mavlink_message_t* msg, uint8_t link_id, uint64_t timestamp,
+			const uint8_t key[RC_MAV_SIGNING_KEY_LEN])
+{
+	uint8_t buf[MAVLINK_CORE_HEADER_LEN+1];
+	mavlink_signing_t signing;
+
+	if(msg->magic != MAVLINK_STX){
+		fprintf(stderr, "ERROR: in rc_mav_sign_msg, can't sign MAVLink1 packets\n");
+		return -1;
+	}
+
+	msg->incompat_flags |= MAVLINK_IFLAG_SIGNED;
+
+	// the incompat flags are covered by the crc so it must be recomputed
+	buf[0] = msg->magic;
+	buf[1] = msg->len;
+	buf[2] = msg->incompat_flags;
+	buf[3] = msg->compat_flags;
+	buf[4] = msg->seq;
+	buf[5] = msg->sysid;
+	buf[6] = msg->compid;
+	buf[7] = msg->msgid & 0xFF;
+	buf[8] = (msg->msgid >> 8) & 0xFF;
+	buf[9] = (msg->msgid >> 16) & 0xFF;
+
+	uint16_t checksum = crc_calculate(&buf[1], MAVLINK_CORE_HEADER_LEN);
+	crc_accumulate_buffer(&checksum, _MAV_PAYLOAD(msg), msg->len);
+	crc_accumulate(mavlink_get_crc_extra(msg), &checksum);
+	msg->checksum = checksum;
+	mavlink_ck_a(msg) = (uint8_t)(checksum & 0xFF);
+	mavlink_ck_b(msg) = (uint8_t)(checksum >> 8);
+
+	signing.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+	signing.link_id = link_id;
+	signing.timestamp = timestamp;
+	memcpy(signing.secret_key, key, RC_MAV_SIGNING_KEY_LEN);
+	signing.accept_unsigned_callback = NULL;
+
+	mavlink_sign_packet(&signing, msg->signature,
+				(const uint8_t *)buf, MAVLINK_CORE_HEADER_LEN+1,
+				(const uint8_t *)_MAV_PAYLOAD(msg), msg->len,
+				(const uint8_t *)_MAV_PAYLOAD(msg)+(uint16_t)msg->len);
+	return 0;
+}
+
+
+int rc_mav_signing_has_key(uint32_t dest_addr)
+{
+	if(num_dests == 0) return 0;
+	return __find_dest(dest_addr) != NULL;
+}
+
+
+int rc_mav_signing_sign(uint32_t dest_addr, mavlink_message_t* msg)
+{
+	signing_dest_t* d;
+	uint64_t now, last;
+
+	if(num_dests == 0) return 0;
+	d = __find_dest(dest_addr);
+	if(d == NULL) return 0;
+
+	// timestamps must be strictly increasing on a link even if several
+	// packets are signed within the same 10us tick
+	now = rc_mav_signing_timestamp_now();
+	last = d->timestamp.load(std::memory_order_relaxed);
+	do{
+		if(now <= last) now = last + 1;
+	}while(!d->timestamp.compare_exchange_weak(last, now, std::memory_order_relaxed));
+
+	if(rc_mav_sign_msg(msg, d->link_id, now, d->key)) return -1;
+	return 1;
+}
+
+
+int rc_mav_signing_verify(uint32_t src_addr, const mavlink_message_t* msg)
+{
+	signing_dest_t* d;
+	mavlink_sha256_ctx ctx;
+	const uint8_t* p = (const uint8_t*)&msg->magic;
+	const uint8_t* psig = msg->signature;
+	uint8_t signature[6];
+	uint8_t ck[2];
+	uint64_t timestamp = 0;
+	int i;
+
+	if(!(msg->incompat_flags & MAVLINK_IFLAG_SIGNED)) return -1;
+	d = __find_dest(src_addr);
+	if(d == NULL) return -1;
+
+	mavlink_sha256_init(&ctx);
+	mavlink_sha256_update(&ctx, d->key, RC_MAV_SIGNING_KEY_LEN);
+	mavlink_sha256_update(&ctx, p, MAVLINK_CORE_HEADER_LEN+1+msg->len);
+	// use checksum rather than ck[] which only the parser fills in
+	ck[0] = (uint8_t)(msg->checksum & 0xFF);
+	ck[1] = (uint8_t)(msg->checksum >> 8);
+	mavlink_sha256_update(&ctx, ck, 2);
+	mavlink_sha256_update(&ctx, psig, 1+6);
+	mavlink_sha256_final_48(&ctx, signature);
+	if(memcmp(signature, psig+7, 6) != 0) return -1;
+
+	// 48 bit little endian timestamp
+	for(i=5; i>=0; i--) timestamp = (timestamp << 8) | psig[1+i];
+	return rc_mav_signing_check_timestamp(psig[0], msg->sysid, msg->compid, timestamp);
+}
+
+
+int rc_mav_signing_check_timestamp(uint8_t link_id, uint8_t sysid,
+			uint8_t compid, uint64_t timestamp)
+{
+	uint32_t key, i, k;
+	uint64_t last;
+
+	if(stream_keys == NULL){
+		fprintf(stderr, "ERROR: in rc_mav_signing_check_timestamp, call rc_mav_signing_init first\n");
+		return -1;
+	}
+
+	// +1 so that the all-zero tuple doesn't collide with an empty slot
+	key = (((uint32_t)link_id << 16) | ((uint32_t)sysid << 8) | compid) + 1;
+	i = __hash32(key) & stream_mask;
+
+	for(;;){
+		k = stream_keys[i].load(std::memory_order_acquire);
+		if(k == STREAM_CLAIMED){
+			// its stamp is being stored, yield in case the claimer shares
+			// this core at the same SCHED_FIFO priority
+			std::this_thread::yield();
+			continue;
+		}
+		if(k == key) break;
+		if(k == 0){
+			// new stream. Only accept if timestamp is not more than 1 minute old
+			if(timestamp + NEW_STREAM_MAX_AGE < rc_mav_signing_timestamp_now()) return -1;
+			if(num_streams.fetch_add(1) >= max_streams){
+				num_streams.fetch_sub(1);
+				return -1;
+			}
+			// the stamp is stored before the key is published, so a
+			// verifier that finds the key never sees a stamp of 0
+			if(stream_keys[i].compare_exchange_strong(k, STREAM_CLAIMED, std::memory_order_acq_rel)){
+				stream_stamps[i].store(timestamp, std::memory_order_relaxed);
+				stream_keys[i].store(key, std::memory_order_release);
+				return 0;
+			}
+			// lost the slot to another thread, look at it again
+			num_streams.fetch_sub(1);
+			continue;
+		}
+		i = (i+1) & stream_mask;
+	}
+
+	// reject repeated or old timestamps
+	last = stream_stamps[i].load(std::memory_order_acquire);
+	do{
+		if(timestamp <= last) return -1;
+	}while(!stream_stamps[i].compare_exchange_weak(last, timestamp, std::memory_order_acq_rel));
+	return 0;
+}
+
+
+int rc_mav_signing_num_streams()
+{
+	return num_streams.load();
+}
+
+
+uint64_t rc_mav_signing_timestamp_now()
+{
+	uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	return (us - SIGNING_EPOCH_OFFSET_S*1000000ULL) / 10;
+}
+
+
+void rc_mav_signing_cleanup()
+{
+	int i;
+	delete[] stream_keys;
+	delete[] stream_stamps;
+	stream_keys = NULL;
+	stream_stamps = NULL;
+	num_streams.store(0);
+	for(i=0; i<DEST_TABLE_SIZE; i++) dests[i].used = 0;
+	num_dests = 0;
+}
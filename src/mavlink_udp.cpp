@@ -14,38 +14,86 @@
  * @date       1/24/2018
  */
 
-#define _GNU_SOURCE	// for pthread_timedjoin_np
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>	// for specific integer types
-//#include <sys/time.h>
-//#include <arpa/inet.h>	// Sockets & networking
 #include <sys/types.h>
-//#include <sys/socket.h>
-#include <WinSock2.h>
 #include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "../include/rc/net_platform.h"
 #include "../include/rc/mavlink_udp.h"
-#include "../include/rc/DataStreamClient.h"
+#include "../include/rc/mavlink_traits.h"
+#include "../include/rc/mavlink_signing.h"
+#include "../include/rc/latency_stats.h"
+#include "../include/rc/flight_recorder.h"
+#include "../include/rc/realtime.h"
 
 #define BUFFER_LENGTH		512 // common networking buffer size
 #define MAX_UNIQUE_MSG_TYPES	256
+#define MAX_DRAIN		256 // datagrams read per rc_mav_receive
+#define RECV_BATCH		64 // datagrams per recvmmsg
+#define RECV_WAIT_MS		100 // receive threads check for rc_mav_receive_stop this often
+#define SEND_WAIT_MS		1 // wait for room in a full send buffer this long
+#define CONNECTION_TIMEOUT_US	3000000
 #define LOCALHOST_IP "127.0.0.1"
 
 
 // connection stuff
 static int init_flag=0;
-static int sock_fd;
+static rc_socket_t sock_fd = RC_INVALID_SOCKET;
 static int current_port;
 static struct sockaddr_in my_address ;
 static struct sockaddr_in dest_address;
 static uint8_t system_id;
 
-
+// one socket's reader with its own parser and latest-message store, so
+// receive threads share nothing but the locks readers take
+typedef struct mav_receiver_t{
+	rc_socket_t sock;
+	std::thread thread;
+	mavlink_message_t rx;		// parser state
+	mavlink_status_t rx_status;
+	uint8_t bufs[RECV_BATCH][BUFFER_LENGTH];
+	struct sockaddr_in addrs[RECV_BATCH];	// sender of each datagram
+#ifdef __linux__
+	struct mmsghdr hdrs[RECV_BATCH];
+	struct iovec iovs[RECV_BATCH];
+#endif
+	std::atomic<uint64_t> received;	// messages parsed, only written by the reader
+	// latest message of every id below MAX_UNIQUE_MSG_TYPES
+	std::mutex lock;
+	mavlink_message_t messages[MAX_UNIQUE_MSG_TYPES];
+	int new_msg[MAX_UNIQUE_MSG_TYPES];
+	uint64_t msg_usec[MAX_UNIQUE_MSG_TYPES];	// 0 until the first one
+	int last_msg_id;		// -1 until the first message
+	uint8_t last_sys_id;
+	uint64_t last_usec;
+} mav_receiver_t;
+
+// receivers[0] reads sock_fd, from rc_mav_receive or the first receive thread
+static mav_receiver_t* receivers[RC_MAV_MAX_RECEIVERS];
+static int num_threads = 0;
+static int max_threads = 1;	// set before rc_mav_init, more than 1 shares the port
+static std::atomic<int> receiving(0);
+static void (*callbacks[MAX_UNIQUE_MSG_TYPES])(void);
+static void (*callback_all)(void);
+static void (*connection_lost_callback)(void);
+static std::atomic<int> connection_state(WAITING_FOR_HEARTBEAT);
+static std::atomic<uint64_t> heartbeat_usec(0);
 
 
 // private local function declarations;
-static uint64_t __nanos_since_boot();
+static uint64_t __micros_since_boot();
 static int __address_init(struct sockaddr_in* address, const char* dest_ip, uint16_t port);
+static int __sendto(const uint8_t* buf, int len, const struct sockaddr_in* dest);
+static mav_receiver_t* __receiver_create(rc_socket_t sock);
+static int __num_stores();
+static void __store(mav_receiver_t* r, const mavlink_message_t* msg, uint64_t now);
+static void __parse(mav_receiver_t* r, const uint8_t* buf, int len, uint32_t src_addr, uint64_t now);
+static int __recv_batch(mav_receiver_t* r);
+static void __receive_loop(mav_receiver_t* r);
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,14 +103,7 @@ static int __address_init(struct sockaddr_in* address, const char* dest_ip, uint
 
 static uint64_t __micros_since_boot()
 {
-	FILETIME ft;
-	GetSystemTimeAsFileTime(&ft);
-	unsigned long long tt = ft.dwHighDateTime;
-	tt <<= 32;
-	tt |= ft.dwLowDateTime;
-	tt /= 10;
-	tt -= 11644473600000000ULL;
-	return tt;
+	return rc_net_time_usec();
 }
 
 
@@ -74,7 +115,7 @@ int __address_init(struct sockaddr_in* address, const char* dest_ip, uint16_t po
 		fprintf(stderr, "ERROR: in __address_init: received NULL address struct\n");
 		return -1;
 	}
-	memset((char*) address, 0, sizeof address);
+	memset((char*) address, 0, sizeof *address);
 	address->sin_family = AF_INET;
 	// convert port from host to network byte order
 	address->sin_port = htons(port);
@@ -83,6 +124,139 @@ int __address_init(struct sockaddr_in* address, const char* dest_ip, uint16_t po
 }
 
 
+// the socket is non-blocking, so a full send buffer gets one short wait
+static int __sendto(const uint8_t* buf, int len, const struct sockaddr_in* dest)
+{
+	int bytes_sent = sendto(sock_fd, (const char*)buf, len, 0, (const struct sockaddr *) dest,
+							sizeof *dest);
+	if(bytes_sent < 0 && rc_sock_would_block() && rc_sock_wait_writable(sock_fd, SEND_WAIT_MS) > 0){
+		bytes_sent = sendto(sock_fd, (const char*)buf, len, 0, (const struct sockaddr *) dest,
+							sizeof *dest);
+	}
+	return bytes_sent;
+}
+
+
+static mav_receiver_t* __receiver_create(rc_socket_t sock)
+{
+	// value initialized, so the parser and store start zeroed
+	mav_receiver_t* r = new mav_receiver_t();
+	int i;
+
+	r->sock = sock;
+	r->last_msg_id = -1;
+#ifdef __linux__
+	for(i=0; i<RECV_BATCH; i++){
+		r->iovs[i].iov_base = r->bufs[i];
+		r->iovs[i].iov_len = BUFFER_LENGTH;
+		r->hdrs[i].msg_hdr.msg_iov = &r->iovs[i];
+		r->hdrs[i].msg_hdr.msg_iovlen = 1;
+		r->hdrs[i].msg_hdr.msg_name = &r->addrs[i];
+	}
+#else
+	(void)i;
+#endif
+	return r;
+}
+
+
+// number of receivers holding messages
+static int __num_stores()
+{
+	return num_threads > 0 ? num_threads : 1;
+}
+
+
+static void __store(mav_receiver_t* r, const mavlink_message_t* msg, uint64_t now)
+{
+	{
+		std::lock_guard<std::mutex> l(r->lock);
+		r->last_msg_id = (int)msg->msgid;
+		r->last_sys_id = msg->sysid;
+		r->last_usec = now;
+		if(msg->msgid < MAX_UNIQUE_MSG_TYPES){
+			r->messages[msg->msgid] = *msg;
+			r->new_msg[msg->msgid] = 1;
+			r->msg_usec[msg->msgid] = now;
+		}
+	}
+	r->received.store(r->received.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	if(msg->msgid == MAVLINK_MSG_ID_HEARTBEAT){
+		heartbeat_usec.store(now);
+		connection_state.store(HEARTBEAT_CONNECTION_ACTIVE);
+	}
+	// outside the lock so callbacks can call rc_mav_get_msg
+	if(callback_all != NULL) callback_all();
+	if(msg->msgid < MAX_UNIQUE_MSG_TYPES && callbacks[msg->msgid] != NULL){
+		callbacks[msg->msgid]();
+	}
+}
+
+
+// every datagram holds whole packets, so a truncated one doesn't spill into
+// the next sender's. Senders with a signing key must sign every packet, and
+// unsigned, badly signed or replayed ones are dropped.
+static void __parse(mav_receiver_t* r, const uint8_t* buf, int len, uint32_t src_addr, uint64_t now)
+{
+	mavlink_message_t msg;
+	mavlink_status_t status;
+	int signed_src = rc_mav_signing_has_key(src_addr);
+	int i;
+
+	r->rx_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+	for(i=0; i<len; i++){
+		if(mavlink_frame_char_buffer(&r->rx, &r->rx_status, buf[i], &msg, &status) != MAVLINK_FRAMING_OK) continue;
+		if(signed_src && rc_mav_signing_verify(src_addr, &msg) != 0) continue;
+		__store(r, &msg, now);
+	}
+}
+
+
+// reads up to RECV_BATCH datagrams without waiting, one recvmmsg on Linux,
+// returns how many
+static int __recv_batch(mav_receiver_t* r)
+{
+	uint64_t now;
+	int i, n = 0;
+
+#ifdef __linux__
+	// the kernel shortens msg_namelen to the address it wrote
+	for(i=0; i<RECV_BATCH; i++) r->hdrs[i].msg_hdr.msg_namelen = sizeof(r->addrs[i]);
+	n = recvmmsg(r->sock, r->hdrs, RECV_BATCH, MSG_DONTWAIT, NULL);
+	if(n <= 0) return 0;
+	now = __micros_since_boot();
+	for(i=0; i<n; i++){
+		__parse(r, r->bufs[i], (int)r->hdrs[i].msg_len, r->addrs[i].sin_addr.s_addr, now);
+	}
+#else
+	rc_socklen_t addr_len;
+	int len;
+	now = __micros_since_boot();
+	for(i=0; i<RECV_BATCH; i++){
+		addr_len = sizeof(r->addrs[0]);
+		len = recvfrom(r->sock, (char*)r->bufs[0], BUFFER_LENGTH, 0,
+				(struct sockaddr*)&r->addrs[0], &addr_len);
+		if(len < 0){
+			if(rc_sock_would_block()) break;
+			// Windows reports ICMP port unreachable for earlier sends here
+			continue;
+		}
+		__parse(r, r->bufs[0], len, r->addrs[0].sin_addr.s_addr, now);
+		n++;
+	}
+#endif
+	return n;
+}
+
+
+static void __receive_loop(mav_receiver_t* r)
+{
+	rc_rt_enter(RC_RT_RECEIVE);
+	while(receiving.load()){
+		if(rc_sock_wait_readable(r->sock, RECV_WAIT_MS) <= 0) continue;
+		while(__recv_batch(r) == RECV_BATCH);
+	}
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -109,39 +283,52 @@ int rc_mav_init(uint8_t sysid, const char* dest_ip, uint16_t port)
 	
 
 	// open socket for UDP packets
-
-	printf("\nInitialising Winsock...");
-	WSADATA wsa;
-	if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
-	{
-		printf("Failed. Error Code : %d", WSAGetLastError());
-		exit(EXIT_FAILURE);
+	if(rc_net_init() < 0){
+		fprintf(stderr, "ERROR: in rc_mav_init: failed to start sockets\n");
+		return -1;
 	}
-	printf("Initialised.\n");
 
 	sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(sock_fd == INVALID_SOCKET){
-		fprintf(stderr,"ERROR: in rc_mav_init: socket failed");
+	if(sock_fd == RC_INVALID_SOCKET){
+		fprintf(stderr,"ERROR: in rc_mav_init: socket failed\n");
+		rc_net_cleanup();
 		return -1;
 	}
-
-	// fill out rest of sockaddr_in struct
-	if (__address_init(&my_address, 0, current_port) != 0){
-		fprintf(stderr, "ERROR: in rc_mav_init: couldn't set local address\n");
+#ifdef __linux__
+	// lets rc_mav_receive_start bind more sockets to the port, only when
+	// asked for so the bind still fails if something else has the port
+	int on = 1;
+	if(max_threads > 1 && setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0){
+		fprintf(stderr,"ERROR: in rc_mav_init: failed to set SO_REUSEPORT\n");
+		rc_sock_close(sock_fd);
+		sock_fd = RC_INVALID_SOCKET;
+		rc_net_cleanup();
 		return -1;
 	}
-
-	// bind address to listening port
-	if(bind(sock_fd, (struct sockaddr *) &my_address, sizeof my_address) < 0){
-		fprintf(stderr,"ERROR: in rc_mav_init, bind failed\n");
+#endif
+
+	// fill out rest of sockaddr_in struct, bind address to listening port
+	// and set destination address
+	if (__address_init(&my_address, 0, current_port) != 0 ||
+	   bind(sock_fd, (struct sockaddr *) &my_address, sizeof my_address) < 0 ||
+	   __address_init(&dest_address, dest_ip, current_port) != 0){
+		fprintf(stderr,"ERROR: in rc_mav_init, bind to port %d failed\n", current_port);
+		rc_sock_close(sock_fd);
+		sock_fd = RC_INVALID_SOCKET;
+		rc_net_cleanup();
 		return -1;
 	}
 
-	// set destination address
-	if(__address_init(&dest_address, dest_ip, current_port) != 0){
-		fprintf(stderr, "ERROR: in rc_mav_init: couldn't set destination address");
+	// incoming packets are read by rc_mav_receive from the caller's loop
+	if(rc_sock_set_nonblocking(sock_fd) < 0){
+		fprintf(stderr,"ERROR: in rc_mav_init, couldn't make the socket non-blocking\n");
+		rc_sock_close(sock_fd);
+		sock_fd = RC_INVALID_SOCKET;
+		rc_net_cleanup();
 		return -1;
 	}
+	receivers[0] = __receiver_create(sock_fd);
+	connection_state.store(WAITING_FOR_HEARTBEAT);
 
 	// signal initialization finished
 	init_flag=1;
@@ -151,6 +338,20 @@ int rc_mav_init(uint8_t sysid, const char* dest_ip, uint16_t port)
 	return 0;
 }
 
+int rc_mav_set_receive_threads(int threads)
+{
+	if(init_flag != 0){
+		fprintf(stderr, "ERROR: in rc_mav_set_receive_threads, call it before rc_mav_init\n");
+		return -1;
+	}
+	if(threads < 1 || threads > RC_MAV_MAX_RECEIVERS){
+		fprintf(stderr, "ERROR: in rc_mav_set_receive_threads, threads must be between 1 and %d\n", RC_MAV_MAX_RECEIVERS);
+		return -1;
+	}
+	max_threads = threads;
+	return 0;
+}
+
 int rc_mav_set_dest_ip(const char* dest_ip)
 {
 	return __address_init(&dest_address,dest_ip,current_port);
@@ -164,20 +365,144 @@ int rc_mav_set_system_id(uint8_t sys_id)
 }
 
 
+uint8_t rc_mav_get_system_id()
+{
+	return system_id;
+}
+
+
 int rc_mav_cleanup()
 {
-	//close(sock_fd);
+	if(init_flag == 0) return 0;
+	rc_mav_receive_stop();
+	delete receivers[0];
+	receivers[0] = NULL;
+	rc_sock_close(sock_fd);
+	sock_fd = RC_INVALID_SOCKET;
+	rc_net_cleanup();
 	init_flag=0;
 	return 0;
 }
 
 
+rc_socket_t rc_mav_socket()
+{
+	return sock_fd;
+}
+
+
+int rc_mav_receive()
+{
+	uint64_t before;
+	int k, active = HEARTBEAT_CONNECTION_ACTIVE;
+
+	if(init_flag == 0){
+		fprintf(stderr, "ERROR: in rc_mav_receive, socket not initialized\n");
+		return -1;
+	}
+	// receive threads read the socket themselves
+	before = receivers[0]->received.load(std::memory_order_relaxed);
+	for(k=0; num_threads==0 && k<MAX_DRAIN/RECV_BATCH; k++){
+		if(__recv_batch(receivers[0]) < RECV_BATCH) break;
+	}
+
+	if(__micros_since_boot() > heartbeat_usec.load() + CONNECTION_TIMEOUT_US &&
+	   connection_state.compare_exchange_strong(active, HEARTBEAT_CONNECTION_LOST) &&
+	   connection_lost_callback != NULL){
+		connection_lost_callback();
+	}
+	return (int)(receivers[0]->received.load(std::memory_order_relaxed) - before);
+}
+
+
+int rc_mav_receive_start(int threads)
+{
+	int i;
+
+	if(init_flag == 0 || num_threads > 0){
+		fprintf(stderr, "ERROR: in rc_mav_receive_start, socket not initialized or threads already running\n");
+		return -1;
+	}
+	if(threads < 1 || threads > RC_MAV_MAX_RECEIVERS){
+		fprintf(stderr, "ERROR: in rc_mav_receive_start, threads must be between 1 and %d\n", RC_MAV_MAX_RECEIVERS);
+		return -1;
+	}
+#ifndef __linux__
+	// SO_REUSEPORT only spreads senders over sockets on Linux
+	if(threads > 1){
+		fprintf(stderr, "WARNING: in rc_mav_receive_start, several threads need Linux, using 1\n");
+		threads = 1;
+	}
+#else
+	if(threads > max_threads){
+		fprintf(stderr, "ERROR: in rc_mav_receive_start, %d threads need rc_mav_set_receive_threads(%d) before rc_mav_init\n",
+			threads, threads);
+		return -1;
+	}
+	int on = 1;
+	for(i=1; i<threads; i++){
+		rc_socket_t sock = socket(AF_INET, SOCK_DGRAM, 0);
+		if(sock == RC_INVALID_SOCKET ||
+		   setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0 ||
+		   bind(sock, (struct sockaddr *) &my_address, sizeof my_address) < 0 ||
+		   rc_sock_set_nonblocking(sock) < 0){
+			fprintf(stderr, "ERROR: in rc_mav_receive_start, couldn't open socket %d on port %d\n", i, current_port);
+			if(sock != RC_INVALID_SOCKET) rc_sock_close(sock);
+			for(i=i-1; i>0; i--){
+				rc_sock_close(receivers[i]->sock);
+				delete receivers[i];
+				receivers[i] = NULL;
+			}
+			return -1;
+		}
+		receivers[i] = __receiver_create(sock);
+	}
+#endif
+	receiving.store(1);
+	for(i=0; i<threads; i++){
+		receivers[i]->thread = std::thread(__receive_loop, receivers[i]);
+	}
+	num_threads = threads;
+	return 0;
+}
+
+
+void rc_mav_receive_stop()
+{
+	int i;
+
+	if(num_threads == 0) return;
+	receiving.store(0);
+	for(i=0; i<num_threads; i++) receivers[i]->thread.join();
+	for(i=1; i<num_threads; i++){
+		rc_sock_close(receivers[i]->sock);
+		delete receivers[i];
+		receivers[i] = NULL;
+	}
+	num_threads = 0;
+}
+
+
+uint64_t rc_mav_received(int receiver)
+{
+	if(init_flag == 0 || receiver < 0 || receiver >= __num_stores()) return 0;
+	return receivers[receiver]->received.load(std::memory_order_relaxed);
+}
+
+
 int rc_mav_send_msg(mavlink_message_t msg)
 {
 	if(init_flag == 0){
 		fprintf(stderr, "ERROR: in rc_mav_send_msg, socket not initialized\n");
 		return -1;
 	}
+	int subject = rc_lat_current_subject();
+	uint64_t t = rc_lat_now();
+	// sign in place if this destination has a key, msg is our own copy
+	if(rc_mav_signing_sign(dest_address.sin_addr.s_addr, &msg) < 0){
+		fprintf(stderr, "ERROR: in rc_mav_send_msg, unable to sign message\n");
+		return -1;
+	}
 	uint8_t buf[BUFFER_LENGTH];
 	memset(buf, 0, BUFFER_LENGTH);
 	int msg_len = mavlink_msg_to_send_buffer(buf, &msg);
@@ -185,16 +510,292 @@ int rc_mav_send_msg(mavlink_message_t msg)
 		fprintf(stderr, "ERROR: in rc_mav_send_msg, unable to pack message for sending\n");
 		return -1;
 	}
-	int bytes_sent = sendto(sock_fd, (char*)buf, msg_len, 0, (struct sockaddr *) &dest_address,
-							sizeof dest_address);
-	if(bytes_sent != msg_len){
-		perror("ERROR: in rc_mav_send_msg: failed to write to UDP socket\n");
+	rc_lat_record(RC_LAT_SIGN, subject, t);
+	return rc_mav_send_buffer(buf, msg_len);
+}
+
+
+int rc_mav_send_buffer(const uint8_t* buf, int len)
+{
+	if(init_flag == 0){
+		fprintf(stderr, "ERROR: in rc_mav_send_buffer, socket not initialized\n");
+		return -1;
+	}
+	uint64_t t = rc_lat_now();
+	int bytes_sent = __sendto(buf, len, &dest_address);
+	rc_lat_record(RC_LAT_SYSCALL, rc_lat_current_subject(), t);
+	if(bytes_sent != len){
+		perror("ERROR: in rc_mav_send_buffer: failed to write to UDP socket\n");
+		return -1;
+	}
+	if(rc_recorder_is_running()){
+		rc_recorder_push(__micros_since_boot(), buf, len);
+	}
+	return 0;
+}
+
+
+int rc_mav_parse_ip(const char* ip, uint32_t* addr)
+{
+	uint32_t a = inet_addr(ip);
+	// INADDR_NONE is also 255.255.255.255, which is never a vehicle
+	if(a == INADDR_NONE) return -1;
+	*addr = a;
+	return 0;
+}
+
+
+uint64_t rc_mav_time_usec()
+{
+	return __micros_since_boot();
+}
+
+
+int rc_mav_pack_msg(rc_mav_packet_t* pkt, uint32_t dest_addr, uint16_t dest_port,
+			uint8_t sysid, uint8_t seq, uint32_t msgid, const void* payload,
+			uint8_t min_len, uint8_t len, uint8_t crc_extra)
+{
+	mavlink_message_t msg;
+	mavlink_status_t status;
+	uint64_t t = rc_lat_now();
+	int subject = rc_lat_current_subject();
+	int n;
+
+	// same as the mavlink_msg_*_pack functions but with our own status so
+	// nothing is shared with other threads
+	memcpy(_MAV_PAYLOAD_NON_CONST(&msg), payload, len);
+	msg.msgid = msgid;
+	memset(&status, 0, sizeof(status));
+	status.current_tx_seq = seq;
+	if(sysid == 0) sysid = system_id;
+	mavlink_finalize_message_buffer(&msg, sysid, MAV_COMP_ID_ALL, &status, min_len, len, crc_extra);
+	t = rc_lat_record(RC_LAT_PACK, subject, t);
+
+	if(rc_mav_signing_sign(dest_addr, &msg) < 0){
+		fprintf(stderr, "ERROR: in rc_mav_pack_msg, unable to sign message\n");
+		return -1;
+	}
+	n = mavlink_msg_to_send_buffer(pkt->buf, &msg);
+	rc_lat_record(RC_LAT_SIGN, subject, t);
+	pkt->dest_addr = dest_addr;
+	pkt->dest_port = dest_port;
+	pkt->sysid = sysid;
+	pkt->subject = subject;
+	pkt->len = (uint16_t)n;
+	return 0;
+}
+
+
+int rc_mav_pack_att_pos_mocap(rc_mav_packet_t* pkt, uint32_t dest_addr, uint16_t dest_port,
+			uint8_t sysid, uint8_t seq, const float q[4], float x, float y, float z)
+{
+	mavlink_att_pos_mocap_t packet;
+
+	packet.time_usec = __micros_since_boot();
+	packet.x = x;
+	packet.y = y;
+	packet.z = z;
+	memcpy(packet.q, q, sizeof(packet.q));
+	return RC_MAV_PACK(pkt, dest_addr, dest_port, sysid, seq, ATT_POS_MOCAP, &packet);
+}
+
+
+int rc_mav_send_packets(rc_mav_packet_t* pkts, int n)
+{
+	struct sockaddr_in dest;
+	uint64_t now_usec;
+	int i, sent = 0;
+
+	if(init_flag == 0){
+		fprintf(stderr, "ERROR: in rc_mav_send_packets, socket not initialized\n");
 		return -1;
 	}
+	memset(&dest, 0, sizeof(dest));
+	dest.sin_family = AF_INET;
+	now_usec = rc_recorder_is_running() ? __micros_since_boot() : 0;
+	for(i=0; i<n; i++){
+		if(pkts[i].len == 0) continue;
+		uint64_t t = rc_lat_now();
+		dest.sin_addr.s_addr = pkts[i].dest_addr;
+		dest.sin_port = htons(pkts[i].dest_port != 0 ? pkts[i].dest_port : current_port);
+		int bytes_sent = __sendto(pkts[i].buf, pkts[i].len, &dest);
+		rc_lat_record(RC_LAT_SYSCALL, pkts[i].subject, t);
+		if(bytes_sent != pkts[i].len){
+			pkts[i].len = 0;
+			continue;
+		}
+		if(now_usec) rc_recorder_push(now_usec, pkts[i].buf, pkts[i].len);
+		sent++;
+	}
+	return sent;
+}
+
+
+int rc_mav_is_new_msg(int msg_id)
+{
+	int i;
+
+	if(init_flag == 0 || msg_id < 0 || msg_id >= MAX_UNIQUE_MSG_TYPES) return 0;
+	for(i=0; i<__num_stores(); i++){
+		std::lock_guard<std::mutex> l(receivers[i]->lock);
+		if(receivers[i]->new_msg[msg_id]) return 1;
+	}
 	return 0;
 }
 
 
+// the newest message of an id across every receiver's store
+int rc_mav_get_msg(int msg_id, mavlink_message_t* msg)
+{
+	uint64_t newest = 0;
+	int i;
+
+	if(init_flag == 0 || msg_id < 0 || msg_id >= MAX_UNIQUE_MSG_TYPES) return -1;
+	for(i=0; i<__num_stores(); i++){
+		mav_receiver_t* r = receivers[i];
+		std::lock_guard<std::mutex> l(r->lock);
+		if(r->msg_usec[msg_id] > newest){
+			newest = r->msg_usec[msg_id];
+			*msg = r->messages[msg_id];
+		}
+		r->new_msg[msg_id] = 0;
+	}
+	return newest > 0 ? 0 : -1;
+}
+
+
+int rc_mav_set_callback(int msg_id, void (*func)(void))
+{
+	if(msg_id < 0 || msg_id >= MAX_UNIQUE_MSG_TYPES){
+		fprintf(stderr, "ERROR: in rc_mav_set_callback, msg_id %d out of range\n", msg_id);
+		return -1;
+	}
+	callbacks[msg_id] = func;
+	return 0;
+}
+
+
+int rc_mav_set_callback_all(void (*func)(void))
+{
+	callback_all = func;
+	return 0;
+}
+
+
+int rc_mav_set_connection_lost_callback(void (*func)(void))
+{
+	connection_lost_callback = func;
+	return 0;
+}
+
+
+rc_mav_connection_state_t rc_mav_get_connection_state()
+{
+	return (rc_mav_connection_state_t)connection_state.load();
+}
+
+
+uint8_t rc_mav_get_sys_id_of_last_msg(int msg_id)
+{
+	uint64_t newest = 0;
+	uint8_t sysid = (uint8_t)-1;
+	int i;
+
+	if(init_flag == 0 || msg_id < 0 || msg_id >= MAX_UNIQUE_MSG_TYPES) return (uint8_t)-1;
+	for(i=0; i<__num_stores(); i++){
+		std::lock_guard<std::mutex> l(receivers[i]->lock);
+		if(receivers[i]->msg_usec[msg_id] > newest){
+			newest = receivers[i]->msg_usec[msg_id];
+			sysid = receivers[i]->messages[msg_id].sysid;
+		}
+	}
+	return sysid;
+}
+
+
+uint8_t rc_mav_get_sys_id_of_last_msg_any()
+{
+	uint64_t newest = 0;
+	uint8_t sysid = (uint8_t)-1;
+	int i;
+
+	if(init_flag == 0) return (uint8_t)-1;
+	for(i=0; i<__num_stores(); i++){
+		std::lock_guard<std::mutex> l(receivers[i]->lock);
+		if(receivers[i]->last_msg_id >= 0 && receivers[i]->last_usec > newest){
+			newest = receivers[i]->last_usec;
+			sysid = receivers[i]->last_sys_id;
+		}
+	}
+	return sysid;
+}
+
+
+int64_t rc_mav_ns_since_last_msg(int msg_id)
+{
+	uint64_t newest = 0;
+	int i;
+
+	if(init_flag == 0 || msg_id < 0 || msg_id >= MAX_UNIQUE_MSG_TYPES) return -1;
+	for(i=0; i<__num_stores(); i++){
+		std::lock_guard<std::mutex> l(receivers[i]->lock);
+		if(receivers[i]->msg_usec[msg_id] > newest) newest = receivers[i]->msg_usec[msg_id];
+	}
+	if(newest == 0) return -1;
+	return (int64_t)(__micros_since_boot() - newest) * 1000;
+}
+
+
+int64_t rc_mav_ns_since_last_msg_any()
+{
+	uint64_t newest = 0;
+	int i;
+
+	if(init_flag == 0) return -1;
+	for(i=0; i<__num_stores(); i++){
+		std::lock_guard<std::mutex> l(receivers[i]->lock);
+		if(receivers[i]->last_msg_id >= 0 && receivers[i]->last_usec > newest){
+			newest = receivers[i]->last_usec;
+		}
+	}
+	if(newest == 0) return -1;
+	return (int64_t)(__micros_since_boot() - newest) * 1000;
+}
+
+
+int rc_mav_msg_id_of_last_msg()
+{
+	uint64_t newest = 0;
+	int i, id = -1;
+
+	if(init_flag == 0) return -1;
+	for(i=0; i<__num_stores(); i++){
+		std::lock_guard<std::mutex> l(receivers[i]->lock);
+		if(receivers[i]->last_msg_id >= 0 && receivers[i]->last_usec > newest){
+			newest = receivers[i]->last_usec;
+			id = receivers[i]->last_msg_id;
+		}
+	}
+	return id;
+}
+
+
+int rc_mav_print_msg_name(int msg_id)
+{
+	switch(msg_id){
+#define RC_MAV_NAME_CASE(lower, NAME) \
+	case MAVLINK_MSG_ID_##NAME: \
+		printf("%s\n", rc_mav_msg<mavlink_##lower##_t>::name()); \
+		return 0;
+	RC_MAV_MESSAGES(RC_MAV_NAME_CASE)
+#undef RC_MAV_NAME_CASE
+	default:
+		fprintf(stderr, "ERROR: in rc_mav_print_msg_name, unknown msg_id %d\n", msg_id);
+		return -1;
+	}
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // DEFINITIONS FOR mavlink_udp_helpers.h
 ////////////////////////////////////////////////////////////////////////////////
@@ -225,8 +826,10 @@ int rc_mav_send_heartbeat(uint32_t custom_mode, uint8_t type, uint8_t autopilot,
 int rc_mav_send_att_pos_mocap(float q[4], float x, float y, float z)
 {
 	mavlink_message_t msg;
+	uint64_t t = rc_lat_now();
 	uint64_t time_usec = __micros_since_boot();
 	mavlink_msg_att_pos_mocap_pack(system_id, MAV_COMP_ID_ALL, &msg, time_usec, q, x, y, z);
+	rc_lat_record(RC_LAT_PACK, rc_lat_current_subject(), t);
 	return rc_mav_send_msg(msg);
 }
 
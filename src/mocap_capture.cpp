@@ -0,0 +1,193 @@
+/**
+ * @file mocap_capture.cpp
+ *
+ * @brief      Append-only frame capture files and the memory-mapped replay
+ *             source that plays them back. See mocap_capture.h and
+ *             mocap_source.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "../include/rc/mapped_file.h"
+#include "../include/rc/latency_stats.h"
+#include "../include/rc/mocap_source.h"
+#include "../include/rc/mocap_capture.h"
+
+#define CAPTURE_BUF_SIZE	(1024*1024)
+
+static FILE* capture_file = NULL;
+static char* capture_buf = NULL;
+static uint64_t capture_frames;
+
+typedef std::chrono::steady_clock replay_clock;
+
+/**
+ * Plays back a mapped capture file
+ */
+class ReplayMocapSource : public MocapSource
+{
+public:
+	ReplayMocapSource(double speed) : speed(speed), pos(0), started(0)
+	{
+		memset(&file, 0, sizeof(file));
+	}
+
+	~ReplayMocapSource()
+	{
+		rc_unmap_file(&file);
+	}
+
+	int open(const char* path);
+	int next_frame(const rc_mocap_frame_t** frame);
+
+private:
+	rc_mapped_file_t file;
+	double speed;
+	size_t pos;
+	int started;
+	uint64_t t0_capture;
+	replay_clock::time_point t0_wall;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR ReplayMocapSource
+////////////////////////////////////////////////////////////////////////////////
+
+int ReplayMocapSource::open(const char* path)
+{
+	const rc_mocap_capture_header_t* h;
+
+	if(rc_map_file(path, &file)) return -1;
+	h = (const rc_mocap_capture_header_t*)file.data;
+	if(file.size < sizeof(*h) || memcmp(h->magic, RC_MOCAP_CAPTURE_MAGIC, sizeof(RC_MOCAP_CAPTURE_MAGIC))){
+		fprintf(stderr, "ERROR: in rc_mocap_replay_source_create, %s is not a capture file\n", path);
+		return -1;
+	}
+	if(h->version != RC_MOCAP_CAPTURE_VERSION ||
+			h->frame_header_size != sizeof(rc_mocap_frame_t) ||
+			h->subject_size != sizeof(rc_mocap_subject_t)){
+		fprintf(stderr, "ERROR: in rc_mocap_replay_source_create, %s has an unsupported layout\n", path);
+		return -1;
+	}
+	pos = sizeof(*h);
+	return 0;
+}
+
+
+int ReplayMocapSource::next_frame(const rc_mocap_frame_t** frame)
+{
+	const rc_mocap_frame_t* f;
+	uint64_t t;
+
+	// a partial record at the end means the capture was cut short
+	if(pos + sizeof(rc_mocap_frame_t) > file.size) return RC_MOCAP_END;
+	f = (const rc_mocap_frame_t*)(file.data + pos);
+	if(f->size != rc_mocap_frame_size(f->subject_count) || pos + f->size > file.size){
+		return RC_MOCAP_END;
+	}
+
+	if(!started){
+		t0_capture = f->capture_usec;
+		t0_wall = replay_clock::now();
+		started = 1;
+	}
+	else if(speed > 0.0 && f->capture_usec > t0_capture){
+		std::this_thread::sleep_until(t0_wall + std::chrono::duration_cast<replay_clock::duration>(
+			std::chrono::duration<double, std::micro>((double)(f->capture_usec - t0_capture) / speed)));
+	}
+
+	// nothing to extract, the frame is used in place
+	t = rc_lat_now();
+	pos += f->size;
+	*frame = f;
+	rc_lat_record(RC_LAT_ACQUIRE, RC_LAT_ALL_SUBJECTS, t);
+	return RC_MOCAP_FRAME;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR mocap_source.h and mocap_capture.h
+////////////////////////////////////////////////////////////////////////////////
+
+MocapSource* rc_mocap_replay_source_create(const char* path, double speed)
+{
+	ReplayMocapSource* source;
+
+	if(speed < 0.0){
+		fprintf(stderr, "ERROR: in rc_mocap_replay_source_create, speed must be >= 0\n");
+		return NULL;
+	}
+	source = new ReplayMocapSource(speed);
+	if(source->open(path)){
+		delete source;
+		return NULL;
+	}
+	return source;
+}
+
+
+int rc_mocap_capture_start(const char* path)
+{
+	rc_mocap_capture_header_t h;
+
+	if(capture_file != NULL){
+		fprintf(stderr, "ERROR: in rc_mocap_capture_start, already capturing\n");
+		return -1;
+	}
+	capture_file = fopen(path, "wb");
+	if(capture_file == NULL){
+		fprintf(stderr, "ERROR: in rc_mocap_capture_start, failed to open %s\n", path);
+		return -1;
+	}
+	capture_buf = (char*)malloc(CAPTURE_BUF_SIZE);
+	if(capture_buf != NULL) setvbuf(capture_file, capture_buf, _IOFBF, CAPTURE_BUF_SIZE);
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, RC_MOCAP_CAPTURE_MAGIC, sizeof(RC_MOCAP_CAPTURE_MAGIC));
+	h.version = RC_MOCAP_CAPTURE_VERSION;
+	h.frame_header_size = sizeof(rc_mocap_frame_t);
+	h.subject_size = sizeof(rc_mocap_subject_t);
+	if(fwrite(&h, sizeof(h), 1, capture_file) != 1){
+		fprintf(stderr, "ERROR: in rc_mocap_capture_start, failed to write %s\n", path);
+		rc_mocap_capture_stop();
+		return -1;
+	}
+	capture_frames = 0;
+	return 0;
+}
+
+
+int rc_mocap_capture_is_running()
+{
+	return capture_file != NULL;
+}
+
+
+int rc_mocap_capture_write(const rc_mocap_frame_t* frame)
+{
+	if(capture_file == NULL) return -1;
+	if(fwrite(frame, frame->size, 1, capture_file) != 1){
+		fprintf(stderr, "ERROR: in rc_mocap_capture_write, write failed\n");
+		return -1;
+	}
+	capture_frames++;
+	return 0;
+}
+
+
+uint64_t rc_mocap_capture_stop()
+{
+	if(capture_file == NULL) return 0;
+	fclose(capture_file);
+	capture_file = NULL;
+	free(capture_buf);
+	capture_buf = NULL;
+	return capture_frames;
+}
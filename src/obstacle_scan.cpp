@@ -0,0 +1,237 @@
+/**
+ * @file obstacle_scan.cpp
+ *
+ * @brief      Synthesized 360 degree range scans of the other subjects and the
+ *             fixed obstacles. See obstacle_scan.h
+ *
+ * @date       10/18/2026
+ */
+
+#define _USE_MATH_DEFINES	// for M_PI
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <float.h>
+#include <math.h>
+#include <vector>
+#include "../include/rc/obstacle_scan.h"
+
+#define MAX_RANGE_M	600.0f	// range in centimeters must fit 16 bits
+
+// the subjects, sorted by table entry, one array per coordinate
+static std::vector<float> sx, sy, sz;
+static std::vector<int32_t> sid;
+static std::vector<uint32_t> start;	// first subject of each entry, plus one past the end
+static std::vector<uint32_t> entry;	// entry of each unsorted subject
+static uint32_t mask;
+static float inv_cell;
+static std::vector<rc_scan_obstacle_t> fixed_obstacles;
+// the config in millimeters
+static float range_mm, radius_mm, band_mm;
+// direction of the center of every sector in the vehicle's frame, x forward
+// and y left, and the sector half width
+static float ux[RC_SCAN_SECTORS];
+static float uy[RC_SCAN_SECTORS];
+static float cos_hw, sin_hw;
+static int have_sectors = 0;
+
+
+// private local function declarations;
+static inline uint32_t __hash(int32_t cx, int32_t cy);
+static void __init_sectors();
+static void __cover(float bx, float by, float r, float best[RC_SCAN_SECTORS]);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// as in spatial_grid.cpp, with the squares of the floor plan
+static inline uint32_t __hash(int32_t cx, int32_t cy)
+{
+	return (((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u)) & mask;
+}
+
+
+// sector k is k increments clockwise from forward, which is towards -y
+static void __init_sectors()
+{
+	double a;
+	int k;
+
+	for(k=0; k<RC_SCAN_SECTORS; k++){
+		a = k * RC_SCAN_INCREMENT * M_PI / 180.0;
+		ux[k] = (float)cos(a);
+		uy[k] = (float)-sin(a);
+	}
+	cos_hw = (float)cos(RC_SCAN_INCREMENT * M_PI / 360.0);
+	sin_hw = (float)sin(RC_SCAN_INCREMENT * M_PI / 360.0);
+	have_sectors = 1;
+}
+
+
+// a cylinder of radius r centered at bx, by in the vehicle's frame overlaps
+// a sector when the angle between them is at most its angular half width
+// plus the sector's, that is when the dot product of the sector direction
+// with bx, by is at least |b| cos(half widths). The loop over the sectors
+// has no branches so it vectorizes.
+static void __cover(float bx, float by, float r, float best[RC_SCAN_SECTORS])
+{
+	float dn = sqrtf(bx * bx + by * by);
+	float dist, thr, sa, ca, d;
+	int k;
+
+	if(dn - r >= range_mm) return;
+	if(dn <= r){
+		// inside it, every sector is blocked
+		dist = 0.0f;
+		thr = -FLT_MAX;
+	}
+	else{
+		sa = r / dn;
+		ca = sqrtf(1.0f - sa * sa);
+		thr = dn * (ca * cos_hw - sa * sin_hw);
+		dist = dn - r;
+	}
+	for(k=0; k<RC_SCAN_SECTORS; k++){
+		d = ux[k] * bx + uy[k] * by >= thr ? dist : FLT_MAX;
+		best[k] = best[k] < d ? best[k] : d;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR obstacle_scan.h
+////////////////////////////////////////////////////////////////////////////////
+
+void rc_scan_default_config(rc_scan_config_t* cfg)
+{
+	cfg->range_m = RC_SCAN_DEFAULT_RANGE;
+	cfg->vehicle_radius_m = RC_SCAN_DEFAULT_VEHICLE_RADIUS;
+	cfg->band_m = RC_SCAN_DEFAULT_BAND;
+}
+
+
+int rc_scan_build(const float* x, const float* y, const float* z, int n,
+			const rc_scan_obstacle_t* fixed, int num_fixed, const rc_scan_config_t* cfg)
+{
+	uint32_t size, e, j;
+	int i;
+
+	if(n < 0 || num_fixed < 0 || !(cfg->range_m > 0.0f && cfg->range_m <= MAX_RANGE_M) ||
+			cfg->vehicle_radius_m < 0.0f || cfg->band_m < 0.0f){
+		fprintf(stderr, "ERROR: in rc_scan_build, invalid arguments\n");
+		return -1;
+	}
+	if(!have_sectors) __init_sectors();
+	range_mm = cfg->range_m * 1000.0f;
+	radius_mm = cfg->vehicle_radius_m * 1000.0f;
+	band_mm = cfg->band_m * 1000.0f;
+	inv_cell = 1.0f / range_mm;
+	fixed_obstacles.assign(fixed, fixed + num_fixed);
+
+	for(size = 16; size < 2u * (uint32_t)n; size *= 2);
+	mask = size - 1;
+	sx.resize(n);
+	sy.resize(n);
+	sz.resize(n);
+	sid.resize(n);
+	entry.resize(n);
+	start.assign(size + 1, 0);
+
+	// count the subjects of every entry
+	for(i=0; i<n; i++){
+		entry[i] = __hash((int32_t)floorf(x[i] * inv_cell), (int32_t)floorf(y[i] * inv_cell));
+		start[entry[i] + 1]++;
+	}
+	for(e=0; e<size; e++) start[e + 1] += start[e];
+	// scatter, using start as the insertion point and shifting it back after
+	for(i=0; i<n; i++){
+		j = start[entry[i]]++;
+		sx[j] = x[i];
+		sy[j] = y[i];
+		sz[j] = z[i];
+		sid[j] = i;
+	}
+	for(e=size; e>0; e--) start[e] = start[e - 1];
+	start[0] = 0;
+	return 0;
+}
+
+
+uint16_t rc_scan_sectors(const float p[3], float yaw, int self, uint16_t distances[RC_SCAN_SECTORS])
+{
+	float best[RC_SCAN_SECTORS];
+	float c = cosf(yaw);
+	float s = sinf(yaw);
+	float wx, wy;
+	uint16_t range_cm = (uint16_t)(range_mm / 10.0f);
+	int32_t cx, cy;
+	uint32_t e, j;
+	int k, dx, dy;
+
+	for(k=0; k<RC_SCAN_SECTORS; k++) best[k] = FLT_MAX;
+	if(!start.empty()){
+		cx = (int32_t)floorf(p[0] * inv_cell);
+		cy = (int32_t)floorf(p[1] * inv_cell);
+		// the squares are as big as the range, anything in it is in these 9.
+		// Squares sharing an entry are looked at twice, which does no harm.
+		for(dx=-1; dx<=1; dx++){
+			for(dy=-1; dy<=1; dy++){
+				e = __hash(cx + dx, cy + dy);
+				for(j=start[e]; j<start[e + 1]; j++){
+					if(sid[j] == self || fabsf(sz[j] - p[2]) > band_mm) continue;
+					wx = sx[j] - p[0];
+					wy = sy[j] - p[1];
+					__cover(c * wx + s * wy, c * wy - s * wx, radius_mm, best);
+				}
+			}
+		}
+	}
+	for(const rc_scan_obstacle_t& o : fixed_obstacles){
+		wx = o.x - p[0];
+		wy = o.y - p[1];
+		__cover(c * wx + s * wy, c * wy - s * wx, o.radius, best);
+	}
+
+	for(k=0; k<RC_SCAN_SECTORS; k++){
+		if(best[k] >= range_mm) distances[k] = range_cm + 1;
+		else if(best[k] < RC_SCAN_MIN_CM * 10.0f) distances[k] = RC_SCAN_MIN_CM;
+		else distances[k] = (uint16_t)(best[k] / 10.0f);
+	}
+	return range_cm;
+}
+
+
+void rc_scan_reserve(int n)
+{
+	uint32_t size;
+
+	if(n < 0) return;
+	for(size = 16; size < 2u * (uint32_t)n; size *= 2);
+	sx.reserve(n);
+	sy.reserve(n);
+	sz.reserve(n);
+	sid.reserve(n);
+	entry.reserve(n);
+	start.reserve(size + 1);
+}
+
+
+void rc_scan_cleanup()
+{
+	sx.clear();
+	sx.shrink_to_fit();
+	sy.clear();
+	sy.shrink_to_fit();
+	sz.clear();
+	sz.shrink_to_fit();
+	sid.clear();
+	sid.shrink_to_fit();
+	start.clear();
+	start.shrink_to_fit();
+	entry.clear();
+	entry.shrink_to_fit();
+	fixed_obstacles.clear();
+	fixed_obstacles.shrink_to_fit();
+}
@@ -0,0 +1,436 @@
+/**
+ * @file pose_bus.cpp
+ *
+ * @brief      Shared-memory bus publishing every frame's pose table to other
+ *             processes on the same machine. See pose_bus.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "../include/rc/pose_bus.h"
+
+#define SEGMENT_NAME_LEN	128
+#define NUM_ARRAYS		9	// index, occluded, x, y, z, q[0..3]
+
+// the writer's segment
+static uint8_t* base = NULL;
+static rc_posebus_header_t* header = NULL;
+static char segment_name[SEGMENT_NAME_LEN];
+#ifdef _WIN32
+static HANDLE mapping = NULL;
+#endif
+
+
+// private local function declarations;
+static inline size_t __align(size_t n);
+static size_t __array_offset(uint32_t capacity, int array);
+static size_t __segment_size(uint32_t capacity, size_t* names_offset, size_t* slots_offset, size_t* slot_size);
+static void __segment_name(const char* name, char* out);
+static void __update_names(const rc_mocap_subject_t* subjects, uint32_t n);
+#ifndef _WIN32
+static int __remove_stale(const char* name);
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+static inline size_t __align(size_t n)
+{
+	return (n + 63) & ~(size_t)63;
+}
+
+
+// offset of an array from the start of its slot
+static size_t __array_offset(uint32_t capacity, int array)
+{
+	size_t off = __align(sizeof(rc_posebus_slot_t));
+
+	if(array == 0) return off;
+	off += __align((size_t)capacity * sizeof(uint16_t));
+	if(array == 1) return off;
+	off += __align(capacity);
+	return off + (array - 2) * __align((size_t)capacity * sizeof(float));
+}
+
+
+static size_t __segment_size(uint32_t capacity, size_t* names_offset, size_t* slots_offset, size_t* slot_size)
+{
+	*names_offset = __align(sizeof(rc_posebus_header_t));
+	*slots_offset = *names_offset + __align((size_t)capacity * RC_MOCAP_NAME_LEN);
+	*slot_size = __array_offset(capacity, NUM_ARRAYS);
+	return *slots_offset + RC_POSEBUS_SLOTS * *slot_size;
+}
+
+
+static void __segment_name(const char* name, char* out)
+{
+#ifdef _WIN32
+	snprintf(out, SEGMENT_NAME_LEN, "Local\\%s", name);
+#else
+	snprintf(out, SEGMENT_NAME_LEN, "/%s", name);
+#endif
+}
+
+
+// names change rarely, so the table's seqlock is only taken when one does
+static void __update_names(const rc_mocap_subject_t* subjects, uint32_t n)
+{
+	char* names = (char*)base + header->names_offset;
+	char* entry;
+	uint32_t i, seq;
+
+	for(i=0; i<n; i++){
+		if(subjects[i].index >= header->capacity) continue;
+		entry = names + (size_t)subjects[i].index * RC_MOCAP_NAME_LEN;
+		if(strncmp(entry, subjects[i].name, RC_MOCAP_NAME_LEN) == 0) continue;
+		seq = header->names_seq.load(std::memory_order_relaxed);
+		header->names_seq.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		strncpy(entry, subjects[i].name, RC_MOCAP_NAME_LEN - 1);
+		entry[RC_MOCAP_NAME_LEN - 1] = 0;
+		header->names_seq.store(seq + 2, std::memory_order_release);
+	}
+}
+
+
+#ifndef _WIN32
+// a segment left behind by a bridge that closed its bus or never finished
+// creating it is removed, one a bridge still has open is left alone
+static int __remove_stale(const char* name)
+{
+	struct stat st;
+	const rc_posebus_header_t* h;
+	int live = 0;
+
+	int fd = shm_open(name, O_RDONLY, 0);
+	if(fd < 0) return 0;
+	if(fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(rc_posebus_header_t)){
+		void* p = mmap(NULL, sizeof(rc_posebus_header_t), PROT_READ, MAP_SHARED, fd, 0);
+		if(p != MAP_FAILED){
+			h = (const rc_posebus_header_t*)p;
+			live = h->magic == RC_POSEBUS_MAGIC && h->open.load(std::memory_order_acquire);
+			munmap(p, sizeof(rc_posebus_header_t));
+		}
+	}
+	close(fd);
+	if(live) return -1;
+	shm_unlink(name);
+	return 0;
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR pose_bus.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_posebus_create(const char* name, int capacity)
+{
+	size_t size, names_offset, slots_offset, slot_size;
+
+	if(header != NULL){
+		fprintf(stderr, "ERROR: in rc_posebus_create, bus already created\n");
+		return -1;
+	}
+	if(capacity < 1 || capacity > 65536){
+		fprintf(stderr, "ERROR: in rc_posebus_create, capacity must be between 1 and 65536\n");
+		return -1;
+	}
+	size = __segment_size((uint32_t)capacity, &names_offset, &slots_offset, &slot_size);
+	__segment_name(name, segment_name);
+
+	// new segments come zeroed, which is a valid state for every field
+#ifdef _WIN32
+	mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+			(DWORD)((uint64_t)size >> 32), (DWORD)size, segment_name);
+	if(mapping == NULL){
+		fprintf(stderr, "ERROR: in rc_posebus_create, failed to create %s\n", segment_name);
+		return -1;
+	}
+	if(GetLastError() == ERROR_ALREADY_EXISTS){
+		fprintf(stderr, "ERROR: in rc_posebus_create, %s is already published by another bridge\n", segment_name);
+		CloseHandle(mapping);
+		mapping = NULL;
+		return -1;
+	}
+	base = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(base == NULL){
+		fprintf(stderr, "ERROR: in rc_posebus_create, failed to map %s\n", segment_name);
+		CloseHandle(mapping);
+		mapping = NULL;
+		return -1;
+	}
+#else
+	if(__remove_stale(segment_name)){
+		fprintf(stderr, "ERROR: in rc_posebus_create, %s is already published by another bridge, "
+				"remove /dev/shm%s if that bridge crashed\n", segment_name, segment_name);
+		return -1;
+	}
+	int fd = shm_open(segment_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if(fd < 0){
+		fprintf(stderr, "ERROR: in rc_posebus_create, failed to create %s\n", segment_name);
+		return -1;
+	}
+	if(ftruncate(fd, (off_t)size) < 0){
+		fprintf(stderr, "ERROR: in rc_posebus_create, failed to size %s\n", segment_name);
+		close(fd);
+		shm_unlink(segment_name);
+		return -1;
+	}
+	void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED){
+		fprintf(stderr, "ERROR: in rc_posebus_create, failed to map %s\n", segment_name);
+		shm_unlink(segment_name);
+		return -1;
+	}
+	base = (uint8_t*)p;
+#endif
+
+	header = (rc_posebus_header_t*)base;
+	header->version = RC_POSEBUS_VERSION;
+	header->capacity = (uint32_t)capacity;
+	header->num_slots = RC_POSEBUS_SLOTS;
+	header->size = size;
+	header->names_offset = names_offset;
+	header->slots_offset = slots_offset;
+	header->slot_size = slot_size;
+	header->open.store(1, std::memory_order_relaxed);
+	// readers check the magic before anything else
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = RC_POSEBUS_MAGIC;
+	return 0;
+}
+
+
+int rc_posebus_publish(const rc_mocap_frame_t* frame)
+{
+	const rc_mocap_subject_t* subjects = rc_mocap_frame_subjects(frame);
+	const rc_mocap_subject_t* s;
+	rc_posebus_slot_t* slot;
+	uint8_t* p;
+	uint16_t* index;
+	uint8_t* occluded;
+	float* f[NUM_ARRAYS - 2];
+	uint64_t n;
+	uint32_t i, k, seq, cap, count = 0;
+
+	if(header == NULL){
+		fprintf(stderr, "ERROR: in rc_posebus_publish, bus not created\n");
+		return -1;
+	}
+	cap = header->capacity;
+
+	// names first so readers can look up every index they find in the slot
+	__update_names(subjects, frame->subject_count);
+
+	n = header->published.load(std::memory_order_relaxed);
+	p = base + header->slots_offset + (n % RC_POSEBUS_SLOTS) * header->slot_size;
+	slot = (rc_posebus_slot_t*)p;
+	index = (uint16_t*)(p + __array_offset(cap, 0));
+	occluded = p + __array_offset(cap, 1);
+	for(k=0; k<NUM_ARRAYS-2; k++) f[k] = (float*)(p + __array_offset(cap, k + 2));
+
+	seq = slot->seq.load(std::memory_order_relaxed);
+	slot->seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for(i=0; i<frame->subject_count; i++){
+		s = &subjects[i];
+		if(s->index >= cap) continue;
+		index[count] = s->index;
+		occluded[count] = s->occluded ? 1 : 0;
+		f[0][count] = (float)s->translation[0];
+		f[1][count] = (float)s->translation[1];
+		f[2][count] = (float)s->translation[2];
+		for(k=0; k<4; k++) f[3 + k][count] = (float)s->quaternion[k];
+		count++;
+	}
+	slot->subject_count = count;
+	slot->frame_number = frame->frame_number;
+	slot->capture_usec = frame->capture_usec;
+	slot->latency_s = frame->latency_s;
+	slot->publish_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	slot->seq.store(seq + 2, std::memory_order_release);
+	header->published.store(n + 1, std::memory_order_release);
+	return (int)count;
+}
+
+
+void rc_posebus_destroy()
+{
+	if(header == NULL) return;
+	header->open.store(0, std::memory_order_release);
+#ifdef _WIN32
+	// the segment goes away once the last reader unmaps it
+	UnmapViewOfFile(base);
+	CloseHandle(mapping);
+	mapping = NULL;
+#else
+	munmap(base, header->size);
+	shm_unlink(segment_name);
+#endif
+	base = NULL;
+	header = NULL;
+}
+
+
+int rc_posebus_open(const char* name, rc_posebus_reader_t* reader)
+{
+	char full[SEGMENT_NAME_LEN];
+	const rc_posebus_header_t* h;
+	size_t size, names_offset, slots_offset, slot_size;
+
+	memset(reader, 0, sizeof(*reader));
+	__segment_name(name, full);
+#ifdef _WIN32
+	HANDLE m = OpenFileMappingA(FILE_MAP_READ, FALSE, full);
+	if(m == NULL){
+		fprintf(stderr, "ERROR: in rc_posebus_open, no bus named %s\n", full);
+		return -1;
+	}
+	h = (const rc_posebus_header_t*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+	if(h == NULL){
+		fprintf(stderr, "ERROR: in rc_posebus_open, failed to map %s\n", full);
+		CloseHandle(m);
+		return -1;
+	}
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(h, &info, sizeof(info));
+	reader->size = info.RegionSize;
+	reader->handle = m;
+#else
+	struct stat st;
+	int fd = shm_open(full, O_RDONLY, 0);
+	if(fd < 0){
+		fprintf(stderr, "ERROR: in rc_posebus_open, no bus named %s\n", full);
+		return -1;
+	}
+	if(fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(rc_posebus_header_t)){
+		fprintf(stderr, "ERROR: in rc_posebus_open, %s is not a pose bus\n", full);
+		close(fd);
+		return -1;
+	}
+	void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED){
+		fprintf(stderr, "ERROR: in rc_posebus_open, failed to map %s\n", full);
+		return -1;
+	}
+	h = (const rc_posebus_header_t*)p;
+	reader->size = (size_t)st.st_size;
+#endif
+	reader->header = h;
+
+	// the layout must be exactly what this version would have created
+	if(h->magic != RC_POSEBUS_MAGIC || h->version != RC_POSEBUS_VERSION ||
+			h->num_slots != RC_POSEBUS_SLOTS || h->capacity < 1 || h->capacity > 65536){
+		fprintf(stderr, "ERROR: in rc_posebus_open, %s is not a version %d pose bus\n", full, RC_POSEBUS_VERSION);
+		rc_posebus_close(reader);
+		return -1;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	size = __segment_size(h->capacity, &names_offset, &slots_offset, &slot_size);
+	if(h->size != size || size > reader->size || h->names_offset != names_offset ||
+			h->slots_offset != slots_offset || h->slot_size != slot_size){
+		fprintf(stderr, "ERROR: in rc_posebus_open, %s has an unexpected layout\n", full);
+		rc_posebus_close(reader);
+		return -1;
+	}
+	return 0;
+}
+
+
+int rc_posebus_read_latest(const rc_posebus_reader_t* reader, rc_posebus_frame_t* frame)
+{
+	const rc_posebus_header_t* h = reader->header;
+	const rc_posebus_slot_t* slot;
+	const uint8_t* p;
+	uint64_t n;
+	uint32_t s1, k, cap = h->capacity;
+
+	while(1){
+		if(!h->open.load(std::memory_order_acquire)) return RC_POSEBUS_CLOSED;
+		n = h->published.load(std::memory_order_acquire);
+		if(n == 0) return RC_POSEBUS_NO_FRAME;
+		p = (const uint8_t*)h + h->slots_offset + ((n - 1) % RC_POSEBUS_SLOTS) * h->slot_size;
+		slot = (const rc_posebus_slot_t*)p;
+
+		// seqlock read of the slot header, the arrays are checked later
+		s1 = slot->seq.load(std::memory_order_acquire);
+		if(s1 & 1) continue;
+		frame->subject_count = slot->subject_count;
+		frame->frame_number = slot->frame_number;
+		frame->capture_usec = slot->capture_usec;
+		frame->publish_ns = slot->publish_ns;
+		frame->latency_s = slot->latency_s;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(slot->seq.load(std::memory_order_relaxed) != s1) continue;
+		if(frame->subject_count > cap) continue;
+		break;
+	}
+
+	frame->index = (const uint16_t*)(p + __array_offset(cap, 0));
+	frame->occluded = p + __array_offset(cap, 1);
+	frame->x = (const float*)(p + __array_offset(cap, 2));
+	frame->y = (const float*)(p + __array_offset(cap, 3));
+	frame->z = (const float*)(p + __array_offset(cap, 4));
+	for(k=0; k<4; k++) frame->q[k] = (const float*)(p + __array_offset(cap, 5 + k));
+	frame->slot = slot;
+	frame->seq = s1;
+	return RC_POSEBUS_FRAME;
+}
+
+
+int rc_posebus_frame_valid(const rc_posebus_frame_t* frame)
+{
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return frame->slot->seq.load(std::memory_order_relaxed) == frame->seq;
+}
+
+
+int rc_posebus_subject_name(const rc_posebus_reader_t* reader, int index, char* name)
+{
+	const rc_posebus_header_t* h = reader->header;
+	const char* entry;
+	uint32_t s1, s2;
+
+	if(index < 0 || (uint32_t)index >= h->capacity) return -1;
+	entry = (const char*)h + h->names_offset + (size_t)index * RC_MOCAP_NAME_LEN;
+	do{
+		s1 = h->names_seq.load(std::memory_order_acquire);
+		if(s1 & 1) continue;
+		memcpy(name, entry, RC_MOCAP_NAME_LEN);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		s2 = h->names_seq.load(std::memory_order_relaxed);
+	}while((s1 & 1) || s1 != s2);
+	name[RC_MOCAP_NAME_LEN - 1] = 0;
+	return 0;
+}
+
+
+void rc_posebus_close(rc_posebus_reader_t* reader)
+{
+	if(reader->header == NULL) return;
+#ifdef _WIN32
+	UnmapViewOfFile(reader->header);
+	CloseHandle((HANDLE)reader->handle);
+#else
+	munmap((void*)reader->header, reader->size);
+#endif
+	memset(reader, 0, sizeof(*reader));
+}
@@ -0,0 +1,196 @@
+/**
+* @file rc_bench_codec
+*
+* @brief      Measures the MAVLink codec per message type on the testsuite's
+*             packet_in values.
+*
+*             For every message the testsuite sends (see
+*             rc_bench_codec_vectors) this times, in ns per message and wire
+*             megabytes per second:
+*               encode     mavlink_msg_x_encode, which is mavlink_msg_x_pack
+*               send_buf   mavlink_msg_to_send_buffer
+*               parse      mavlink_parse_char, one byte at a time
+*               frame      mavlink_frame_char_buffer on a caller's buffer,
+*                          without the channel lookup
+*               decode     mavlink_msg_x_decode
+*               rc_pack    rc_mav_pack from mavlink_traits.h
+*               rc_unpack  rc_mav_unpack
+*
+*             Results go to stdout as CSV, one line per message and
+*             operation, so runs can be diffed when the CRC, parser or
+*             serializer change. A summary of the mean over all messages goes
+*             to stderr.
+*
+*             Usage: rc_bench_codec [iterations] [message], 20000 iterations
+*             of every message by default, or only the message named (for
+*             example GPS_INPUT)
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "../include/rc/mavlink_traits.h"
+
+#define DEFAULT_ITERATIONS	20000
+#define MAX_VECTORS		512
+
+extern "C" int rc_bench_codec_vectors(mavlink_message_t* out, int max);
+
+enum { OP_ENCODE, OP_SEND_BUF, OP_PARSE, OP_FRAME, OP_DECODE, OP_RC_PACK, OP_RC_UNPACK, NUM_OPS };
+static const char* op_names[NUM_OPS] = {
+	"encode", "send_buf", "parse", "frame", "decode", "rc_pack", "rc_unpack"
+};
+
+static int iterations;
+static const char* only = NULL;
+static double total_ns[NUM_OPS];
+static int measured = 0;
+// folds every result in so nothing is optimized away
+static volatile uint32_t sink;
+
+
+// private local function declarations;
+static double __ns_since(std::chrono::steady_clock::time_point start);
+static void __print(const char* name, uint32_t id, int wire_len, const double ns[NUM_OPS]);
+template<typename Msg> static void __bench(const mavlink_message_t* vec,
+			uint16_t (*encode)(uint8_t, uint8_t, mavlink_message_t*, const Msg*),
+			void (*decode)(const mavlink_message_t*, Msg*));
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static double __ns_since(std::chrono::steady_clock::time_point start)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+}
+
+
+static void __print(const char* name, uint32_t id, int wire_len, const double ns[NUM_OPS])
+{
+	int k;
+
+	for(k=0; k<NUM_OPS; k++){
+		printf("%s,%u,%d,%s,%.2f,%.1f\n", name, (unsigned)id, wire_len, op_names[k],
+			ns[k], wire_len * 1000.0 / ns[k]);
+		total_ns[k] += ns[k];
+	}
+	measured++;
+}
+
+
+template<typename Msg>
+static void __bench(const mavlink_message_t* vec, uint16_t (*encode)(uint8_t, uint8_t, mavlink_message_t*, const Msg*),
+			void (*decode)(const mavlink_message_t*, Msg*))
+{
+	typedef rc_mav_msg<Msg> T;
+	mavlink_message_t msg, rx, out;
+	mavlink_status_t status, rx_status;
+	rc_mav_packet_t pkt;
+	uint8_t wire[MAVLINK_MAX_PACKET_LEN];
+	double ns[NUM_OPS];
+	Msg m;
+	uint32_t acc = 0;
+	int i, j, n;
+
+	if(only != NULL && strcmp(only, T::name()) != 0) return;
+	decode(vec, &m);
+	encode(vec->sysid, vec->compid, &msg, &m);
+	n = mavlink_msg_to_send_buffer(wire, &msg);
+
+	auto start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++){
+		encode(vec->sysid, vec->compid, &msg, &m);
+		acc += msg.checksum;
+	}
+	ns[OP_ENCODE] = __ns_since(start) / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++) acc += mavlink_msg_to_send_buffer(wire, &msg);
+	ns[OP_SEND_BUF] = __ns_since(start) / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++){
+		for(j=0; j<n; j++) acc += mavlink_parse_char(MAVLINK_COMM_0, wire[j], &out, &status);
+	}
+	ns[OP_PARSE] = __ns_since(start) / iterations;
+
+	memset(&rx, 0, sizeof(rx));
+	memset(&rx_status, 0, sizeof(rx_status));
+	start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++){
+		for(j=0; j<n; j++) acc += mavlink_frame_char_buffer(&rx, &rx_status, wire[j], &out, &status);
+	}
+	ns[OP_FRAME] = __ns_since(start) / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++){
+		decode(&out, &m);
+		acc += *(uint8_t*)&m;
+	}
+	ns[OP_DECODE] = __ns_since(start) / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++){
+		rc_mav_pack(&pkt, 0, 0, vec->sysid, (uint8_t)i, m);
+		acc += pkt.len;
+	}
+	ns[OP_RC_PACK] = __ns_since(start) / iterations;
+
+	start = std::chrono::steady_clock::now();
+	for(i=0; i<iterations; i++){
+		rc_mav_unpack(&out, &m);
+		acc += *(uint8_t*)&m;
+	}
+	ns[OP_RC_UNPACK] = __ns_since(start) / iterations;
+
+	sink += acc;
+	__print(T::name(), T::id, n, ns);
+}
+
+
+int main(int argc, char * argv[])
+{
+	std::vector<mavlink_message_t> vectors(MAX_VECTORS);
+	int i, k, n;
+
+	iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+	if(argc > 2) only = argv[2];
+	if(iterations < 1){
+		fprintf(stderr, "usage: rc_bench_codec [iterations] [message]\n");
+		return -1;
+	}
+	n = rc_bench_codec_vectors(vectors.data(), MAX_VECTORS);
+
+	printf("message,id,wire_bytes,op,ns_per_msg,mbytes_per_s\n");
+	for(i=0; i<n; i++){
+		switch(vectors[i].msgid){
+#define RC_BENCH_CASE(lower, NAME) \
+		case MAVLINK_MSG_ID_##NAME: \
+			__bench<mavlink_##lower##_t>(&vectors[i], mavlink_msg_##lower##_encode, mavlink_msg_##lower##_decode); \
+			break;
+		RC_MAV_MESSAGES(RC_BENCH_CASE)
+#undef RC_BENCH_CASE
+		default:
+			fprintf(stderr, "message %u has no traits, skipped\n", (unsigned)vectors[i].msgid);
+		}
+	}
+	if(measured == 0){
+		fprintf(stderr, "ERROR: no message measured\n");
+		return -1;
+	}
+
+	fprintf(stderr, "%d messages of %d in the testsuite, %d iterations, mean ns per message:\n",
+		measured, n, iterations);
+	for(k=0; k<NUM_OPS; k++) fprintf(stderr, "%10s", op_names[k]);
+	fprintf(stderr, "\n");
+	for(k=0; k<NUM_OPS; k++) fprintf(stderr, "%10.1f", total_ns[k] / measured);
+	fprintf(stderr, "\n");
+	return 0;
+}
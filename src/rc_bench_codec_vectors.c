@@ -0,0 +1,61 @@
+/**
+* @file rc_bench_codec_vectors
+*
+* @brief      The packet_in values of the MAVLink testsuite as parsed
+*             messages, for rc_bench_codec and rc_check_traits.
+*
+*             testsuite.h's initializers narrow integer constants, which C
+*             accepts and C++ doesn't, so it is run from this C file. Every
+*             packet the testsuite sends is parsed as it goes out and the
+*             first one of each message id is kept.
+*
+* @date       10/18/2026
+*/
+
+#include <string.h>
+
+// the testsuite sends through comm_send_ch
+#define MAVLINK_USE_CONVENIENCE_FUNCTIONS
+#include "../include/rc/mavlink/mavlink_types.h"
+static mavlink_system_t mavlink_system = {42, 11};
+static void comm_send_ch(mavlink_channel_t chan, uint8_t c);
+
+#include "../include/rc/mavlink/common/mavlink.h"
+#include "../include/rc/mavlink/common/testsuite.h"
+
+static mavlink_message_t last_msg;
+static mavlink_message_t* vectors;
+static int max_vectors;
+static int num_vectors;
+static uint8_t seen[65536 / 8];
+
+
+static void comm_send_ch(mavlink_channel_t chan, uint8_t c)
+{
+	mavlink_status_t status;
+
+	if(!mavlink_parse_char(chan, c, &last_msg, &status)) return;
+	if(seen[last_msg.msgid / 8] & (1 << (last_msg.msgid % 8))) return;
+	seen[last_msg.msgid / 8] |= (uint8_t)(1 << (last_msg.msgid % 8));
+	if(num_vectors < max_vectors) vectors[num_vectors++] = last_msg;
+}
+
+
+/**
+ * @brief      Runs the testsuite and returns the first message of each id it
+ *             sent, in the order sent.
+ *
+ * @param[out] out  Room for max messages
+ * @param[in]  max  Size of out
+ *
+ * @return     Number of messages written to out
+ */
+int rc_bench_codec_vectors(mavlink_message_t* out, int max)
+{
+	vectors = out;
+	max_vectors = max;
+	num_vectors = 0;
+	memset(seen, 0, sizeof(seen));
+	mavlink_test_all(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	return num_vectors;
+}
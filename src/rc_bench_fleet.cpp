@@ -0,0 +1,503 @@
+/**
+* @file rc_bench_fleet
+*
+* @brief      End-to-end loopback test of the bridge with a simulated fleet,
+*             measuring what vehicles actually receive.
+*
+*             For each fleet size a synthetic source of that many subjects
+*             drives the bridge in real time, routed to one UDP port per
+*             vehicle on 127.0.0.1. A receiver thread parses ATT_POS_MOCAP
+*             on every port. Every subject is due every frame, so the
+*             sequence number of a packet, unwrapped, is the frame it came
+*             from, and its latency is the time it was received less the
+*             capture time of that frame. On Linux the time received is the
+*             kernel's SO_TIMESTAMP of the packet reaching the vehicle's
+*             socket, so a receiver thread waiting for a core doesn't count.
+*             Per vehicle this reports latency,
+*             jitter (mean difference of consecutive latencies, in arrival
+*             order), frames whose packet never arrived and packets that
+*             arrived after a later one.
+*
+*             One summary line per fleet size with the latency of all
+*             vehicles pooled and the worst vehicle's p99, and with -v a line
+*             per vehicle.
+*
+*             -b starts threads that keep every core busy sweeping buffers
+*             larger than the caches, and -x runs the bridge in real-time
+*             mode (see realtime.h) with its buffers preallocated for the
+*             fleet, so the p99.9 of the two can be compared under load.
+*
+* @date       10/18/2026
+*/
+
+#ifdef _WIN32
+#define FD_SETSIZE	1024	// one socket per vehicle, before WinSock2.h
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../include/rc/net_platform.h"
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/mocap_source.h"
+#include "../include/rc/routing.h"
+#include "../include/rc/bridge_pipeline.h"
+#include "../include/rc/realtime.h"
+
+#define DEFAULT_SECONDS		3.0
+#define DEFAULT_RATE_HZ		100.0
+#define MAX_VEHICLES		1000
+#define BRIDGE_PORT		14599	// the bridge's own socket, nothing listens here
+#define FIRST_VEHICLE_PORT	24600
+#define DRAIN_MS		200	// after the last frame
+#define SELECT_TIMEOUT_US	10000
+#define ROUTES_PATH		"rc_bench_fleet_routes.txt"
+#define STRESS_BYTES		(8 * 1024 * 1024)	// swept by each stress thread
+
+typedef struct sample_t{
+	int64_t frame;
+	uint64_t recv_usec;
+} sample_t;
+
+typedef struct vehicle_t{
+	rc_socket_t sock;
+	mavlink_message_t rx;
+	mavlink_status_t rx_status;
+	int64_t last;		// highest frame received, -1 before the first
+	int reordered;
+	std::vector<sample_t> samples;
+} vehicle_t;
+
+typedef struct vehicle_stats_t{
+	int received;
+	int lost;
+	int reordered;
+	double mean_us;
+	double p99_us;
+	double max_us;
+	double jitter_us;
+} vehicle_stats_t;
+
+static std::vector<vehicle_t> vehicles;
+static std::vector<uint64_t> capture_usec;	// of every frame sent
+static std::atomic<int> receiving;
+static std::atomic<int> stressing;
+static int verbose = 0;
+static int realtime = 0;
+
+
+// private local function declarations;
+static uint64_t __now_usec();
+static int __open_vehicles(int n);
+static void __close_vehicles();
+static void __receive_loop();
+static void __receive(vehicle_t* v, uint64_t now);
+static void __stress_loop();
+static void __stop_stress(std::vector<std::thread>& threads);
+static int __write_routes(const rc_mocap_frame_t* frame);
+static void __stats(const vehicle_t* v, std::vector<double>* pooled, vehicle_stats_t* s);
+static int __run(int n, double seconds, double rate_hz, int workers);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+// the synthetic source stamps frames with the system clock
+static uint64_t __now_usec()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+static int __open_vehicles(int n)
+{
+	struct sockaddr_in addr;
+	int i;
+
+	vehicles.clear();
+	vehicles.resize(n);
+	for(i=0; i<n; i++){
+		memset(&vehicles[i].rx, 0, sizeof(vehicles[i].rx));
+		memset(&vehicles[i].rx_status, 0, sizeof(vehicles[i].rx_status));
+		vehicles[i].last = -1;
+		vehicles[i].reordered = 0;
+		vehicles[i].sock = RC_INVALID_SOCKET;
+	}
+	for(i=0; i<n; i++){
+		vehicles[i].sock = socket(AF_INET, SOCK_DGRAM, 0);
+		if(vehicles[i].sock == RC_INVALID_SOCKET){
+			fprintf(stderr, "ERROR: in rc_bench_fleet, socket failed\n");
+			return -1;
+		}
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons((uint16_t)(FIRST_VEHICLE_PORT + i));
+		if(bind(vehicles[i].sock, (struct sockaddr*)&addr, sizeof(addr)) < 0){
+			fprintf(stderr, "ERROR: in rc_bench_fleet, can't bind port %d\n", FIRST_VEHICLE_PORT + i);
+			return -1;
+		}
+#ifdef __linux__
+		int on = 1;
+		if(setsockopt(vehicles[i].sock, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on)) < 0){
+			perror("ERROR: in rc_bench_fleet, SO_TIMESTAMP failed");
+			return -1;
+		}
+#endif
+	}
+	return 0;
+}
+
+
+static void __close_vehicles()
+{
+	size_t i;
+
+	for(i=0; i<vehicles.size(); i++){
+		if(vehicles[i].sock != RC_INVALID_SOCKET) rc_sock_close(vehicles[i].sock);
+	}
+	vehicles.clear();
+}
+
+
+static void __receive_loop()
+{
+	fd_set fds;
+	struct timeval tv;
+	int i, n = (int)vehicles.size();
+	int max_fd = 0;
+
+	rc_rt_enter(RC_RT_RECEIVE);
+	// only POSIX uses the highest descriptor
+	for(i=0; i<n; i++) if((int)vehicles[i].sock > max_fd) max_fd = (int)vehicles[i].sock;
+	while(receiving.load()){
+		FD_ZERO(&fds);
+		for(i=0; i<n; i++) FD_SET(vehicles[i].sock, &fds);
+		tv.tv_sec = 0;
+		tv.tv_usec = SELECT_TIMEOUT_US;
+		if(select(max_fd + 1, &fds, NULL, NULL, &tv) <= 0) continue;
+		for(i=0; i<n; i++){
+			if(FD_ISSET(vehicles[i].sock, &fds)) __receive(&vehicles[i], __now_usec());
+		}
+	}
+}
+
+
+static void __receive(vehicle_t* v, uint64_t now)
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	mavlink_message_t msg = {};
+	mavlink_status_t status;
+	sample_t s;
+	int i, len;
+
+#ifdef __linux__
+	// when the packet reached the socket rather than when it was read
+	char control[CMSG_SPACE(sizeof(struct timeval))];
+	struct iovec iov;
+	struct msghdr hdr;
+	struct cmsghdr* c;
+
+	iov.iov_base = buf;
+	iov.iov_len = sizeof(buf);
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.msg_iov = &iov;
+	hdr.msg_iovlen = 1;
+	hdr.msg_control = control;
+	hdr.msg_controllen = sizeof(control);
+	len = (int)recvmsg(v->sock, &hdr, 0);
+	for(c=CMSG_FIRSTHDR(&hdr); len>0 && c!=NULL; c=CMSG_NXTHDR(&hdr, c)){
+		if(c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_TIMESTAMP) continue;
+		struct timeval tv;
+		memcpy(&tv, CMSG_DATA(c), sizeof(tv));
+		now = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+	}
+#else
+	len = recvfrom(v->sock, (char*)buf, sizeof(buf), 0, NULL, NULL);
+#endif
+	for(i=0; i<len; i++){
+		if(mavlink_frame_char_buffer(&v->rx, &v->rx_status, buf[i], &msg, &status) != MAVLINK_FRAMING_OK) continue;
+		if(msg.msgid != MAVLINK_MSG_ID_ATT_POS_MOCAP) continue;
+		// the first packet is assumed within 256 frames of the start,
+		// every other one within 128 of the highest so far
+		if(v->last < 0) s.frame = msg.seq;
+		else s.frame = v->last + (int8_t)(uint8_t)(msg.seq - (uint8_t)v->last);
+		if(s.frame < v->last) v->reordered++;
+		else v->last = s.frame;
+		s.recv_usec = now;
+		v->samples.push_back(s);
+	}
+}
+
+
+// at the normal priority, so real-time threads preempt it
+static void __stress_loop()
+{
+	std::vector<uint8_t> buf(STRESS_BYTES, 1);
+	volatile uint8_t sink = 0;
+	size_t i;
+
+	while(stressing.load(std::memory_order_relaxed)){
+		for(i=0; i<buf.size(); i+=64) buf[i] = (uint8_t)(buf[i] * 3 + 1);
+		sink = sink + buf[buf.size() / 2];
+	}
+}
+
+
+
+static void __stop_stress(std::vector<std::thread>& threads)
+{
+	size_t i;
+
+	stressing.store(0);
+	for(i=0; i<threads.size(); i++) threads[i].join();
+	threads.clear();
+}
+
+
+static int __write_routes(const rc_mocap_frame_t* frame)
+{
+	const rc_mocap_subject_t* subjects = rc_mocap_frame_subjects(frame);
+	FILE* f;
+	uint32_t i;
+
+	f = fopen(ROUTES_PATH, "w");
+	if(f == NULL){
+		fprintf(stderr, "ERROR: in rc_bench_fleet, can't write %s\n", ROUTES_PATH);
+		return -1;
+	}
+	for(i=0; i<frame->subject_count; i++){
+		fprintf(f, "%s 127.0.0.1:%d\n", subjects[i].name, FIRST_VEHICLE_PORT + (int)i);
+	}
+	fclose(f);
+	return 0;
+}
+
+
+static void __stats(const vehicle_t* v, std::vector<double>* pooled, vehicle_stats_t* s)
+{
+	std::vector<int64_t> frames;
+	std::vector<double> lat;
+	double prev = 0.0, jitter = 0.0, sum = 0.0;
+	size_t i, unique;
+
+	memset(s, 0, sizeof(*s));
+	s->received = (int)v->samples.size();
+	s->reordered = v->reordered;
+	s->lost = (int)capture_usec.size();
+	if(v->samples.empty()) return;
+
+	for(i=0; i<v->samples.size(); i++){
+		const sample_t* p = &v->samples[i];
+		if(p->frame < 0 || p->frame >= (int64_t)capture_usec.size()) continue;
+		double us = (double)(int64_t)(p->recv_usec - capture_usec[p->frame]);
+		if(!lat.empty()) jitter += fabs(us - prev);
+		prev = us;
+		sum += us;
+		lat.push_back(us);
+		frames.push_back(p->frame);
+	}
+	if(lat.empty()) return;
+
+	// every frame sent carried one pose for every vehicle
+	std::sort(frames.begin(), frames.end());
+	unique = std::unique(frames.begin(), frames.end()) - frames.begin();
+	s->lost = (int)(capture_usec.size() - unique);
+
+	s->mean_us = sum / lat.size();
+	s->jitter_us = lat.size() > 1 ? jitter / (lat.size() - 1) : 0.0;
+	pooled->insert(pooled->end(), lat.begin(), lat.end());
+	std::sort(lat.begin(), lat.end());
+	s->p99_us = lat[(size_t)(0.99 * (lat.size() - 1))];
+	s->max_us = lat.back();
+}
+
+
+static int __run(int n, double seconds, double rate_hz, int workers)
+{
+	const rc_mocap_frame_t* frame;
+	std::vector<double> pooled;
+	vehicle_stats_t s;
+	MocapSource* source;
+	double worst_p99 = 0.0, jitter = 0.0;
+	int64_t lost = 0, reordered = 0, received = 0;
+	int i, frames = (int)(seconds * rate_hz);
+
+	source = rc_mocap_synthetic_source_create(n, rate_hz);
+	if(source == NULL) return -1;
+	// the names come with the first frame, which isn't sent
+	source->next_frame(&frame);
+	if(__write_routes(frame) || rc_route_start(ROUTES_PATH) < 0 || __open_vehicles(n)){
+		delete source;
+		__close_vehicles();
+		return -1;
+	}
+	if(rc_bridge_init(workers, RC_BRIDGE_DEFAULT_CHUNK) ||
+	   (realtime && rc_bridge_reserve(n))){
+		delete source;
+		__close_vehicles();
+		rc_route_stop();
+		return -1;
+	}
+
+	capture_usec.clear();
+	capture_usec.reserve(frames);
+	for(i=0; i<n; i++) vehicles[i].samples.reserve(frames);
+	receiving = 1;
+	std::thread receiver(__receive_loop);
+	for(i=0; i<frames; i++){
+		source->next_frame(&frame);
+		capture_usec.push_back(frame->capture_usec);
+		rc_bridge_process_frame(frame);
+		rc_bridge_run_timers();
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_MS));
+	receiving = 0;
+	receiver.join();
+	rc_bridge_cleanup();
+	rc_route_stop();
+	delete source;
+
+	for(i=0; i<n; i++){
+		__stats(&vehicles[i], &pooled, &s);
+		received += s.received;
+		lost += s.lost;
+		reordered += s.reordered;
+		jitter += s.jitter_us;
+		if(s.p99_us > worst_p99) worst_p99 = s.p99_us;
+		if(verbose){
+			printf("     %6d %8d %6d %6d %9.1f %9.1f %9.1f %9.1f\n", i, s.received, s.lost,
+				s.reordered, s.mean_us, s.p99_us, s.max_us, s.jitter_us);
+		}
+	}
+	__close_vehicles();
+	if(pooled.empty()){
+		printf("%8d %8d   nothing received\n", n, frames);
+		return 0;
+	}
+	std::sort(pooled.begin(), pooled.end());
+	printf("%8d %8d %8lld %6.2f%% %7lld %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", n, frames,
+		(long long)received, 100.0 * lost / ((double)n * frames), (long long)reordered,
+		pooled[pooled.size() / 2], pooled[(size_t)(0.99 * (pooled.size() - 1))],
+		pooled[(size_t)(0.999 * (pooled.size() - 1))], pooled.back(), worst_p99, jitter / n);
+	return 0;
+}
+
+
+void print_usage()
+{
+	printf("\n");
+	printf("Usage: rc_bench_fleet [options] [vehicles ...]\n");
+	printf("Runs 1, 10, 100 and 500 vehicles unless fleet sizes are given\n");
+	printf("Options\n");
+	printf("-s {seconds}      length of each run (default %.0f)\n", DEFAULT_SECONDS);
+	printf("-r {rate}         frame rate in Hz (default %.0f)\n", DEFAULT_RATE_HZ);
+	printf("-w {workers}      bridge worker threads (default 1)\n");
+	printf("-b {threads}      background threads keeping the cores busy (default 0)\n");
+	printf("-x {a,s,r}        real-time mode, send and receive threads pinned to cores s and r,\n");
+	printf("                  -1 leaves a thread unpinned\n");
+	printf("-v                also print every vehicle\n");
+	printf("-h                print this help message\n");
+	printf("\n");
+}
+
+
+int main(int argc, char * argv[])
+{
+	std::vector<int> sizes;
+	double seconds = DEFAULT_SECONDS;
+	double rate_hz = DEFAULT_RATE_HZ;
+	int workers = 1;
+	int stress = 0;
+	std::vector<std::thread> stress_threads;
+	rc_rt_config_t rt_config;
+	size_t k;
+	int i;
+
+	rc_rt_default_config(&rt_config);
+
+	for(i=1; i<argc; i++){
+		if(strcmp(argv[i], "-h") == 0){
+			print_usage();
+			return 0;
+		}
+		else if(strcmp(argv[i], "-v") == 0){
+			verbose = 1;
+		}
+		else if(argv[i][0] != '-'){
+			sizes.push_back(atoi(argv[i]));
+		}
+		else if(i + 1 >= argc){
+			fprintf(stderr, "option %s needs an argument\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+		else if(strcmp(argv[i], "-s") == 0) seconds = atof(argv[++i]);
+		else if(strcmp(argv[i], "-r") == 0) rate_hz = atof(argv[++i]);
+		else if(strcmp(argv[i], "-w") == 0) workers = atoi(argv[++i]);
+		else if(strcmp(argv[i], "-b") == 0) stress = atoi(argv[++i]);
+		else if(strcmp(argv[i], "-x") == 0){
+			if(rc_rt_parse_cores(argv[++i], &rt_config)) return -1;
+			realtime = 1;
+		}
+		else{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+	}
+	if(sizes.empty()){
+		sizes.push_back(1);
+		sizes.push_back(10);
+		sizes.push_back(100);
+		sizes.push_back(500);
+	}
+	if(seconds <= 0.0 || rate_hz <= 0.0 || workers < 1 || stress < 0){
+		print_usage();
+		return -1;
+	}
+	for(k=0; k<sizes.size(); k++){
+		if(sizes[k] < 1 || sizes[k] > MAX_VEHICLES){
+			fprintf(stderr, "fleet sizes go from 1 to %d\n", MAX_VEHICLES);
+			return -1;
+		}
+	}
+	// started first so they don't inherit a real-time priority
+	stressing.store(1);
+	for(i=0; i<stress; i++) stress_threads.push_back(std::thread(__stress_loop));
+	if(realtime){
+		rc_rt_start(&rt_config);
+		rc_rt_enter(RC_RT_SEND);
+	}
+	if(rc_mav_init(1, "127.0.0.1", BRIDGE_PORT)){
+		__stop_stress(stress_threads);
+		return -1;
+	}
+
+	printf("%.0fHz for %.1fs per fleet, %d workers, %d stress threads, %s, latency from capture to receive in us\n",
+		rate_hz, seconds, workers, stress, realtime ? "real-time" : "normal scheduling");
+	printf("vehicles   frames received   lost reorder       p50       p99     p99.9       max worst p99    jitter\n");
+	for(k=0; k<sizes.size(); k++){
+		if(verbose) printf("    vehicle received   lost reorder      mean       p99       max    jitter\n");
+		if(__run(sizes[k], seconds, rate_hz, workers)){
+			fprintf(stderr, "ERROR: run of %d vehicles failed\n", sizes[k]);
+			remove(ROUTES_PATH);
+			rc_mav_cleanup();
+			__stop_stress(stress_threads);
+			return -1;
+		}
+	}
+	remove(ROUTES_PATH);
+	rc_mav_cleanup();
+	__stop_stress(stress_threads);
+	rc_rt_stop();
+	return 0;
+}
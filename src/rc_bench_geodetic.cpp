@@ -0,0 +1,89 @@
+/**
+* @file rc_bench_geodetic
+*
+* @brief      Measures rc_geo_from_ned against the exact conversion.
+*
+*             Positions are spread over a 100 x 100 m arena centered on the
+*             origin and up to 30m above it, at origins from the equator to
+*             the arctic. Each is converted in one batch and then one by one
+*             the exact way, and the time per position of both and the worst
+*             difference in millimeters north, east and up are printed.
+*
+*             Usage: rc_bench_geodetic [positions], 100000 by default
+*
+* @date       10/18/2026
+*/
+
+#define _USE_MATH_DEFINES	// for M_PI
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include "../include/rc/geodetic.h"
+
+#define DEFAULT_POSITIONS	100000
+#define ARENA_M			100.0f
+#define HEIGHT_M		30.0f
+#define M_PER_DEG		111320.0	// close enough to turn errors into meters
+
+static const double origins[][3] = {
+	{0.0, 0.0, 0.0},
+	{47.397742, 8.545594, 488.0},
+	{-33.8688, 151.2093, 20.0},
+	{69.6492, 18.9553, 10.0},
+	{40.0, 179.9995, 0.0},
+};
+static const int num_origins = sizeof(origins) / sizeof(origins[0]);
+
+
+int main(int argc, char * argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : DEFAULT_POSITIONS;
+	std::vector<float> ned[3];
+	std::vector<double> lat, lon, alt;
+	double exact[3], p[3], err[3], worst[3];
+	double fast_ns, exact_ns;
+	int i, k, o;
+
+	if(count < 1){
+		fprintf(stderr, "usage: rc_bench_geodetic [positions]\n");
+		return -1;
+	}
+	srand(1);
+	for(k=0; k<3; k++) ned[k].resize(count);
+	for(i=0; i<count; i++){
+		ned[0][i] = ARENA_M * (rand() / (float)RAND_MAX - 0.5f);
+		ned[1][i] = ARENA_M * (rand() / (float)RAND_MAX - 0.5f);
+		ned[2][i] = -HEIGHT_M * rand() / (float)RAND_MAX;
+	}
+	lat.resize(count);
+	lon.resize(count);
+	alt.resize(count);
+
+	printf("%d positions in a %.0fm arena\n", count, ARENA_M);
+	printf("   origin lat      lon   batch(ns) exact(ns)  worst error north east up (mm)\n");
+	for(o=0; o<num_origins; o++){
+		rc_geo_set_origin(origins[o][0], origins[o][1], origins[o][2]);
+		auto t0 = std::chrono::steady_clock::now();
+		rc_geo_from_ned(ned[0].data(), ned[1].data(), ned[2].data(), count, lat.data(), lon.data(), alt.data());
+		auto t1 = std::chrono::steady_clock::now();
+		worst[0] = worst[1] = worst[2] = 0.0;
+		for(i=0; i<count; i++){
+			p[0] = ned[0][i];
+			p[1] = ned[1][i];
+			p[2] = ned[2][i];
+			rc_geo_exact(p, exact);
+			err[0] = (lat[i] - exact[0]) * M_PER_DEG;
+			err[1] = remainder(lon[i] - exact[1], 360.0) * M_PER_DEG * cos(exact[0] * M_PI / 180.0);
+			err[2] = alt[i] - exact[2];
+			for(k=0; k<3; k++) if(fabs(err[k]) > worst[k]) worst[k] = fabs(err[k]);
+		}
+		auto t2 = std::chrono::steady_clock::now();
+		fast_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / count;
+		exact_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / count;
+		printf("%13.4f %9.4f %9.1f %9.1f %12.6f %8.6f %8.6f\n", origins[o][0], origins[o][1],
+			fast_ns, exact_ns, worst[0] * 1000.0, worst[1] * 1000.0, worst[2] * 1000.0);
+	}
+	return 0;
+}
@@ -0,0 +1,245 @@
+/**
+* @file rc_bench_posebus
+*
+* @brief      Compares the latency of handing a frame of poses to a local
+*             consumer over the shared-memory pose bus and over loopback UDP.
+*
+*             Frames are sent one at a time and the next one only after the
+*             consumer thread has seen every pose of the previous one, so the
+*             numbers are the time from the bridge starting to publish a frame
+*             to a consumer holding all of it, without queueing.
+*
+*             Pose bus: rc_posebus_publish, then the reader finds the new frame
+*             with rc_posebus_read_latest, sums every array and checks
+*             rc_posebus_frame_valid.
+*
+*             UDP: one ATT_POS_MOCAP packet per subject, packed in advance, is
+*             sent to a socket on 127.0.0.1 and the reader receives and parses
+*             every packet, as a planner listening to the drone traffic would.
+*
+*             Usage: rc_bench_posebus [subjects] [frames]
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../include/rc/net_platform.h"
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/pose_bus.h"
+
+#define DEFAULT_SUBJECTS	256
+#define DEFAULT_FRAMES		2000
+#define BUS_NAME		"rc_bench_posebus"
+#define BENCH_PORT		14598
+#define ACK_TIMEOUT_NS		200000000ULL	// a frame not seen in this time is lost
+
+// shared between the publishing and the consuming thread
+static std::atomic<int> stop(0);
+static std::atomic<int64_t> acked(-1);
+static std::atomic<uint64_t> start_ns(0);
+static std::vector<double> latency_us;
+static int num_subjects;
+
+
+static uint64_t __now_ns()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+static void __ack(int64_t frame)
+{
+	if(frame < 0 || frame >= (int64_t)latency_us.size()) return;
+	latency_us[frame] = (__now_ns() - start_ns.load(std::memory_order_acquire)) / 1000.0;
+	acked.store(frame, std::memory_order_release);
+}
+
+
+static void __bus_reader()
+{
+	rc_posebus_reader_t reader;
+	rc_posebus_frame_t frame;
+	int64_t last = -1;
+	uint32_t i;
+	float sum;
+
+	if(rc_posebus_open(BUS_NAME, &reader)) return;
+	while(!stop.load(std::memory_order_relaxed)){
+		if(rc_posebus_read_latest(&reader, &frame) != RC_POSEBUS_FRAME ||
+				(int64_t)frame.frame_number == last){
+			std::this_thread::yield();
+			continue;
+		}
+		sum = 0.0f;
+		for(i=0; i<frame.subject_count; i++){
+			sum += frame.x[i] + frame.y[i] + frame.z[i];
+			sum += frame.q[0][i] + frame.q[1][i] + frame.q[2][i] + frame.q[3][i];
+		}
+		if(!rc_posebus_frame_valid(&frame) || sum != sum) continue;
+		last = (int64_t)frame.frame_number;
+		__ack(last);
+	}
+	rc_posebus_close(&reader);
+}
+
+
+static void __udp_reader(rc_socket_t sock)
+{
+	char buf[2048];
+	mavlink_message_t msg;
+	mavlink_status_t status;
+	mavlink_att_pos_mocap_t pose;
+	int64_t current = -1;
+	int i, len, count = 0;
+
+	memset(&status, 0, sizeof(status));
+	while(!stop.load(std::memory_order_relaxed)){
+		len = recvfrom(sock, buf, sizeof(buf), 0, NULL, NULL);
+		for(i=0; i<len; i++){
+			if(!mavlink_parse_char(MAVLINK_COMM_0, (uint8_t)buf[i], &msg, &status)) continue;
+			if(msg.msgid != MAVLINK_MSG_ID_ATT_POS_MOCAP) continue;
+			mavlink_msg_att_pos_mocap_decode(&msg, &pose);
+			// x carries the frame number
+			if((int64_t)pose.x != current){
+				current = (int64_t)pose.x;
+				count = 0;
+			}
+			if(++count == num_subjects) __ack(current);
+		}
+	}
+}
+
+
+// waits for the consumer to see frame f, returns 0 if it did
+static int __wait_ack(int64_t f)
+{
+	uint64_t t = __now_ns();
+
+	while(acked.load(std::memory_order_acquire) != f){
+		if(__now_ns() - t > ACK_TIMEOUT_NS) return -1;
+		std::this_thread::yield();
+	}
+	return 0;
+}
+
+
+static void __report(const char* name, int frames, int lost)
+{
+	std::vector<double> us;
+	double sum = 0.0;
+	int i;
+
+	for(i=0; i<frames; i++){
+		if(latency_us[i] < 0.0) continue;
+		us.push_back(latency_us[i]);
+		sum += latency_us[i];
+	}
+	if(us.empty()){
+		printf("%-10s every frame lost\n", name);
+		return;
+	}
+	std::sort(us.begin(), us.end());
+	printf("%-10s %10.1f %10.1f %10.1f %10.1f %8d\n", name, sum / us.size(),
+		us[us.size() / 2], us[(size_t)(us.size() * 0.99)], us.back(), lost);
+}
+
+
+int main(int argc, char * argv[])
+{
+	std::vector<uint64_t> buf;
+	std::vector<rc_mav_packet_t> packets;
+	rc_mocap_frame_t* frame;
+	rc_mocap_subject_t* subjects;
+	struct sockaddr_in addr;
+	std::thread consumer;
+	int frames = argc > 2 ? atoi(argv[2]) : DEFAULT_FRAMES;
+	int i, f, lost;
+	rc_socket_t tx, rx;
+	float q[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+
+	num_subjects = argc > 1 ? atoi(argv[1]) : DEFAULT_SUBJECTS;
+	if(num_subjects < 1 || num_subjects > RC_POSEBUS_DEFAULT_CAPACITY || frames < 1){
+		fprintf(stderr, "usage: rc_bench_posebus [subjects up to %d] [frames]\n", RC_POSEBUS_DEFAULT_CAPACITY);
+		return -1;
+	}
+
+	// one frame in the flat layout the sources deliver
+	buf.resize(rc_mocap_frame_size(num_subjects) / sizeof(uint64_t) + 1);
+	frame = (rc_mocap_frame_t*)buf.data();
+	frame->size = (uint32_t)rc_mocap_frame_size(num_subjects);
+	frame->subject_count = num_subjects;
+	subjects = (rc_mocap_subject_t*)(frame + 1);
+	for(i=0; i<num_subjects; i++){
+		snprintf(subjects[i].name, RC_MOCAP_NAME_LEN, "bench%04d@127.0.0.1", i);
+		subjects[i].index = (uint16_t)i;
+		subjects[i].quaternion[0] = 1.0;
+	}
+	latency_us.assign(frames, -1.0);
+	printf("%d subjects, %d frames\n", num_subjects, frames);
+	printf("transport   mean(us)    p50(us)    p99(us)    max(us)     lost\n");
+
+	// shared memory
+	if(rc_posebus_create(BUS_NAME, RC_POSEBUS_DEFAULT_CAPACITY)) return -1;
+	consumer = std::thread(__bus_reader);
+	lost = 0;
+	for(f=0; f<frames; f++){
+		frame->frame_number = f;
+		for(i=0; i<num_subjects; i++) subjects[i].translation[0] = f;
+		start_ns.store(__now_ns(), std::memory_order_release);
+		rc_posebus_publish(frame);
+		if(__wait_ack(f)) lost++;
+	}
+	stop.store(1);
+	consumer.join();
+	rc_posebus_destroy();
+	__report("pose bus", frames, lost);
+
+	// loopback UDP
+	if(rc_net_init() < 0) return -1;
+	tx = socket(AF_INET, SOCK_DGRAM, 0);
+	rx = socket(AF_INET, SOCK_DGRAM, 0);
+	if(tx == RC_INVALID_SOCKET || rx == RC_INVALID_SOCKET) return -1;
+	i = 4 << 20;
+	setsockopt(rx, SOL_SOCKET, SO_RCVBUF, (const char*)&i, sizeof(i));
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(BENCH_PORT);
+	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if(bind(rx, (struct sockaddr*)&addr, sizeof(addr)) < 0){
+		fprintf(stderr, "ERROR: failed to bind port %d\n", BENCH_PORT);
+		return -1;
+	}
+	packets.resize(num_subjects);
+	latency_us.assign(frames, -1.0);
+	acked.store(-1);
+	stop.store(0);
+	consumer = std::thread(__udp_reader, rx);
+	lost = 0;
+	for(f=0; f<frames; f++){
+		for(i=0; i<num_subjects; i++){
+			rc_mav_pack_att_pos_mocap(&packets[i], addr.sin_addr.s_addr, BENCH_PORT, 1, (uint8_t)f, q, (float)f, 0.0f, 0.0f);
+		}
+		start_ns.store(__now_ns(), std::memory_order_release);
+		for(i=0; i<num_subjects; i++){
+			sendto(tx, (const char*)packets[i].buf, packets[i].len, 0, (struct sockaddr*)&addr, sizeof(addr));
+		}
+		if(__wait_ack(f)) lost++;
+	}
+	// wake the reader out of recvfrom
+	stop.store(1);
+	sendto(tx, "", 1, 0, (struct sockaddr*)&addr, sizeof(addr));
+	consumer.join();
+	rc_sock_close(tx);
+	rc_sock_close(rx);
+	rc_net_cleanup();
+	__report("udp", frames, lost);
+	return 0;
+}
@@ -0,0 +1,286 @@
+/**
+* @file rc_bench_recv
+*
+* @brief      Floods the bridge's port with vehicle telemetry and measures how
+*             many packets per second the receive side keeps up with.
+*
+*             Sender threads send pre-packed 50 Hz style telemetry (ATTITUDE)
+*             as fast as they can from one loopback socket per simulated
+*             vehicle, so the kernel sees as many senders as a real fleet.
+*             Each run receives with rc_mav_receive_start and a number of
+*             receive threads, batched with recvmmsg and spread over
+*             SO_REUSEPORT sockets on Linux. A first run reads one packet per
+*             recvfrom and parses it with mavlink_parse_char, the way a plain
+*             receive thread would, as the baseline.
+*
+*             One line per run with packets sent and received, the total and
+*             per thread rate, and the smallest and largest share a thread
+*             got of the packets. Senders share the cores, so on small
+*             machines give fewer sender threads with -p.
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../include/rc/net_platform.h"
+#include "../include/rc/mavlink_traits.h"
+
+#define DEFAULT_SECONDS		2.0
+#define DEFAULT_VEHICLES	128
+#define DEFAULT_SENDERS		2
+#define MAX_VEHICLES		1000
+#define BENCH_PORT		14597
+#define DRAIN_MS		200	// after the senders stop
+#define BASELINE		0	// thread count of the recvfrom run
+
+typedef struct vehicle_t{
+	rc_socket_t sock;
+	rc_mav_packet_t pkt;
+} vehicle_t;
+
+static std::vector<vehicle_t> vehicles;
+static struct sockaddr_in bridge;
+static std::atomic<int> sending;
+static std::atomic<int> baseline_running;
+static std::atomic<uint64_t> baseline_received;
+
+
+// private local function declarations;
+static int __open_vehicles(int n);
+static void __close_vehicles();
+static void __send_loop(int first, int step, uint64_t* sent);
+static void __baseline_loop();
+static int __run(int threads, double seconds, int senders);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+static int __open_vehicles(int n)
+{
+	mavlink_attitude_t att;
+	int i;
+
+	memset(&att, 0, sizeof(att));
+	vehicles.resize(n);
+	for(i=0; i<n; i++) vehicles[i].sock = RC_INVALID_SOCKET;
+	for(i=0; i<n; i++){
+		vehicles[i].sock = socket(AF_INET, SOCK_DGRAM, 0);
+		if(vehicles[i].sock == RC_INVALID_SOCKET){
+			fprintf(stderr, "ERROR: in rc_bench_recv, socket failed\n");
+			return -1;
+		}
+		att.time_boot_ms = i;
+		att.roll = 0.01f * i;
+		if(rc_mav_pack(&vehicles[i].pkt, bridge.sin_addr.s_addr, BENCH_PORT,
+				(uint8_t)(i % 250 + 1), 0, att) < 0){
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+static void __close_vehicles()
+{
+	size_t i;
+
+	for(i=0; i<vehicles.size(); i++){
+		if(vehicles[i].sock != RC_INVALID_SOCKET) rc_sock_close(vehicles[i].sock);
+	}
+	vehicles.clear();
+}
+
+
+// every step-th vehicle from first, round robin
+static void __send_loop(int first, int step, uint64_t* sent)
+{
+	uint64_t n = 0;
+	int i;
+
+	while(sending.load(std::memory_order_relaxed)){
+		for(i=first; i<(int)vehicles.size(); i+=step){
+			if(sendto(vehicles[i].sock, (const char*)vehicles[i].pkt.buf, vehicles[i].pkt.len, 0,
+				(struct sockaddr*)&bridge, sizeof(bridge)) == vehicles[i].pkt.len) n++;
+		}
+	}
+	*sent = n;
+}
+
+
+// one recvfrom and one mavlink_parse_char pass per packet
+static void __baseline_loop()
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	mavlink_message_t msg;
+	mavlink_status_t status;
+	uint64_t n = 0;
+	int i, len;
+
+	while(baseline_running.load(std::memory_order_relaxed)){
+		if(rc_sock_wait_readable(rc_mav_socket(), 100) <= 0) continue;
+		len = recvfrom(rc_mav_socket(), (char*)buf, sizeof(buf), 0, NULL, NULL);
+		for(i=0; i<len; i++){
+			if(mavlink_parse_char(MAVLINK_COMM_0, buf[i], &msg, &status)) n++;
+		}
+	}
+	baseline_received.store(n);
+}
+
+
+static int __run(int threads, double seconds, int senders)
+{
+	std::vector<std::thread> send_threads(senders);
+	std::vector<uint64_t> sent(senders, 0);
+	uint64_t before[RC_MAV_MAX_RECEIVERS];
+	uint64_t got[RC_MAV_MAX_RECEIVERS];
+	uint64_t total_sent = 0, total = 0, least = 0, most = 0;
+	std::thread baseline;
+	int i, n = threads == BASELINE ? 1 : threads;
+
+	if(threads == BASELINE){
+		baseline_running.store(1);
+		baseline = std::thread(__baseline_loop);
+	}
+	else if(rc_mav_receive_start(threads)){
+		return -1;
+	}
+	for(i=0; i<n; i++) before[i] = rc_mav_received(i);
+
+	sending.store(1);
+	auto start = std::chrono::steady_clock::now();
+	for(i=0; i<senders; i++) send_threads[i] = std::thread(__send_loop, i, senders, &sent[i]);
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+	sending.store(0);
+	for(i=0; i<senders; i++){
+		send_threads[i].join();
+		total_sent += sent[i];
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_MS));
+
+	if(threads == BASELINE){
+		baseline_running.store(0);
+		baseline.join();
+		got[0] = baseline_received.load();
+	}
+	else{
+		for(i=0; i<n; i++) got[i] = rc_mav_received(i) - before[i];
+		rc_mav_receive_stop();
+	}
+	for(i=0; i<n; i++){
+		total += got[i];
+		if(i == 0 || got[i] < least) least = got[i];
+		if(got[i] > most) most = got[i];
+	}
+
+	if(threads == BASELINE) printf("recvfrom");
+	else printf("%8d", threads);
+	printf(" %11llu %11llu %6.2f%% %10.0f %10.0f %6.1f%% %6.1f%%\n",
+		(unsigned long long)total_sent, (unsigned long long)total,
+		total_sent ? 100.0 * (double)(total_sent - (total < total_sent ? total : total_sent)) / total_sent : 0.0,
+		total / elapsed, total / elapsed / n,
+		total ? 100.0 * least / total : 0.0, total ? 100.0 * most / total : 0.0);
+	return 0;
+}
+
+
+void print_usage()
+{
+	printf("\n");
+	printf("Usage: rc_bench_recv [options] [receive threads ...]\n");
+	printf("Runs the recvfrom baseline, then 1, 2 and 4 receive threads unless thread counts are given\n");
+	printf("Options\n");
+	printf("-s {seconds}      length of each run (default %.0f)\n", DEFAULT_SECONDS);
+	printf("-v {vehicles}     sending sockets (default %d)\n", DEFAULT_VEHICLES);
+	printf("-p {threads}      sender threads (default %d)\n", DEFAULT_SENDERS);
+	printf("-h                print this help message\n");
+	printf("\n");
+}
+
+
+int main(int argc, char * argv[])
+{
+	std::vector<int> runs;
+	double seconds = DEFAULT_SECONDS;
+	int num_vehicles = DEFAULT_VEHICLES;
+	int senders = DEFAULT_SENDERS;
+	int most_threads = 1;
+	size_t k;
+	int i;
+
+	for(i=1; i<argc; i++){
+		if(strcmp(argv[i], "-h") == 0){
+			print_usage();
+			return 0;
+		}
+		else if(argv[i][0] != '-'){
+			runs.push_back(atoi(argv[i]));
+		}
+		else if(i + 1 >= argc){
+			fprintf(stderr, "option %s needs an argument\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+		else if(strcmp(argv[i], "-s") == 0) seconds = atof(argv[++i]);
+		else if(strcmp(argv[i], "-v") == 0) num_vehicles = atoi(argv[++i]);
+		else if(strcmp(argv[i], "-p") == 0) senders = atoi(argv[++i]);
+		else{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+	}
+	if(runs.empty()){
+		runs.push_back(BASELINE);
+		runs.push_back(1);
+		runs.push_back(2);
+		runs.push_back(4);
+	}
+	if(seconds <= 0.0 || num_vehicles < 1 || num_vehicles > MAX_VEHICLES || senders < 1 || senders > num_vehicles){
+		print_usage();
+		return -1;
+	}
+	for(k=0; k<runs.size(); k++){
+		if(runs[k] < 1 || runs[k] > RC_MAV_MAX_RECEIVERS){
+			if(runs[k] == BASELINE) continue;
+			fprintf(stderr, "receive threads go from 1 to %d\n", RC_MAV_MAX_RECEIVERS);
+			return -1;
+		}
+		if(runs[k] > most_threads) most_threads = runs[k];
+	}
+
+	if(rc_mav_set_receive_threads(most_threads) || rc_mav_init(1, "127.0.0.1", BENCH_PORT)) return -1;
+	memset(&bridge, 0, sizeof(bridge));
+	bridge.sin_family = AF_INET;
+	bridge.sin_port = htons(BENCH_PORT);
+	bridge.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if(__open_vehicles(num_vehicles)){
+		__close_vehicles();
+		rc_mav_cleanup();
+		return -1;
+	}
+
+	printf("%d vehicles on %d sender threads, %.1fs per run, %u hardware threads\n",
+		num_vehicles, senders, seconds, std::thread::hardware_concurrency());
+	printf(" threads        sent    received   lost  packets/s per thread  least   most\n");
+	for(k=0; k<runs.size(); k++){
+		if(__run(runs[k], seconds, senders)){
+			fprintf(stderr, "ERROR: run with %d receive threads failed\n", runs[k]);
+			__close_vehicles();
+			rc_mav_cleanup();
+			return -1;
+		}
+	}
+	__close_vehicles();
+	rc_mav_cleanup();
+	return 0;
+}
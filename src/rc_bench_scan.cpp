@@ -0,0 +1,173 @@
+/**
+* @file rc_bench_scan
+*
+* @brief      Measures the obstacle scans per vehicle at several swarm sizes.
+*
+*             Vehicles fly straight at up to 2 m/s in a 20 x 20 x 3 m room with
+*             four pillars and bounce off its walls, advanced at 200Hz. Every
+*             frame rc_scan_build bins them and every vehicle gets a scan, and
+*             the mean, 99th percentile and worst time per vehicle are printed,
+*             the build included. The last frame is then scanned again the slow
+*             way, every sector against every obstacle with atan2 and asin, and
+*             the sectors reading more than 1cm apart are counted; only sectors
+*             an obstacle just touches may disagree.
+*
+*             Usage: rc_bench_scan [frames] [vehicles ...], 50 and 500 vehicles
+*             by default
+*
+* @date       10/18/2026
+*/
+
+#define _USE_MATH_DEFINES	// for M_PI
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "../include/rc/obstacle_scan.h"
+
+#define DEFAULT_FRAMES		400
+#define FRAME_HZ		200.0f
+#define ROOM_MM			{20000.0f, 20000.0f, 3000.0f}
+#define MAX_SPEED_MM_S		2000.0f
+
+static const rc_scan_obstacle_t pillars[] = {
+	{5000.0f, 5000.0f, 300.0f},
+	{15000.0f, 5000.0f, 300.0f},
+	{5000.0f, 15000.0f, 300.0f},
+	{15000.0f, 15000.0f, 300.0f},
+};
+static const int num_pillars = sizeof(pillars) / sizeof(pillars[0]);
+
+static std::vector<float> pos[3];
+static std::vector<float> vel[3];
+static std::vector<float> yaw;
+
+
+static void __step(int n)
+{
+	const float room[3] = ROOM_MM;
+	int i, k;
+
+	for(k=0; k<3; k++){
+		for(i=0; i<n; i++){
+			pos[k][i] += vel[k][i] / FRAME_HZ;
+			if(pos[k][i] < 0.0f || pos[k][i] > room[k]) vel[k][i] = -vel[k][i];
+		}
+	}
+	for(i=0; i<n; i++) yaw[i] = atan2f(vel[1][i], vel[0][i]);
+}
+
+
+// one obstacle seen from vehicle i, sector by sector
+static void __slow_cover(int i, float ox, float oy, float r, const rc_scan_config_t* cfg, float best[RC_SCAN_SECTORS])
+{
+	float dx = ox - pos[0][i];
+	float dy = oy - pos[1][i];
+	float dn = sqrtf(dx * dx + dy * dy);
+	float bearing, half, a;
+	int k;
+
+	if(dn - r >= cfg->range_m * 1000.0f) return;
+	// clockwise from the heading
+	bearing = yaw[i] - atan2f(dy, dx);
+	half = dn <= r ? (float)M_PI : asinf(r / dn) + (float)(RC_SCAN_INCREMENT * M_PI / 360.0);
+	for(k=0; k<RC_SCAN_SECTORS; k++){
+		a = fabsf(remainderf(k * RC_SCAN_INCREMENT * (float)M_PI / 180.0f - bearing, 2.0f * (float)M_PI));
+		if(a <= half && dn - r < best[k]) best[k] = dn > r ? dn - r : 0.0f;
+	}
+}
+
+
+static int __slow_scan(int i, int n, const rc_scan_config_t* cfg, const uint16_t* fast)
+{
+	float best[RC_SCAN_SECTORS];
+	float range = cfg->range_m * 1000.0f;
+	uint16_t d;
+	int j, k, bad = 0;
+
+	for(k=0; k<RC_SCAN_SECTORS; k++) best[k] = range;
+	for(j=0; j<n; j++){
+		if(j == i || fabsf(pos[2][j] - pos[2][i]) > cfg->band_m * 1000.0f) continue;
+		__slow_cover(i, pos[0][j], pos[1][j], cfg->vehicle_radius_m * 1000.0f, cfg, best);
+	}
+	for(j=0; j<num_pillars; j++) __slow_cover(i, pillars[j].x, pillars[j].y, pillars[j].radius, cfg, best);
+	for(k=0; k<RC_SCAN_SECTORS; k++){
+		if(best[k] >= range) d = (uint16_t)(range / 10.0f) + 1;
+		else d = best[k] < RC_SCAN_MIN_CM * 10.0f ? RC_SCAN_MIN_CM : (uint16_t)(best[k] / 10.0f);
+		if(abs((int)d - (int)fast[k]) > 1) bad++;
+	}
+	return bad;
+}
+
+
+static int __run(int n, int frames)
+{
+	const float room[3] = ROOM_MM;
+	rc_scan_config_t cfg;
+	std::vector<uint16_t> scans((size_t)n * RC_SCAN_SECTORS);
+	std::vector<double> us(frames);
+	float p[3];
+	double sum = 0.0, seen = 0.0;
+	int i, k, f, bad = 0;
+
+	srand(1);
+	for(k=0; k<3; k++){
+		pos[k].resize(n);
+		vel[k].resize(n);
+		for(i=0; i<n; i++){
+			pos[k][i] = room[k] * rand() / (float)RAND_MAX;
+			vel[k][i] = MAX_SPEED_MM_S * (2.0f * rand() / (float)RAND_MAX - 1.0f) / (k == 2 ? 4.0f : 1.0f);
+		}
+	}
+	yaw.resize(n);
+	rc_scan_default_config(&cfg);
+
+	for(f=0; f<frames; f++){
+		__step(n);
+		auto t0 = std::chrono::steady_clock::now();
+		if(rc_scan_build(pos[0].data(), pos[1].data(), pos[2].data(), n, pillars, num_pillars, &cfg)) return -1;
+		for(i=0; i<n; i++){
+			p[0] = pos[0][i];
+			p[1] = pos[1][i];
+			p[2] = pos[2][i];
+			rc_scan_sectors(p, yaw[i], i, &scans[(size_t)i * RC_SCAN_SECTORS]);
+		}
+		us[f] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / n;
+		sum += us[f];
+	}
+	for(i=0; i<n; i++){
+		for(k=0; k<RC_SCAN_SECTORS; k++){
+			if(scans[(size_t)i * RC_SCAN_SECTORS + k] <= (uint16_t)(cfg.range_m * 100.0f)) seen++;
+		}
+		bad += __slow_scan(i, n, &cfg, &scans[(size_t)i * RC_SCAN_SECTORS]);
+	}
+	std::sort(us.begin(), us.end());
+	printf("%8d %10.2f %10.2f %10.2f %10.1f %10d\n", n, sum / frames,
+		us[(size_t)(frames * 0.99)], us.back(), seen / n, bad);
+	return 0;
+}
+
+
+int main(int argc, char * argv[])
+{
+	int frames = argc > 1 ? atoi(argv[1]) : DEFAULT_FRAMES;
+	int i;
+
+	if(frames < 1){
+		fprintf(stderr, "usage: rc_bench_scan [frames] [vehicles ...]\n");
+		return -1;
+	}
+	printf("%d frames, %d pillars, %.0fm range\n", frames, num_pillars, RC_SCAN_DEFAULT_RANGE);
+	printf("           time per vehicle, build included       sectors\n");
+	printf("vehicles   mean(us)    p99(us)    max(us)  with hits  disagreed\n");
+	if(argc > 2){
+		for(i=2; i<argc; i++){
+			if(atoi(argv[i]) < 1 || __run(atoi(argv[i]), frames)) return -1;
+		}
+	}
+	else if(__run(50, frames) || __run(500, frames)) return -1;
+	rc_scan_cleanup();
+	return 0;
+}
@@ -0,0 +1,144 @@
+/**
+* @file rc_bench_signing
+*
+* @brief      Measures the per-packet cost of verifying signed MAVLink2
+*             packets with the hash-indexed signing-stream table.
+*
+*             For 16, 256 and 4096 distinct (link_id, sysid, compid) streams
+*             this signs a batch of heartbeat packets per stream, then times
+*             full verification (SHA-256 plus replay check) and the replay
+*             check on its own. For comparison the replay check is also timed
+*             against a linear scan, which is what the stock
+*             mavlink_signature_check does over mavlink_signing_streams_t.
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/mavlink_signing.h"
+
+#define BENCH_IP		"127.0.0.1"
+#define PACKETS_PER_RUN		65536
+
+typedef struct linear_stream_t{
+	uint8_t link_id;
+	uint8_t sysid;
+	uint8_t compid;
+	uint64_t timestamp;
+} linear_stream_t;
+
+static double __ns_since(std::chrono::steady_clock::time_point start)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+}
+
+// stream i gets a unique tuple, sysid and compid are never 0
+static void __stream_tuple(int i, uint8_t* link_id, uint8_t* sysid, uint8_t* compid)
+{
+	*link_id = (uint8_t)(i % 251);
+	*sysid = (uint8_t)(1 + (i / 251) % 250);
+	*compid = (uint8_t)(1 + i / (251*250));
+}
+
+// emulates the search in mavlink_signature_check for an unbounded stream array
+static int __linear_check(std::vector<linear_stream_t>& streams, uint8_t link_id,
+			uint8_t sysid, uint8_t compid, uint64_t timestamp)
+{
+	size_t i;
+	for(i=0; i<streams.size(); i++){
+		if(streams[i].sysid == sysid && streams[i].compid == compid
+				&& streams[i].link_id == link_id) break;
+	}
+	if(i == streams.size()){
+		linear_stream_t s = {link_id, sysid, compid, timestamp};
+		streams.push_back(s);
+		return 0;
+	}
+	if(timestamp <= streams[i].timestamp) return -1;
+	streams[i].timestamp = timestamp;
+	return 0;
+}
+
+static int __run(int n)
+{
+	uint8_t key[RC_MAV_SIGNING_KEY_LEN];
+	uint8_t link_id, sysid, compid;
+	uint32_t addr;
+	int rounds = PACKETS_PER_RUN / n + 1;
+	int r, i, rejected = 0;
+	uint64_t base = rc_mav_signing_timestamp_now();
+	std::vector<mavlink_message_t> msgs((size_t)rounds * n);
+	std::vector<linear_stream_t> linear;
+
+	for(i=0; i<RC_MAV_SIGNING_KEY_LEN; i++) key[i] = (uint8_t)(i * 7 + 3);
+	if(rc_mav_signing_init(n) || rc_mav_signing_set_key(BENCH_IP, 0, key)) return -1;
+	memcpy(&addr, "\x7f\x00\x00\x01", 4);
+
+	// round r of every stream carries timestamp base+r so each is fresh
+	for(r=0; r<rounds; r++){
+		for(i=0; i<n; i++){
+			mavlink_message_t* msg = &msgs[(size_t)r*n + i];
+			__stream_tuple(i, &link_id, &sysid, &compid);
+			mavlink_msg_heartbeat_pack(sysid, compid, msg, 0, 0, 0, 0, 0);
+			rc_mav_sign_msg(msg, link_id, base + r, key);
+		}
+	}
+
+	// first round populates the table, time the remaining ones
+	for(i=0; i<n; i++) rejected += rc_mav_signing_verify(addr, &msgs[i]) != 0;
+	auto start = std::chrono::steady_clock::now();
+	for(r=1; r<rounds; r++){
+		for(i=0; i<n; i++){
+			rejected += rc_mav_signing_verify(addr, &msgs[(size_t)r*n + i]) != 0;
+		}
+	}
+	double verify_ns = __ns_since(start) / ((double)(rounds-1) * n);
+
+	// replay check only, continuing the timestamps used above
+	start = std::chrono::steady_clock::now();
+	for(r=rounds; r<2*rounds; r++){
+		for(i=0; i<n; i++){
+			__stream_tuple(i, &link_id, &sysid, &compid);
+			rejected += rc_mav_signing_check_timestamp(link_id, sysid, compid, base + r) != 0;
+		}
+	}
+	double table_ns = __ns_since(start) / ((double)rounds * n);
+
+	for(i=0; i<n; i++){
+		__stream_tuple(i, &link_id, &sysid, &compid);
+		__linear_check(linear, link_id, sysid, compid, base);
+	}
+	start = std::chrono::steady_clock::now();
+	for(r=1; r<=rounds; r++){
+		for(i=0; i<n; i++){
+			__stream_tuple(i, &link_id, &sysid, &compid);
+			rejected += __linear_check(linear, link_id, sysid, compid, base + r) != 0;
+		}
+	}
+	double linear_ns = __ns_since(start) / ((double)rounds * n);
+
+	printf("%8d %14.1f %14.1f %14.1f %10d\n", n, verify_ns, table_ns, linear_ns, rejected);
+	rc_mav_signing_cleanup();
+	return 0;
+}
+
+int main(int argc, char * argv[])
+{
+	const int sizes[] = {16, 256, 4096};
+	unsigned int i;
+
+	printf(" streams verify(ns/pkt)  table(ns/pkt) linear(ns/pkt)   rejected\n");
+	for(i=0; i<sizeof(sizes)/sizeof(sizes[0]); i++){
+		if(__run(sizes[i])){
+			fprintf(stderr, "ERROR: benchmark failed for %d streams\n", sizes[i]);
+			return -1;
+		}
+	}
+	return 0;
+}
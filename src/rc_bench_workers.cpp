@@ -0,0 +1,114 @@
+/**
+* @file rc_bench_workers
+*
+* @brief      Measures how per-frame subject processing scales with the number
+*             of worker threads.
+*
+*             Frames from the synthetic source are pushed through
+*             rc_bridge_process_frame as fast as possible with 1, 2, 4, 8 and
+*             16 workers. Only the first half of the subjects have signing
+*             keys, so the cost per subject is deliberately uneven and an
+*             even static split would leave some workers idle. For each pool
+*             size the mean and 99th percentile frame time are printed with
+*             the speedup and efficiency relative to one worker, and the share
+*             of frames that fit in the 2.5ms period of a 400Hz system.
+*
+*             Usage: rc_bench_workers [subjects] [frames]
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/mavlink_signing.h"
+#include "../include/rc/mocap_source.h"
+#include "../include/rc/bridge_pipeline.h"
+
+#define DEFAULT_SUBJECTS	512
+#define DEFAULT_FRAMES		2000
+#define WARMUP_FRAMES		50
+#define FRAME_BUDGET_US		2500.0
+#define BENCH_PORT		14599	// nothing listens here
+
+static int __run(MocapSource* source, int workers, int frames, double* mean_us)
+{
+	const rc_mocap_frame_t* frame;
+	std::vector<double> us(frames);
+	double sum = 0.0;
+	int i, in_budget = 0;
+
+	if(rc_bridge_init(workers, RC_BRIDGE_DEFAULT_CHUNK)) return -1;
+	for(i=0; i<WARMUP_FRAMES; i++){
+		source->next_frame(&frame);
+		rc_bridge_process_frame(frame);
+	}
+	for(i=0; i<frames; i++){
+		source->next_frame(&frame);
+		auto start = std::chrono::steady_clock::now();
+		rc_bridge_process_frame(frame);
+		us[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		sum += us[i];
+		if(us[i] <= FRAME_BUDGET_US) in_budget++;
+	}
+	rc_bridge_cleanup();
+
+	std::sort(us.begin(), us.end());
+	*mean_us = sum / frames;
+	printf("%8d %12.1f %12.1f", workers, *mean_us, us[(size_t)(frames * 0.99)]);
+	return in_budget;
+}
+
+int main(int argc, char * argv[])
+{
+	const int pool_sizes[] = {1, 2, 4, 8, 16};
+	const rc_mocap_frame_t* frame;
+	const rc_mocap_subject_t* subjects;
+	uint8_t key[RC_MAV_SIGNING_KEY_LEN];
+	MocapSource* source;
+	double mean_us, base_us = 0.0;
+	int n = argc > 1 ? atoi(argv[1]) : DEFAULT_SUBJECTS;
+	int frames = argc > 2 ? atoi(argv[2]) : DEFAULT_FRAMES;
+	unsigned int i;
+	int in_budget;
+
+	if(n < 1 || frames < 1){
+		fprintf(stderr, "usage: rc_bench_workers [subjects] [frames]\n");
+		return -1;
+	}
+	if(rc_mav_init(1, "127.0.0.1", BENCH_PORT)) return -1;
+	source = rc_mocap_synthetic_source_create(n, RC_MOCAP_SPEED_AFAP);
+	if(source == NULL) return -1;
+
+	// keys for the first half of the subjects only
+	if(rc_mav_signing_init(RC_MAV_SIGNING_DEFAULT_STREAMS)) return -1;
+	for(i=0; i<RC_MAV_SIGNING_KEY_LEN; i++) key[i] = (uint8_t)(i * 7 + 3);
+	source->next_frame(&frame);
+	subjects = rc_mocap_frame_subjects(frame);
+	for(i=0; i<(unsigned int)n / 2 && i < RC_MAV_SIGNING_MAX_DESTS; i++){
+		rc_mav_signing_set_key(strrchr(subjects[i].name, '@') + 1, 0, key);
+	}
+
+	printf("%d subjects, %d frames, %u hardware threads\n", n, frames, std::thread::hardware_concurrency());
+	printf(" workers  mean(us/frame)  p99(us)   speedup  efficiency  within 2.5ms\n");
+	for(i=0; i<sizeof(pool_sizes)/sizeof(pool_sizes[0]); i++){
+		in_budget = __run(source, pool_sizes[i], frames, &mean_us);
+		if(in_budget < 0){
+			fprintf(stderr, "ERROR: benchmark failed for %d workers\n", pool_sizes[i]);
+			return -1;
+		}
+		if(i == 0) base_us = mean_us;
+		printf(" %9.2f %10.0f%% %12.1f%%\n", base_us / mean_us,
+			100.0 * base_us / (mean_us * pool_sizes[i]), 100.0 * in_budget / frames);
+	}
+
+	delete source;
+	rc_mav_signing_cleanup();
+	rc_mav_cleanup();
+	return 0;
+}
@@ -0,0 +1,199 @@
+/**
+* @file rc_check_traits
+*
+* @brief      Checks rc_mav_pack and rc_mav_unpack against the C helpers for
+*             every message in RC_MAV_MESSAGES.
+*
+*             First against the MAVLink testsuite's packet_in frames (see
+*             rc_bench_codec_vectors): each canonical frame is unpacked with
+*             rc_mav_unpack and compared with the C decode, then packed with
+*             rc_mav_pack and parsed back, and its length, ids and payload
+*             compared with the canonical frame's. Every message in
+*             RC_MAV_MESSAGES must have a frame in the testsuite.
+*
+*             Then each message is filled with random bytes, some with a zeroed
+*             tail so the trimming is exercised, encoded with the C helper
+*             and parsed. That is unpacked with rc_mav_unpack and compared
+*             with the C decode, packed again with rc_mav_pack and compared byte for
+*             byte with rc_mav_pack_msg, and the packet parsed back and
+*             unpacked. Prints every mismatch and how many messages of how
+*             many types passed, and exits with the number of mismatches.
+*
+*             Usage: rc_check_traits [rounds], 64 per message by default
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include "../include/rc/mavlink_traits.h"
+
+#define DEFAULT_ROUNDS	64
+#define TEST_SYSID	42
+#define MAX_VECTORS	512
+
+extern "C" int rc_bench_codec_vectors(mavlink_message_t* out, int max);
+
+static int checked = 0;
+static int types = 0;
+static int vectors_checked = 0;
+static int failures = 0;
+
+
+// private local function declarations;
+template<typename Msg> static void __check_vector(const mavlink_message_t* vec,
+			void (*decode)(const mavlink_message_t*, Msg*));
+template<typename Msg> static void __check(int rounds,
+			uint16_t (*encode)(uint8_t, uint8_t, mavlink_message_t*, const Msg*),
+			void (*decode)(const mavlink_message_t*, Msg*));
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+// compid isn't compared, rc_mav_pack always sends MAV_COMP_ID_ALL and the
+// testsuite sends as component 11, which also changes the checksum
+template<typename Msg>
+static void __check_vector(const mavlink_message_t* vec, void (*decode)(const mavlink_message_t*, Msg*))
+{
+	typedef rc_mav_msg<Msg> T;
+	rc_mav_packet_t pkt;
+	mavlink_message_t back;
+	mavlink_status_t status;
+	Msg c, t;
+	int j, done = 0;
+
+	memset(&c, 0, sizeof(c));
+	memset(&t, 0xA5, sizeof(t));
+	decode(vec, &c);
+	if(rc_mav_unpack(vec, &t) || memcmp(&c, &t, sizeof(c)) != 0){
+		printf("%s: rc_mav_unpack differs from the C decode of the testsuite frame\n", T::name());
+		failures++;
+		return;
+	}
+	if(rc_mav_pack(&pkt, 0, 0, vec->sysid, vec->seq, t)){
+		printf("%s: packing the testsuite message failed\n", T::name());
+		failures++;
+		return;
+	}
+	for(j=0; j<pkt.len && !done; j++){
+		done = mavlink_parse_char(MAVLINK_COMM_2, pkt.buf[j], &back, &status);
+	}
+	if(!done || back.len != vec->len || back.msgid != vec->msgid || back.sysid != vec->sysid ||
+			back.seq != vec->seq || memcmp(_MAV_PAYLOAD(&back), _MAV_PAYLOAD(vec), vec->len) != 0){
+		printf("%s: rc_mav_pack differs from the testsuite frame\n", T::name());
+		failures++;
+		return;
+	}
+	vectors_checked++;
+}
+
+
+template<typename Msg>
+static void __check(int rounds, uint16_t (*encode)(uint8_t, uint8_t, mavlink_message_t*, const Msg*),
+			void (*decode)(const mavlink_message_t*, Msg*))
+{
+	typedef rc_mav_msg<Msg> T;
+	rc_mav_packet_t typed, ref;
+	mavlink_message_t sent, msg, back;
+	mavlink_status_t status;
+	Msg r, c, t, b;
+	uint8_t* bytes = (uint8_t*)&r;
+	uint8_t wire[MAVLINK_MAX_PACKET_LEN];
+	uint8_t seq;
+	int i, j, n, done, passed = 0;
+
+	for(i=0; i<rounds; i++){
+		seq = (uint8_t)i;
+		for(j=0; j<T::len; j++) bytes[j] = (uint8_t)rand();
+		// every other round ends in zeros for MAVLink 2 to trim
+		if(i & 1) memset(bytes + T::len - (i % T::len) - 1, 0, (i % T::len) + 1);
+		encode(TEST_SYSID, MAV_COMP_ID_ALL, &sent, &r);
+		// unpacking is from the parser, which zero fills what was trimmed
+		n = mavlink_msg_to_send_buffer(wire, &sent);
+		done = 0;
+		for(j=0; j<n && !done; j++){
+			done = mavlink_parse_char(MAVLINK_COMM_0, wire[j], &msg, &status);
+		}
+		if(!done){
+			printf("%s: the C encode does not parse\n", T::name());
+			failures++;
+			return;
+		}
+
+		memset(&c, 0, sizeof(c));
+		memset(&t, 0xA5, sizeof(t));
+		decode(&msg, &c);
+		if(rc_mav_unpack(&msg, &t) || memcmp(&c, &t, sizeof(c)) != 0){
+			printf("%s: rc_mav_unpack differs from the C decode\n", T::name());
+			failures++;
+			return;
+		}
+
+		if(rc_mav_pack(&typed, 0, 0, TEST_SYSID, seq, t) ||
+				rc_mav_pack_msg(&ref, 0, 0, TEST_SYSID, seq, T::id, &c, T::min_len, T::len, T::crc_extra)){
+			printf("%s: packing failed\n", T::name());
+			failures++;
+			return;
+		}
+		if(typed.len != ref.len || memcmp(typed.buf, ref.buf, ref.len) != 0){
+			printf("%s: rc_mav_pack differs from rc_mav_pack_msg\n", T::name());
+			failures++;
+			return;
+		}
+
+		done = 0;
+		for(j=0; j<typed.len && !done; j++){
+			done = mavlink_parse_char(MAVLINK_COMM_1, typed.buf[j], &back, &status);
+		}
+		memset(&b, 0, sizeof(b));
+		if(!done || rc_mav_unpack(&back, &b) || memcmp(&c, &b, sizeof(c)) != 0){
+			printf("%s: rc_mav_pack does not parse back\n", T::name());
+			failures++;
+			return;
+		}
+		passed++;
+	}
+	checked += passed;
+	types++;
+}
+
+
+int main(int argc, char * argv[])
+{
+	static mavlink_message_t vectors[MAX_VECTORS];
+	int rounds = argc > 1 ? atoi(argv[1]) : DEFAULT_ROUNDS;
+	int i, n, found;
+
+	if(rounds < 1){
+		fprintf(stderr, "usage: rc_check_traits [rounds]\n");
+		return -1;
+	}
+
+	n = rc_bench_codec_vectors(vectors, MAX_VECTORS);
+#define RC_CHECK_VECTOR(lower, NAME) \
+	found = 0; \
+	for(i=0; i<n && !found; i++){ \
+		if(vectors[i].msgid != MAVLINK_MSG_ID_##NAME) continue; \
+		__check_vector<mavlink_##lower##_t>(&vectors[i], mavlink_msg_##lower##_decode); \
+		found = 1; \
+	} \
+	if(!found){ \
+		printf("%s: no frame in the testsuite\n", #NAME); \
+		failures++; \
+	}
+	RC_MAV_MESSAGES(RC_CHECK_VECTOR)
+#undef RC_CHECK_VECTOR
+	printf("%d testsuite frames checked\n", vectors_checked);
+
+	srand(1);
+#define RC_CHECK_MSG(lower, NAME) \
+	__check<mavlink_##lower##_t>(rounds, mavlink_msg_##lower##_encode, mavlink_msg_##lower##_decode);
+	RC_MAV_MESSAGES(RC_CHECK_MSG)
+#undef RC_CHECK_MSG
+	printf("%d messages of %d types checked, %d mismatches\n", checked, types, failures);
+	return failures;
+}
@@ -23,17 +23,34 @@
 #include <iostream>
 #include <stdio.h>
 #include <string>
-#include <sstream>
+#include <string.h>
 #include <stdlib.h>
-#include <Windows.h>
 #include <signal.h> // to SIGINT signal handler
+#include "../include/rc/event_loop.h"
 #include "../include/rc/mavlink_udp.h"
 #include "../include/rc/mavlink_udp_helpers.h"
-#include "../include/rc/DataStreamClient.h"
+#include "../include/rc/mavlink_signing.h"
+#include "../include/rc/latency_stats.h"
+#include "../include/rc/status_display.h"
+#include "../include/rc/flight_recorder.h"
+#include "../include/rc/mocap_source.h"
+#include "../include/rc/mocap_capture.h"
+#include "../include/rc/routing.h"
+#include "../include/rc/bridge_pipeline.h"
+#include "../include/rc/pose_bus.h"
+#include "../include/rc/realtime.h"
 
 
 #define LOCALHOST_IP	"127.0.0.1"
 #define DEFAULT_SYS_ID	1
+#define SIGNING_KEY_FILE	"signing_keys.txt"
+#define ROUTING_FILE		"routes.txt"
+#define VICON_HOST	"localhost:801"
+#define SYNTHETIC_HZ	400.0
+#define LOOP_WAIT_MS	100	// longest wait of the event loop, also how soon ctrl-c is seen
+#define NO_FRAME_USEC	100000	// report no frame after this long without one
+#define TIMER_USEC	1000	// heartbeats and other periodic messages
+#define LINK_CHECK_USEC	100000	// connection lost check when nothing is received
 
 const char* dest_ip;
 uint8_t my_sys_id;
@@ -48,35 +65,223 @@ void signal_handler(int dummy)
 	return;
 }
 
+// the event loop's callbacks, run on the main thread
+void on_mav_readable(void* ctx)
+{
+	rc_mav_receive();
+}
+
+void on_bridge_timer(void* ctx)
+{
+	rc_bridge_run_timers();
+}
+
+void print_usage()
+{
+	printf("\n");
+	printf("Options\n");
+	printf("-l                record per-stage latency histograms, printed on exit\n");
+	printf("-r {prefix}       record every sent packet to prefix_NNNN.tlog\n");
+	printf("-c {file}         capture every Vicon frame to file for later replay\n");
+	printf("-v {host:port}    Vicon server to connect to (default %s), repeat to merge several\n", VICON_HOST);
+	printf("-m {group:port}   have the Vicon server multicast its frames to group for other bridges\n");
+	printf("-i {ip}           server interface the -m multicast is sent from, required with -m\n");
+	printf("-M {group:port}   receive frames from a multicast group instead, -v then gives the local interface\n");
+	printf("-k {index}/{count} handle only shard index of count, split by subject name\n");
+	printf("-S {subjects}     generate frames of this many subjects at %.0f Hz instead of connecting to Vicon\n", SYNTHETIC_HZ);
+	printf("-w {workers}      threads processing each frame's subjects (default 1)\n");
+	printf("-T {threads}      receive vehicle telemetry on this many threads, spread by sender on Linux\n");
+	printf("-x {a,s,r}        real-time mode, pin the acquisition, send and receive threads to these cores\n");
+	printf("                  with SCHED_FIFO priorities and lock memory, -1 leaves a thread unpinned\n");
+	printf("-N {subjects}     preallocate every per-subject buffer for this many subjects\n");
+	printf("-t {file}         routing table, reloaded when it changes (default %s)\n", ROUTING_FILE);
+	printf("-P {name}         publish every frame's poses to shared memory for local readers, e.g. %s\n", RC_POSEBUS_DEFAULT_NAME);
+	printf("-R {file}         replay a capture file instead of connecting to Vicon, may be repeated\n");
+	printf("-s {speed}        replay speed, 1 for real time (default), N for N times, max for as fast as possible\n");
+	printf("-h                print this help message\n");
+	printf("\n");
+}
+
 int main(int argc, char * argv[])
 {
-	//Set up client to read data from Vicon
-	using namespace ViconDataStreamSDK::CPP;
-	Output_GetSegmentGlobalRotationQuaternion global_quat;
-	Output_GetSegmentGlobalRotationEulerXYZ global_euler;
-	float q[4];
-	float eu[3];
-	int connect_counter;
-	Client MyClient;
-	bool ok;
+	MocapSource* source = NULL;
+	const rc_mocap_frame_t* frame;
 	int ret;
+	int status = 0;
+	uint64_t last_frame_usec;
 	const char* dest_ip;
-	int connect_attempted;
-	Output_GetSegmentGlobalTranslation global_translation;
-	Output_GetFrameNumber Frames_Since_Boot;
-	std::string ip_string;
-	std::string drone_name;
+	int latency_stats = 0;
+	int workers = 1;
+	int receive_threads = 0;
+	int synthetic_subjects = 0;
+	int realtime = 0;
+	int max_subjects = 0;
+	rc_rt_config_t rt_config;
+	const char* record_prefix = NULL;
+	const char* capture_path = NULL;
+	const char* pose_bus_name = NULL;
+	const char* routing_path = ROUTING_FILE;
+	const char* hosts[RC_MOCAP_MAX_SOURCES];
+	const char* replay_paths[RC_MOCAP_MAX_SOURCES];
+	MocapSource* sources[RC_MOCAP_MAX_SOURCES];
+	int num_hosts = 0;
+	int num_replays = 0;
+	int num_sources = 0;
+	double replay_speed = 1.0;
+	rc_mocap_vicon_config_t vicon_config;
 	// set default options before checking options
 	my_sys_id = DEFAULT_SYS_ID;
 	port = RC_MAV_DEFAULT_UDP_PORT;
 	dest_ip = "127.0.0.1";
+	memset(&vicon_config, 0, sizeof(vicon_config));
+	vicon_config.shard_count = 1;
+	rc_rt_default_config(&rt_config);
+
+	// parse arguments
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-l") == 0)
+		{
+			latency_stats = 1;
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			record_prefix = argv[++i];
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			capture_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc && num_hosts < RC_MOCAP_MAX_SOURCES)
+		{
+			hosts[num_hosts++] = argv[++i];
+		}
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+		{
+			vicon_config.multicast_send = argv[++i];
+		}
+		else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+		{
+			vicon_config.multicast_interface = argv[++i];
+		}
+		else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc)
+		{
+			vicon_config.multicast_join = argv[++i];
+		}
+		else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc &&
+			sscanf(argv[i + 1], "%d/%d", &vicon_config.shard_index, &vicon_config.shard_count) == 2)
+		{
+			i++;
+		}
+		else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc)
+		{
+			synthetic_subjects = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+		{
+			workers = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+		{
+			receive_threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+		{
+			if (rc_rt_parse_cores(argv[++i], &rt_config) < 0)
+			{
+				return -1;
+			}
+			realtime = 1;
+		}
+		else if (strcmp(argv[i], "-N") == 0 && i + 1 < argc)
+		{
+			max_subjects = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			routing_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc)
+		{
+			pose_bus_name = argv[++i];
+		}
+		else if (strcmp(argv[i], "-R") == 0 && i + 1 < argc && num_replays < RC_MOCAP_MAX_SOURCES)
+		{
+			replay_paths[num_replays++] = argv[++i];
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			i++;
+			replay_speed = strcmp(argv[i], "max") == 0 ? RC_MOCAP_SPEED_AFAP : atof(argv[i]);
+		}
+		else if (strcmp(argv[i], "-h") == 0)
+		{
+			print_usage();
+			return 0;
+		}
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+	}
+	if ((vicon_config.multicast_send != NULL || vicon_config.multicast_join != NULL) && num_hosts > 1)
+	{
+		fprintf(stderr, "multicast can only be used with a single Vicon server\n");
+		return -1;
+	}
+	if (vicon_config.multicast_send != NULL &&
+		(vicon_config.multicast_interface == NULL || strchr(vicon_config.multicast_interface, ':') != NULL))
+	{
+		fprintf(stderr, "-m needs -i with the server interface as a bare IP, without a port\n");
+		return -1;
+	}
+	rc_lat_init(latency_stats);
+	if (max_subjects == 0)
+	{
+		max_subjects = synthetic_subjects;
+	}
+
+	// before any thread starts, so they all find their memory locked
+	if (realtime)
+	{
+		rc_rt_start(&rt_config);
+	}
 
 	// initialize the UDP port and listening thread with the rc_mav lib
+	if (receive_threads > 1 && rc_mav_set_receive_threads(receive_threads) < 0)
+	{
+		return -1;
+	}
 	if (rc_mav_init(my_sys_id, dest_ip, port) < 0)
 	{
 		return -1;
 
 	}
+
+	// optional per-destination signing keys, packets go out unsigned without them
+	if (rc_mav_signing_init(RC_MAV_SIGNING_DEFAULT_STREAMS) < 0)
+	{
+		status = -1;
+		goto cleanup;
+	}
+	ret = rc_mav_signing_load_file(SIGNING_KEY_FILE);
+	if (ret > 0)
+	{
+		printf("loaded %d signing keys from %s\n", ret, SIGNING_KEY_FILE);
+	}
+	// subjects missing from the routing table are routed by their name@IP name
+	ret = rc_route_start(routing_path);
+	if (ret < 0)
+	{
+		status = -1;
+		goto cleanup;
+	}
+	if (ret > 0)
+	{
+		printf("loaded %d routes from %s\n", ret, routing_path);
+	}
 	printf("run with -h option to see usage and other options\n");
 	// inform the user what settings are being used
 	printf("\n");
@@ -87,180 +292,189 @@ int main(int argc, char * argv[])
 	printf("\n");
 
 	// set signal handler so the loop can exit cleanly
+	running = 1;
 	signal(SIGINT, signal_handler);
 
-	ok = (MyClient.Connect("localhost:801").Result == Result::Success);
-	
-	//try to connect to the server every 0.5 seconds
-	while(!ok)
+	// frames come either live from Vicon, from previous captures or are generated
+	if (synthetic_subjects > 0)
 	{
-		if (connect_attempted != 1) {
-			std::cout << "Trying to connect to the Vicon server, make sure the cameras are turned on and Vicon Tracker is running...";
-		};
-		connect_attempted = 1;
-		Sleep(500);
-		std::cout << ".";
-	}
-
-	//MyClient.SetAxisMapping(Direction::Forward,
-		//Direction::Right,
-		//Direction::Up);
-	MyClient.EnableSegmentData();
-	MyClient.EnableMarkerData();
-	MyClient.EnableUnlabeledMarkerData();
-	MyClient.EnableMarkerRayData();
-	MyClient.EnableDeviceData();
-	MyClient.EnableDebugData();
-	Output_GetSubjectCount OutputGSC;
-	OutputGSC = MyClient.GetSubjectCount();
-	Output_GetSubjectName OutputGSN;
-	unsigned int SubjectCount = MyClient.GetSubjectCount().SubjectCount;
-
-
-	while (SubjectCount < 1)
-	{
-		if (MyClient.GetFrame().Result != Result::Success)
+		sources[num_sources] = rc_mocap_synthetic_source_create(synthetic_subjects, SYNTHETIC_HZ);
+		if (sources[num_sources] == NULL)
 		{
-			output_stream << "Waiting for new frame..." << std::endl;
-			//continue;
-		}
-		else{
-			output_stream << "Scanning Vicon software for subjects..." << std::endl;
+			status = -1;
+			goto cleanup;
 		}
-		SubjectCount = MyClient.GetSubjectCount().SubjectCount;
+		num_sources++;
+		num_hosts = 0;
 	}
-	output_stream << "Subjects (" << SubjectCount << "):" << std::endl;
-
-
-
-	for (unsigned int SubjectIndex = 0; SubjectIndex < SubjectCount; ++SubjectIndex)
+	else if (num_replays == 0 && num_hosts == 0)
+	{
+		hosts[num_hosts++] = VICON_HOST;
+	}
+	for (int i = 0; synthetic_subjects == 0 && i < num_replays; i++)
+	{
+		sources[num_sources] = rc_mocap_replay_source_create(replay_paths[i], replay_speed);
+		if (sources[num_sources] == NULL) break;
+		num_sources++;
+	}
+	for (int i = 0; synthetic_subjects == 0 && num_replays == 0 && i < num_hosts; i++)
+	{
+		vicon_config.host = hosts[i];
+		sources[num_sources] = rc_mocap_vicon_source_create(&vicon_config, &running);
+		if (sources[num_sources] == NULL) break;
+		num_sources++;
+	}
+	if (num_sources != (synthetic_subjects > 0 ? 1 : num_replays > 0 ? num_replays : num_hosts))
 	{
-		output_stream << "  Subject #" << SubjectIndex + 1 << std::endl;
+		for (int i = 0; i < num_sources; i++) delete sources[i];
+		status = -1;
+		goto cleanup;
+	}
 
-		// Get the subject name
-		std::string SubjectName = MyClient.GetSubjectName(SubjectIndex).SubjectName;
-		output_stream << "    Name: " << SubjectName << std::endl;
+	// several servers are merged into one subject table by name
+	if (num_sources == 1)
+	{
+		source = sources[0];
+	}
+	else
+	{
+		source = rc_mocap_fanin_source_create(sources, num_replays > 0 ? replay_paths : hosts, num_sources);
+	}
 
-		// Get the root segment
-		std::string RootSegment = MyClient.GetSubjectRootSegmentName(SubjectName).SegmentName;
-		output_stream << "    Root Segment: " << RootSegment << std::endl;
+	// one loop waits on incoming packets, timers and the acquisition thread
+	// waking it with each frame, unless packets have threads of their own
+	if (rc_loop_init(NULL, NULL) < 0 ||
+		(receive_threads > 0 ? rc_mav_receive_start(receive_threads) :
+			rc_loop_add_socket(rc_mav_socket(), on_mav_readable, NULL)) < 0 ||
+		rc_loop_add_timer(TIMER_USEC, on_bridge_timer, NULL) < 0 ||
+		rc_loop_add_timer(LINK_CHECK_USEC, on_mav_readable, NULL) < 0)
+	{
+		status = -1;
+		goto cleanup;
+	}
+	source = rc_mocap_threaded_source_create(source, rc_loop_wakeup);
 
-		// Count the number of segments
-		unsigned int SegmentCount = MyClient.GetSegmentCount(SubjectName).SegmentCount;
-		output_stream << "    Segments (" << SegmentCount << "):" << std::endl;
-		for (unsigned int SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex)
+	if (rc_bridge_init(workers, RC_BRIDGE_DEFAULT_CHUNK) < 0)
+	{
+		status = -1;
+		goto cleanup;
+	}
+	if (max_subjects > 0)
+	{
+		if (rc_bridge_reserve(max_subjects) < 0)
 		{
-			output_stream << "      Segment #" << SegmentIndex << std::endl;
-
-			// Get the segment name
-			std::string SegmentName = MyClient.GetSegmentName(SubjectName, SegmentIndex).SegmentName;
-			output_stream << "        Name: " << SegmentName << std::endl;
-
-			// Get the segment parent
-			std::string SegmentParentName = MyClient.GetSegmentParentName(SubjectName, SegmentName).SegmentName;
-			output_stream << "        Parent: " << SegmentParentName << std::endl;
-
-			// Get the segment's children
-			unsigned int ChildCount = MyClient.GetSegmentChildCount(SubjectName, SegmentName).SegmentCount;
-			output_stream << "     Children (" << ChildCount << "):" << std::endl;
-			for (unsigned int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
-			{
-				std::string ChildName = MyClient.GetSegmentChildName(SubjectName, SegmentName, ChildIndex).SegmentName;
-				output_stream << "       " << ChildName << std::endl;
-			}
+			status = -1;
+			goto cleanup;
 		}
+		source->reserve(max_subjects);
+		rc_lat_reserve(max_subjects);
+	}
+	if (record_prefix != NULL && rc_recorder_start(record_prefix, RC_RECORDER_DEFAULT_SLOTS, RC_RECORDER_DEFAULT_ROTATE) < 0)
+	{
+		status = -1;
+		goto cleanup;
+	}
+	if (capture_path != NULL && rc_mocap_capture_start(capture_path) < 0)
+	{
+		status = -1;
+		goto cleanup;
+	}
+	if (pose_bus_name != NULL && rc_posebus_create(pose_bus_name, RC_POSEBUS_DEFAULT_CAPACITY) < 0)
+	{
+		status = -1;
+		goto cleanup;
 	}
-
-	running = 1;
 
 	output_stream << "Starting data stream" << std::endl;
+	rc_display_start(RC_DISPLAY_DEFAULT_HZ);
+	// last, threads started from here on would inherit the core and priority
+	rc_rt_enter(RC_RT_SEND);
+	last_frame_usec = rc_mav_time_usec();
 	while (running)
 	{
-		//Use Vicon SDK to get position data
-		//std::cout << "Waiting for new frame...";
-		if (MyClient.GetFrame().Result != Result::Success)
+		// heartbeats and other periodic messages keep going without frames
+		if (rc_loop_run_once(LOOP_WAIT_MS) < 0)
 		{
-			std::cout << "No new frame received" << std::endl;
-			continue;
+			break;
 		}
 
-		
-		Frames_Since_Boot = MyClient.GetFrameNumber();
-
-		SubjectCount = MyClient.GetSubjectCount().SubjectCount;
-
-		// make sure there are objects to track
-		if (SubjectCount == 0) {
-			printf("\r");
-			printf("ERROR: No objects are selected! Please select an object in the Vicon software to track it.");
-			fflush(stdout);
-		};
-
-
-		//For every subject, get the name and parse the name and IP address
-		for (unsigned int SubjectIndex = 0; SubjectIndex < SubjectCount; ++SubjectIndex)
+		ret = source->next_frame(&frame);
+		if (ret == RC_MOCAP_END)
 		{
-			//output_stream << "  Subject #" << SubjectIndex + 1 << std::endl;
-
-			// Get the subject name
-			std::string SubjectName = MyClient.GetSubjectName(SubjectIndex).SubjectName;
-			
-			//output_stream << "    Object: " << SubjectName << std::endl;
-			std::istringstream iss(SubjectName);
-			while (iss.good())
+			break;
+		}
+		if (ret != RC_MOCAP_FRAME)
+		{
+			if (rc_mav_time_usec() - last_frame_usec > NO_FRAME_USEC)
 			{
-				getline(iss, ip_string, '@');
+				rc_display_set_status("No new frame received");
 			}
-			dest_ip = ip_string.c_str();
-			drone_name = SubjectName;
-
-			//output_stream << "    Object Name: " << drone_name << std::endl;
-			//output_stream << "    IP address: " << dest_ip << std::endl;
-			// Get the root segment
-			std::string RootSegment = MyClient.GetSubjectRootSegmentName(SubjectName).SegmentName;
-			//output_stream << "    Root Segment: " << RootSegment << std::endl;
-
+			continue;
+		}
+		last_frame_usec = rc_mav_time_usec();
+		rc_display_publish_frame((uint32_t)frame->frame_number, frame->subject_count);
 
-			if (rc_mav_set_dest_ip(dest_ip)) {
-				std::cout << "ERROR setting dest ip\n";
-				continue;
-			}
+		// make sure there are objects to track
+		if (frame->subject_count == 0) {
+			rc_display_set_status("ERROR: No objects are selected! Please select an object in the Vicon software to track it.");
+		}
+		else {
+			rc_display_set_status(NULL);
+		}
 
-			global_quat = MyClient.GetSegmentGlobalRotationQuaternion(drone_name, RootSegment);
-			q[0] = global_quat.Rotation[0];
-			q[1] = global_quat.Rotation[1];
-			q[2] = global_quat.Rotation[2];
-			q[3] = global_quat.Rotation[3];
+		// parse destinations, pack and sign on all workers, then send the batch
+		rc_bridge_process_frame(frame);
 
-			global_euler = MyClient.GetSegmentGlobalRotationEulerXYZ(drone_name, RootSegment);
-			eu[0] = global_euler.Rotation[0];
-			eu[1] = global_euler.Rotation[1];
-			eu[2] = global_euler.Rotation[2];
+		// local readers and the capture come after sending so they add nothing to the latency
+		if (pose_bus_name != NULL)
+		{
+			rc_posebus_publish(frame);
+		}
+		if (rc_mocap_capture_is_running())
+		{
+			rc_mocap_capture_write(frame);
+		}
 
-			global_translation = MyClient.GetSegmentGlobalTranslation(drone_name, RootSegment);
+	} // end while(running)
 
-			ret = rc_mav_send_att_pos_mocap(q, global_translation.Translation[0], global_translation.Translation[1], global_translation.Translation[2]);
-			if(ret == -1){
-				fprintf(stderr, "failed to send position data\n");
-				continue;
-			}
-			else{
-				printf("\r");
-				printf("quat %4.2f  %4.2f  %4.2f %4.2f", q[0], q[1], q[2], q[3]);
-				printf(" euler %4.2f  %4.2f  %4.2f", eu[0], eu[1], eu[2]);
-				printf(" XYZ(mm) %7.0f %7.0f %7.0f", global_translation.Translation[0], global_translation.Translation[1], global_translation.Translation[2]);
-				printf("   ");
-				fflush(stdout);
-			}
-		
-		}// end for loop through subjects
 
-	} // end while(running)
+// failures after rc_mav_init come here too, everything below only stops
+// what was started
+cleanup:
+// stop the display before printing anything else
+rc_display_stop();
 
+if (rc_mocap_capture_is_running())
+{
+	printf("captured %llu frames\n", (unsigned long long)rc_mocap_capture_stop());
+}
+rc_posebus_destroy();
+delete source;
+rc_bridge_cleanup();
+rc_loop_remove_socket(rc_mav_socket());
+rc_loop_cleanup();
+rc_route_stop();
+
+if (rc_recorder_is_running())
+{
+	rc_recorder_stop();
+	printf("recorded %llu packets, %llu dropped\n",
+		(unsigned long long)rc_recorder_written(),
+		(unsigned long long)rc_recorder_dropped());
+}
 
 // stop listening thread and close UDP port
 printf("closing UDP port\n");
 rc_mav_cleanup();
+rc_mav_signing_cleanup();
+
+// dump per-stage latency percentiles collected with -l
+if (rc_lat_is_enabled())
+{
+	rc_lat_print(stdout);
+}
+rc_lat_cleanup();
+rc_rt_stop();
 
-return 0;
+return status;
 }
@@ -0,0 +1,204 @@
+/**
+* @file rc_tlog_replay
+*
+* @brief      Replays a tlog recorded with rc_mocap_tracking -r (or any other
+*             tlog) through the rc_mav send path.
+*
+*             Packets can be sent at real time, at a multiple of real time,
+*             or as fast as possible, optionally restricted to one sysid or a
+*             time window. Each sysid can be routed to its own destination IP
+*             with -d, everything else goes to the -a address. This lets
+*             vehicle estimators be regression-tested, and the send pipeline
+*             benchmarked, with reproducible production traffic and no Vicon
+*             system.
+*
+* @date       10/18/2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h> // to SIGINT signal handler
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/tlog_replay.h"
+
+#define DEFAULT_DEST_IP	"127.0.0.1"
+#define REPLAY_SYS_ID	255
+
+static volatile int running;
+static const char* sysid_dest[256];
+static const char* default_dest;
+static const char* current_dest;
+
+// interrupt handler to catch ctrl-c
+void signal_handler(int dummy)
+{
+	running = 0;
+	return;
+}
+
+void print_usage()
+{
+	printf("\n");
+	printf("Usage: rc_tlog_replay {file.tlog} [options]\n");
+	printf("Options\n");
+	printf("-s {speed}        1 for real time (default), N for N times, max for as fast as possible\n");
+	printf("-a {ip}           destination for sysids without a -d mapping (default %s)\n", DEFAULT_DEST_IP);
+	printf("-d {sysid}:{ip}   send packets from sysid to ip, may be repeated\n");
+	printf("-i {sysid}        only replay packets from this sysid\n");
+	printf("-t {seconds}      start this many seconds into the log\n");
+	printf("-e {seconds}      stop this many seconds into the log\n");
+	printf("-p {port}         UDP port to send to (default %d)\n", RC_MAV_DEFAULT_UDP_PORT);
+	printf("-h                print this help message\n");
+	printf("\n");
+}
+
+// routes each packet to its sysid's destination, only touching the socket
+// address when it changes
+static int __select_dest(const rc_tlog_entry_t* entry, void* ctx)
+{
+	const char* dest = sysid_dest[entry->sysid] ? sysid_dest[entry->sysid] : default_dest;
+	if(dest != current_dest){
+		if(rc_mav_set_dest_ip(dest)) return -1;
+		current_dest = dest;
+	}
+	return 0;
+}
+
+int main(int argc, char * argv[])
+{
+	rc_tlog_t* log;
+	rc_tlog_replay_config_t config;
+	rc_tlog_replay_stats_t stats;
+	const rc_tlog_entry_t* first;
+	const rc_tlog_entry_t* last;
+	const char* path = NULL;
+	double start_s = 0.0, end_s = 0.0;
+	uint16_t port = RC_MAV_DEFAULT_UDP_PORT;
+	size_t count;
+	unsigned int sysid;
+	int i;
+
+	memset(&config, 0, sizeof(config));
+	config.speed = 1.0;
+	config.sysid = RC_TLOG_ANY_SYSID;
+	default_dest = DEFAULT_DEST_IP;
+
+	// parse arguments
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-h") == 0)
+		{
+			print_usage();
+			return 0;
+		}
+		else if (argv[i][0] != '-')
+		{
+			path = argv[i];
+		}
+		else if (i + 1 >= argc)
+		{
+			fprintf(stderr, "option %s needs an argument\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+		else if (strcmp(argv[i], "-s") == 0)
+		{
+			i++;
+			config.speed = strcmp(argv[i], "max") == 0 ? RC_TLOG_SPEED_AFAP : atof(argv[i]);
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			default_dest = argv[++i];
+		}
+		else if (strcmp(argv[i], "-d") == 0)
+		{
+			char* colon = strchr(argv[++i], ':');
+			if (colon == NULL || sscanf(argv[i], "%u", &sysid) != 1 || sysid > 255)
+			{
+				fprintf(stderr, "invalid destination %s, expected sysid:ip\n", argv[i]);
+				return -1;
+			}
+			sysid_dest[sysid] = colon + 1;
+		}
+		else if (strcmp(argv[i], "-i") == 0)
+		{
+			config.sysid = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-t") == 0)
+		{
+			start_s = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-e") == 0)
+		{
+			end_s = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-p") == 0)
+		{
+			port = (uint16_t)atoi(argv[++i]);
+		}
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			print_usage();
+			return -1;
+		}
+	}
+	if (path == NULL || config.speed < 0.0)
+	{
+		print_usage();
+		return -1;
+	}
+
+	log = rc_tlog_open(path);
+	if (log == NULL)
+	{
+		return -1;
+	}
+	if (rc_tlog_count(log) == 0)
+	{
+		fprintf(stderr, "no packets in %s\n", path);
+		rc_tlog_close(log);
+		return -1;
+	}
+	first = rc_tlog_entry(log, 0);
+	last = rc_tlog_entry(log, rc_tlog_count(log) - 1);
+	printf("%s: %zu packets over %.1f seconds\n", path, rc_tlog_count(log),
+		(double)(last->time_usec - first->time_usec) / 1e6);
+	for (i = 0; i < 256; i++)
+	{
+		if (rc_tlog_sysid_index(log, (uint8_t)i, &count) != NULL)
+		{
+			printf("  sysid %3d: %zu packets -> %s\n", i, count,
+				sysid_dest[i] ? sysid_dest[i] : default_dest);
+		}
+	}
+
+	if (start_s > 0.0) config.start_usec = first->time_usec + (uint64_t)(start_s * 1e6);
+	if (end_s > 0.0) config.end_usec = first->time_usec + (uint64_t)(end_s * 1e6);
+	config.before_send = __select_dest;
+	config.running = &running;
+
+	if (rc_mav_init(REPLAY_SYS_ID, default_dest, port) < 0)
+	{
+		rc_tlog_close(log);
+		return -1;
+	}
+	current_dest = default_dest;
+
+	running = 1;
+	signal(SIGINT, signal_handler);
+	rc_tlog_replay(log, &config, &stats);
+
+	printf("sent %llu packets (%llu failed) in %.3f s, %.0f packets/s\n",
+		(unsigned long long)stats.sent, (unsigned long long)stats.failed,
+		stats.duration_s, stats.duration_s > 0.0 ? (double)stats.sent / stats.duration_s : 0.0);
+	if (config.speed > 0.0)
+	{
+		printf("pacing lateness: mean %.1f us, max %.1f us\n", stats.late_mean_us, stats.late_max_us);
+	}
+
+	rc_mav_cleanup();
+	rc_tlog_close(log);
+	return 0;
+}
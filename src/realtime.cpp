@@ -0,0 +1,248 @@
+/**
+ * @file realtime.cpp
+ *
+ * @brief      Core pinning, SCHED_FIFO and memory locking. See realtime.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "../include/rc/realtime.h"
+#ifdef _WIN32
+#include <Windows.h>
+#include <malloc.h>	// for _alloca
+#define alloca _alloca
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <alloca.h>
+#include <sys/mman.h>
+#ifdef __GLIBC__
+#include <malloc.h>	// for mallopt
+#endif
+#endif
+
+#define PAGE_BYTES	4096	// smallest page size touched to fault a page in
+
+static rc_rt_config_t config;
+static std::atomic<int> enabled(0);
+
+static const char* role_names[RC_RT_NUM_ROLES] = {
+	"acquisition",
+	"send",
+	"receive",
+	"worker"
+};
+
+
+// private local function declarations;
+static void __prefault_stack(size_t bytes);
+static void __prefault_heap(size_t bytes);
+static int __tune_malloc();
+static int __pin(rc_rt_role_t role);
+static int __set_priority(rc_rt_role_t role);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+// alloca moves the stack pointer down, so the pages touched are the ones
+// below the caller that later calls will use
+static void __prefault_stack(size_t bytes)
+{
+	volatile char* p;
+	size_t i;
+
+	if(bytes == 0) return;
+	p = (volatile char*)alloca(bytes);
+	for(i=0; i<bytes; i+=PAGE_BYTES) p[i] = 0;
+	p[bytes - 1] = 0;
+}
+
+
+// with trimming off the pages stay with malloc after the free
+static void __prefault_heap(size_t bytes)
+{
+	volatile char* p;
+	size_t i;
+
+	if(bytes == 0) return;
+	p = (volatile char*)malloc(bytes);
+	if(p == NULL){
+		fprintf(stderr, "ERROR: in rc_rt_start, failed to allocate %zu bytes to prefault\n", bytes);
+		return;
+	}
+	for(i=0; i<bytes; i+=PAGE_BYTES) p[i] = 0;
+	free((void*)p);
+}
+
+
+static int __tune_malloc()
+{
+#ifdef __GLIBC__
+	// never hand memory back, serve large blocks from the heap instead of
+	// fresh mappings, and one arena so every thread reuses the prefaulted one
+	if(!mallopt(M_TRIM_THRESHOLD, -1) || !mallopt(M_MMAP_MAX, 0) || !mallopt(M_ARENA_MAX, 1)){
+		fprintf(stderr, "ERROR: in rc_rt_start, mallopt failed\n");
+		return -1;
+	}
+#endif
+	return 0;
+}
+
+
+static int __pin(rc_rt_role_t role)
+{
+	int core = config.core[role];
+
+	if(core == RC_RT_ANY_CORE) return 0;
+#ifdef _WIN32
+	if(core < 0 || core >= (int)(8 * sizeof(DWORD_PTR)) ||
+	   SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) == 0){
+		fprintf(stderr, "ERROR: in rc_rt_enter, failed to pin the %s thread to core %d\n", role_names[role], core);
+		return -1;
+	}
+#else
+	cpu_set_t set;
+	int ret;
+
+	if(core < 0 || core >= CPU_SETSIZE){
+		fprintf(stderr, "ERROR: in rc_rt_enter, invalid core %d for the %s thread\n", core, role_names[role]);
+		return -1;
+	}
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	if(ret != 0){
+		fprintf(stderr, "ERROR: in rc_rt_enter, failed to pin the %s thread to core %d: %s\n",
+			role_names[role], core, strerror(ret));
+		return -1;
+	}
+#endif
+	return 0;
+}
+
+
+static int __set_priority(rc_rt_role_t role)
+{
+	int priority = config.priority[role];
+
+	if(priority <= 0) return 0;
+#ifdef _WIN32
+	if(!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)){
+		fprintf(stderr, "ERROR: in rc_rt_enter, SetThreadPriority failed for the %s thread\n", role_names[role]);
+		return -1;
+	}
+#else
+	struct sched_param param;
+	int ret;
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = priority;
+	ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+	if(ret != 0){
+		fprintf(stderr, "ERROR: in rc_rt_enter, SCHED_FIFO priority %d refused for the %s thread: %s\n",
+			priority, role_names[role], strerror(ret));
+		return -1;
+	}
+#endif
+	return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR realtime.h
+////////////////////////////////////////////////////////////////////////////////
+
+void rc_rt_default_config(rc_rt_config_t* cfg)
+{
+	int i;
+
+	for(i=0; i<RC_RT_NUM_ROLES; i++) cfg->core[i] = RC_RT_ANY_CORE;
+	cfg->priority[RC_RT_ACQUISITION] = RC_RT_DEFAULT_PRIORITY_ACQUISITION;
+	cfg->priority[RC_RT_SEND] = RC_RT_DEFAULT_PRIORITY_SEND;
+	cfg->priority[RC_RT_RECEIVE] = RC_RT_DEFAULT_PRIORITY_RECEIVE;
+	cfg->priority[RC_RT_WORKER] = RC_RT_DEFAULT_PRIORITY_SEND;
+	cfg->lock_memory = 1;
+	cfg->stack_bytes = RC_RT_DEFAULT_STACK_BYTES;
+	cfg->heap_bytes = RC_RT_DEFAULT_HEAP_BYTES;
+}
+
+
+int rc_rt_parse_cores(const char* list, rc_rt_config_t* cfg)
+{
+	const char* p = list;
+	char* end;
+	long core;
+	int i;
+
+	for(i=0; i<RC_RT_WORKER && *p; i++){
+		core = strtol(p, &end, 10);
+		if(end == p || core < RC_RT_ANY_CORE || core > 1023 || (*end != ',' && *end != 0)){
+			fprintf(stderr, "ERROR: in rc_rt_parse_cores, invalid core list %s\n", list);
+			return -1;
+		}
+		cfg->core[i] = (int)core;
+		p = *end ? end + 1 : end;
+	}
+	if(*p){
+		fprintf(stderr, "ERROR: in rc_rt_parse_cores, more than %d cores in %s\n", RC_RT_WORKER, list);
+		return -1;
+	}
+	return 0;
+}
+
+
+int rc_rt_start(const rc_rt_config_t* cfg)
+{
+	int ret = 0;
+
+	config = *cfg;
+	if(__tune_malloc()) ret = -1;
+#ifndef _WIN32
+	if(config.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0){
+		perror("ERROR: in rc_rt_start, mlockall failed");
+		ret = -1;
+	}
+#endif
+	__prefault_heap(config.heap_bytes);
+	__prefault_stack(config.stack_bytes);
+	enabled.store(1);
+	return ret;
+}
+
+
+int rc_rt_is_enabled()
+{
+	return enabled.load();
+}
+
+
+int rc_rt_enter(rc_rt_role_t role)
+{
+	int ret = 0;
+
+	if(!enabled.load()) return 0;
+	if(role < 0 || role >= RC_RT_NUM_ROLES){
+		fprintf(stderr, "ERROR: in rc_rt_enter, invalid role\n");
+		return -1;
+	}
+	if(__pin(role)) ret = -1;
+	if(__set_priority(role)) ret = -1;
+	__prefault_stack(config.stack_bytes);
+	return ret;
+}
+
+
+void rc_rt_stop()
+{
+	if(!enabled.exchange(0)) return;
+#ifndef _WIN32
+	if(config.lock_memory) munlockall();
+#endif
+}
@@ -0,0 +1,120 @@
+/**
+ * @file relative_pose.cpp
+ *
+ * @brief      Pose of a target subject as seen from a vehicle. See
+ *             relative_pose.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <math.h>
+#include <vector>
+#include "../include/rc/relative_pose.h"
+
+// the pairs, one array per coordinate
+static std::vector<float> v_q[4];
+static std::vector<float> d_world[3];
+static std::vector<rc_relpose_t> results;
+static int num_pairs = 0;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR relative_pose.h
+////////////////////////////////////////////////////////////////////////////////
+
+void rc_relpose_clear()
+{
+	num_pairs = 0;
+}
+
+
+int rc_relpose_add(const double vehicle_pos[3], const double vehicle_q[4], const double target_pos[3],
+			const float target_vel[3])
+{
+	int k;
+
+	if(results.size() <= (size_t)num_pairs){
+		for(k=0; k<3; k++) d_world[k].resize(num_pairs + 1);
+		for(k=0; k<4; k++) v_q[k].resize(num_pairs + 1);
+		results.resize(num_pairs + 1);
+	}
+	for(k=0; k<3; k++) d_world[k][num_pairs] = (float)((target_pos[k] - vehicle_pos[k]) / 1000.0);
+	for(k=0; k<4; k++) v_q[k][num_pairs] = (float)vehicle_q[k];
+	for(k=0; k<3; k++) results[num_pairs].target_vel[k] = target_vel[k];
+	return num_pairs++;
+}
+
+
+void rc_relpose_compute()
+{
+	const float* dx = d_world[0].data();
+	const float* dy = d_world[1].data();
+	const float* dz = d_world[2].data();
+	const float* qx = v_q[0].data();
+	const float* qy = v_q[1].data();
+	const float* qz = v_q[2].data();
+	const float* qw = v_q[3].data();
+	rc_relpose_t* r = results.data();
+	float fx, fy, fz;
+	int i;
+
+	// world to body is the transpose of the quaternion's rotation, then
+	// forward-left-up to forward-right-down. No branches, so it vectorizes.
+	for(i=0; i<num_pairs; i++){
+		fx = (1.0f - 2.0f * (qy[i] * qy[i] + qz[i] * qz[i])) * dx[i]
+			+ 2.0f * (qx[i] * qy[i] + qw[i] * qz[i]) * dy[i]
+			+ 2.0f * (qx[i] * qz[i] - qw[i] * qy[i]) * dz[i];
+		fy = 2.0f * (qx[i] * qy[i] - qw[i] * qz[i]) * dx[i]
+			+ (1.0f - 2.0f * (qx[i] * qx[i] + qz[i] * qz[i])) * dy[i]
+			+ 2.0f * (qy[i] * qz[i] + qw[i] * qx[i]) * dz[i];
+		fz = 2.0f * (qx[i] * qz[i] + qw[i] * qy[i]) * dx[i]
+			+ 2.0f * (qy[i] * qz[i] - qw[i] * qx[i]) * dy[i]
+			+ (1.0f - 2.0f * (qx[i] * qx[i] + qy[i] * qy[i])) * dz[i];
+		r[i].body[0] = fx;
+		r[i].body[1] = -fy;
+		r[i].body[2] = -fz;
+		r[i].distance = sqrtf(fx * fx + fy * fy + fz * fz);
+	}
+	for(i=0; i<num_pairs; i++){
+		r[i].angle_x = atan2f(r[i].body[1], r[i].body[2]);
+		r[i].angle_y = atan2f(-r[i].body[0], r[i].body[2]);
+	}
+}
+
+
+const rc_relpose_t* rc_relpose_get(int pair)
+{
+	if(pair < 0 || pair >= num_pairs) return NULL;
+	return &results[pair];
+}
+
+
+void rc_relpose_reserve(int n)
+{
+	int k;
+
+	if(n < 0 || results.size() >= (size_t)n) return;
+	for(k=0; k<3; k++) d_world[k].resize(n);
+	for(k=0; k<4; k++) v_q[k].resize(n);
+	results.resize(n);
+}
+
+
+void rc_relpose_cleanup()
+{
+	int k;
+
+	for(k=0; k<3; k++){
+		d_world[k].clear();
+		d_world[k].shrink_to_fit();
+	}
+	for(k=0; k<4; k++){
+		v_q[k].clear();
+		v_q[k].shrink_to_fit();
+	}
+	results.clear();
+	results.shrink_to_fit();
+	num_pairs = 0;
+}
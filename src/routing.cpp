@@ -0,0 +1,652 @@
+/**
+ * @file routing.cpp
+ *
+ * @brief      Routing table saying where and how each subject's poses are
+ *             sent, loaded from a text file and reloaded when it changes. See
+ *             routing.h
+ *
+ * @date       10/18/2026
+ */
+
+#define _USE_MATH_DEFINES	// for M_PI
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <string>
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/routing.h"
+
+#define LINE_LEN	512
+
+struct rc_route_table_t{
+	std::vector<rc_route_t> routes;
+	std::vector<rc_route_dest_t> dests;
+	std::vector<uint32_t> hashes;	// one per route
+	std::vector<char> names;	// RC_MOCAP_NAME_LEN bytes per route
+	std::vector<int32_t> slots;	// route of each hash slot, -1 if empty
+	std::vector<rc_scan_obstacle_t> obstacles;
+	std::vector<char> targets;	// RC_MOCAP_NAME_LEN bytes per target
+	double origin[3];		// latitude, longitude, altitude
+	uint32_t mask;
+	uint32_t messages;		// every route's messages or'd together
+	uint32_t formats;		// and formats
+};
+
+// a table swapped out, freed once the frame loop has finished a frame since
+typedef struct retired_table_t{
+	rc_route_table_t* table;
+	uint64_t frames_done;
+} retired_table_t;
+
+typedef struct route_msg_name_t{
+	const char* name;
+	uint32_t flag;
+} route_msg_name_t;
+
+static const route_msg_name_t format_names[] = {
+	{"att_pos_mocap", RC_ROUTE_FORMAT_ATT_POS_MOCAP},
+	{"vision_position_estimate", RC_ROUTE_FORMAT_VISION_POSITION_ESTIMATE},
+	{"vicon_position_estimate", RC_ROUTE_FORMAT_VICON_POSITION_ESTIMATE},
+	{"local_position_ned", RC_ROUTE_FORMAT_LOCAL_POSITION_NED},
+	{"local_position_ned_cov", RC_ROUTE_FORMAT_LOCAL_POSITION_NED_COV},
+	{"gps_input", RC_ROUTE_FORMAT_GPS_INPUT},
+	{"hil_gps", RC_ROUTE_FORMAT_HIL_GPS},
+};
+
+static const route_msg_name_t msg_names[] = {
+	{"att_pos_mocap", RC_ROUTE_MSG_ATT_POS_MOCAP},
+	{"vision_speed_estimate", RC_ROUTE_MSG_VISION_SPEED_ESTIMATE},
+	{"neighbors", RC_ROUTE_MSG_NEIGHBORS},
+	{"collision", RC_ROUTE_MSG_COLLISION},
+	{"obstacle_distance", RC_ROUTE_MSG_OBSTACLE_DISTANCE},
+	{"landing_target", RC_ROUTE_MSG_LANDING_TARGET},
+	{"follow_target", RC_ROUTE_MSG_FOLLOW_TARGET},
+};
+
+// read by the frame loop
+static std::atomic<rc_route_table_t*> current(NULL);
+static std::atomic<uint64_t> frames_done(0);
+static std::atomic<uint64_t> generation(0);
+
+// owned by the watcher thread
+static std::vector<retired_table_t> retired;
+static std::string route_path;
+static time_t last_mtime;
+static off_t last_size;
+static std::thread watcher;
+static std::mutex lock;
+static std::condition_variable cv;
+static int stopping;
+
+
+// private local function declarations;
+static uint32_t __hash(const char* name);
+static int __parse_dests(char* list, rc_route_table_t* t, rc_route_t* r);
+static int __parse_option(const char* key, const char* value, rc_route_t* r, double* yaw, double offset[3],
+			int* ned, char* target);
+static void __compile_transform(rc_route_t* r, int ned, double yaw_deg, const double offset[3]);
+static int __parse_obstacle(const char* center, const char* rest, rc_route_table_t* t);
+static int __parse_origin(const char* lat_lon, const char* rest, rc_route_table_t* t);
+static int __parse_line(char* p, rc_route_table_t* t);
+static int __insert(rc_route_table_t* t, int route);
+static int __load(const char* path, rc_route_table_t** out);
+static void __free_retired(int all);
+static void __watch_loop();
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// FNV-1a with a murmur3 finalizer, as for shards
+static uint32_t __hash(const char* name)
+{
+	uint32_t h = 2166136261u;
+
+	while(*name){
+		h ^= (uint8_t)*name++;
+		h *= 16777619u;
+	}
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+
+// ip[:port] entries separated by commas
+static int __parse_dests(char* list, rc_route_table_t* t, rc_route_t* r)
+{
+	rc_route_dest_t d;
+	char* next;
+	char* colon;
+	char* slash;
+	unsigned int i;
+	int port;
+
+	r->first_dest = (uint16_t)t->dests.size();
+	r->num_dests = 0;
+	r->formats = 0;
+	while(list != NULL && *list){
+		next = strchr(list, ',');
+		if(next != NULL) *next++ = 0;
+		slash = strchr(list, '/');
+		d.format = RC_ROUTE_FORMAT_ATT_POS_MOCAP;
+		if(slash != NULL){
+			*slash++ = 0;
+			for(i=0; i<sizeof(format_names)/sizeof(format_names[0]); i++){
+				if(strcmp(slash, format_names[i].name) == 0) break;
+			}
+			if(i == sizeof(format_names)/sizeof(format_names[0])) return -1;
+			d.format = (uint8_t)format_names[i].flag;
+		}
+		colon = strchr(list, ':');
+		d.port = 0;
+		if(colon != NULL){
+			*colon = 0;
+			port = atoi(colon + 1);
+			if(port < 1 || port > 65535) return -1;
+			d.port = (uint16_t)port;
+		}
+		if(rc_mav_parse_ip(list, &d.addr)) return -1;
+		if(r->num_dests == RC_ROUTE_MAX_DESTS || t->dests.size() >= 65535) return -1;
+		t->dests.push_back(d);
+		r->num_dests++;
+		r->formats |= (uint8_t)(1u << d.format);
+		list = next;
+	}
+	return r->num_dests > 0 ? 0 : -1;
+}
+
+
+static int __parse_option(const char* key, const char* value, rc_route_t* r, double* yaw, double offset[3],
+			int* ned, char* target)
+{
+	char list[LINE_LEN];
+	char* name;
+	char* next;
+	double rate;
+	unsigned int i;
+	int sysid, count;
+
+	if(strcmp(key, "sysid") == 0){
+		sysid = atoi(value);
+		if(sysid < 1 || sysid > 255) return -1;
+		r->sysid = (uint8_t)sysid;
+	}
+	else if(strcmp(key, "msgs") == 0){
+		strncpy(list, value, sizeof(list) - 1);
+		list[sizeof(list) - 1] = 0;
+		r->messages = 0;
+		for(name = list; name != NULL && *name; name = next){
+			next = strchr(name, ',');
+			if(next != NULL) *next++ = 0;
+			for(i=0; i<sizeof(msg_names)/sizeof(msg_names[0]); i++){
+				if(strcmp(name, msg_names[i].name) == 0) break;
+			}
+			if(i == sizeof(msg_names)/sizeof(msg_names[0])) return -1;
+			r->messages |= msg_names[i].flag;
+		}
+		if(r->messages == 0) return -1;
+	}
+	else if(strcmp(key, "rate") == 0){
+		rate = atof(value);
+		if(rate <= 0.0) return -1;
+		r->period_usec = (uint32_t)(1000000.0 / rate);
+	}
+	else if(strcmp(key, "speed_rate") == 0){
+		rate = atof(value);
+		if(rate <= 0.0) return -1;
+		r->speed_period_usec = (uint32_t)(1000000.0 / rate);
+	}
+	else if(strcmp(key, "scan_rate") == 0){
+		rate = atof(value);
+		if(rate <= 0.0) return -1;
+		r->scan_period_usec = (uint32_t)(1000000.0 / rate);
+	}
+	else if(strcmp(key, "neighbors") == 0){
+		count = atoi(value);
+		if(count < 1 || count > RC_ROUTE_MAX_NEIGHBORS) return -1;
+		r->neighbors = (uint8_t)count;
+	}
+	else if(strcmp(key, "filter") == 0){
+		if(strcmp(value, "mean") == 0) r->filter = RC_ROUTE_FILTER_MEAN;
+		else if(strcmp(value, "drop") == 0) r->filter = RC_ROUTE_FILTER_DROP;
+		else return -1;
+	}
+	else if(strcmp(key, "target") == 0){
+		if(*value == 0 || strlen(value) >= RC_MOCAP_NAME_LEN) return -1;
+		strcpy(target, value);
+	}
+	else if(strcmp(key, "frame") == 0){
+		if(strcmp(value, "raw") == 0) *ned = 0;
+		else if(strcmp(value, "ned") == 0) *ned = 1;
+		else return -1;
+	}
+	else if(strcmp(key, "yaw") == 0){
+		*yaw = atof(value);
+	}
+	else if(strcmp(key, "offset") == 0){
+		if(sscanf(value, "%lf,%lf,%lf", &offset[0], &offset[1], &offset[2]) != 3) return -1;
+	}
+	else return -1;
+	return 0;
+}
+
+
+// Vicon is x forward, y left, z up in millimeters with an x y z w quaternion.
+// The NED position is Rz(yaw) * diag(1,-1,-1) * xyz / 1000, and the attitude
+// is flipped the same way on both sides, which negates y and z of the
+// quaternion, before the yaw is applied.
+static void __compile_transform(rc_route_t* r, int ned, double yaw_deg, const double offset[3])
+{
+	rc_route_transform_t* t = &r->transform;
+	double h = yaw_deg * M_PI / 180.0;
+	double c = cos(h) / 1000.0;
+	double s = sin(h) / 1000.0;
+
+	memset(t, 0, sizeof(*t));
+	t->ned = ned;
+	if(!ned) return;
+	t->m[0] = (float)c;	t->m[1] = (float)s;	t->m[2] = 0.0f;
+	t->m[3] = (float)s;	t->m[4] = (float)-c;	t->m[5] = 0.0f;
+	t->m[6] = 0.0f;		t->m[7] = 0.0f;		t->m[8] = -0.001f;
+	t->offset[0] = (float)offset[0];
+	t->offset[1] = (float)offset[1];
+	t->offset[2] = (float)offset[2];
+	t->q[0] = (float)cos(h / 2.0);
+	t->q[3] = (float)sin(h / 2.0);
+}
+
+
+// obstacle <x>,<y> <radius> in meters, kept in millimeters
+static int __parse_obstacle(const char* center, const char* rest, rc_route_table_t* t)
+{
+	rc_scan_obstacle_t o;
+	char extra[2];
+	double x, y, radius;
+
+	if(sscanf(center, "%lf,%lf", &x, &y) != 2) return -1;
+	if(sscanf(rest, "%lf %1s", &radius, extra) != 1 || radius <= 0.0) return -1;
+	o.x = (float)(x * 1000.0);
+	o.y = (float)(y * 1000.0);
+	o.radius = (float)(radius * 1000.0);
+	t->obstacles.push_back(o);
+	return 0;
+}
+
+
+// origin <lat>,<lon> <alt> in degrees and meters
+static int __parse_origin(const char* lat_lon, const char* rest, rc_route_table_t* t)
+{
+	char extra[2];
+	double lat, lon, alt;
+
+	if(sscanf(lat_lon, "%lf,%lf", &lat, &lon) != 2 || fabs(lat) > 90.0 || fabs(lon) > 180.0) return -1;
+	if(sscanf(rest, "%lf %1s", &alt, extra) != 1) return -1;
+	t->origin[0] = lat;
+	t->origin[1] = lon;
+	t->origin[2] = alt;
+	return 0;
+}
+
+
+static int __parse_line(char* p, rc_route_table_t* t)
+{
+	char subject[RC_MOCAP_NAME_LEN];
+	char dests[LINE_LEN];
+	char option[LINE_LEN];
+	char target[RC_MOCAP_NAME_LEN];
+	char* eq;
+	rc_route_t r;
+	double yaw = 0.0;
+	double offset[3] = {0.0, 0.0, 0.0};
+	int ned = 0;
+	int n;
+
+	if(sscanf(p, "%63s %511s%n", subject, dests, &n) != 2) return -1;
+	p += n;
+	if(strcmp(subject, "obstacle") == 0) return __parse_obstacle(dests, p, t);
+	if(strcmp(subject, "origin") == 0) return __parse_origin(dests, p, t);
+	memset(&r, 0, sizeof(r));
+	r.messages = RC_ROUTE_MSG_ATT_POS_MOCAP;
+	r.speed_period_usec = (uint32_t)(1000000.0 / RC_ROUTE_DEFAULT_SPEED_HZ);
+	r.scan_period_usec = (uint32_t)(1000000.0 / RC_ROUTE_DEFAULT_SCAN_HZ);
+	r.neighbors = RC_ROUTE_DEFAULT_NEIGHBORS;
+	target[0] = 0;
+	if(__parse_dests(dests, t, &r)) return -1;
+	while(sscanf(p, "%511s%n", option, &n) == 1){
+		p += n;
+		eq = strchr(option, '=');
+		if(eq == NULL) return -1;
+		*eq = 0;
+		if(__parse_option(option, eq + 1, &r, &yaw, offset, &ned, target)) return -1;
+	}
+	__compile_transform(&r, ned, yaw, offset);
+	r.target = -1;
+	if(target[0]){
+		r.target = (int16_t)(t->targets.size() / RC_MOCAP_NAME_LEN);
+		t->targets.insert(t->targets.end(), RC_MOCAP_NAME_LEN, 0);
+		strcpy(&t->targets[(size_t)r.target * RC_MOCAP_NAME_LEN], target);
+	}
+
+	t->routes.push_back(r);
+	t->hashes.push_back(__hash(subject));
+	t->names.insert(t->names.end(), RC_MOCAP_NAME_LEN, 0);
+	strcpy(&t->names[(t->routes.size() - 1) * RC_MOCAP_NAME_LEN], subject);
+	return 0;
+}
+
+
+// returns -1 if the subject already has a route
+static int __insert(rc_route_table_t* t, int route)
+{
+	const char* name = &t->names[(size_t)route * RC_MOCAP_NAME_LEN];
+	uint32_t i = t->hashes[route] & t->mask;
+	int other;
+
+	while((other = t->slots[i]) >= 0){
+		if(t->hashes[other] == t->hashes[route] &&
+				strcmp(&t->names[(size_t)other * RC_MOCAP_NAME_LEN], name) == 0) return -1;
+		i = (i + 1) & t->mask;
+	}
+	t->slots[i] = route;
+	return 0;
+}
+
+
+// compiles the file into a new table, an empty one if the file is missing
+static int __load(const char* path, rc_route_table_t** out)
+{
+	FILE* f;
+	char line[LINE_LEN];
+	char* p;
+	rc_route_table_t* t = new rc_route_table_t;
+	uint32_t size;
+	int i, line_num = 0, errors = 0;
+
+	t->origin[0] = t->origin[1] = t->origin[2] = 0.0;
+	f = fopen(path, "r");
+	if(f != NULL){
+		while(fgets(line, sizeof(line), f) != NULL){
+			line_num++;
+			p = line;
+			while(isspace((unsigned char)*p)) p++;
+			if(*p == 0 || *p == '#') continue;
+			if(__parse_line(p, t)){
+				fprintf(stderr, "ERROR: %s:%d malformed route\n", path, line_num);
+				errors++;
+			}
+		}
+		fclose(f);
+	}
+
+	// at most half full so probes stay short
+	for(size = 16; size < 2 * t->routes.size(); size *= 2);
+	t->mask = size - 1;
+	t->slots.assign(size, -1);
+	t->messages = 0;
+	t->formats = 0;
+	for(i=0; i<(int)t->routes.size(); i++){
+		t->messages |= t->routes[i].messages;
+		t->formats |= t->routes[i].formats;
+		if(__insert(t, i)){
+			fprintf(stderr, "ERROR: %s: %s is routed more than once\n", path,
+				&t->names[(size_t)i * RC_MOCAP_NAME_LEN]);
+			errors++;
+		}
+	}
+	if(errors){
+		delete t;
+		return -1;
+	}
+	*out = t;
+	return (int)t->routes.size();
+}
+
+
+static void __free_retired(int all)
+{
+	uint64_t done = frames_done.load(std::memory_order_acquire);
+	size_t i = 0;
+
+	while(i < retired.size()){
+		if(all || done > retired[i].frames_done){
+			delete retired[i].table;
+			retired[i] = retired.back();
+			retired.pop_back();
+		}
+		else i++;
+	}
+}
+
+
+static void __watch_loop()
+{
+	struct stat st;
+	rc_route_table_t* t;
+	rc_route_table_t* old;
+
+	while(1){
+		{
+			std::unique_lock<std::mutex> l(lock);
+			cv.wait_for(l, std::chrono::milliseconds(RC_ROUTE_POLL_MS), []{ return stopping != 0; });
+			if(stopping) return;
+		}
+		__free_retired(0);
+
+		// a file that disappears, for example while an editor saves it,
+		// keeps the last table
+		if(stat(route_path.c_str(), &st) != 0) continue;
+		if(st.st_mtime == last_mtime && st.st_size == last_size) continue;
+		last_mtime = st.st_mtime;
+		last_size = st.st_size;
+		if(__load(route_path.c_str(), &t) < 0){
+			fprintf(stderr, "ERROR: %s has errors, keeping the previous routes\n", route_path.c_str());
+			continue;
+		}
+
+		// any frame that could still be using the old table ends after this
+		old = current.exchange(t, std::memory_order_acq_rel);
+		retired.push_back({old, frames_done.load(std::memory_order_acquire)});
+		generation.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR routing.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_route_start(const char* path)
+{
+	struct stat st;
+	rc_route_table_t* t;
+	int n;
+
+	if(current.load() != NULL){
+		fprintf(stderr, "ERROR: in rc_route_start, routing already started\n");
+		return -1;
+	}
+	route_path = path;
+	last_mtime = 0;
+	last_size = 0;
+	if(stat(path, &st) == 0){
+		last_mtime = st.st_mtime;
+		last_size = st.st_size;
+	}
+	n = __load(path, &t);
+	if(n < 0) return -1;
+	current.store(t, std::memory_order_release);
+	generation.store(1);
+	stopping = 0;
+	watcher = std::thread(__watch_loop);
+	return n;
+}
+
+
+void rc_route_stop()
+{
+	if(current.load() == NULL) return;
+	{
+		std::lock_guard<std::mutex> l(lock);
+		stopping = 1;
+	}
+	cv.notify_all();
+	watcher.join();
+	__free_retired(1);
+	delete current.exchange(NULL);
+}
+
+
+const rc_route_table_t* rc_route_acquire()
+{
+	return current.load(std::memory_order_acquire);
+}
+
+
+void rc_route_release()
+{
+	frames_done.fetch_add(1, std::memory_order_release);
+}
+
+
+const rc_route_t* rc_route_find(const rc_route_table_t* table, const char* name)
+{
+	uint32_t h, i;
+	int r;
+
+	if(table == NULL || table->routes.empty()) return NULL;
+	h = __hash(name);
+	for(i = h & table->mask; (r = table->slots[i]) >= 0; i = (i + 1) & table->mask){
+		if(table->hashes[r] == h && strcmp(&table->names[(size_t)r * RC_MOCAP_NAME_LEN], name) == 0){
+			return &table->routes[r];
+		}
+	}
+	return NULL;
+}
+
+
+const rc_route_dest_t* rc_route_dests(const rc_route_table_t* table, const rc_route_t* route)
+{
+	return &table->dests[route->first_dest];
+}
+
+
+const char* rc_route_target(const rc_route_table_t* table, const rc_route_t* route)
+{
+	if(route->target < 0) return NULL;
+	return &table->targets[(size_t)route->target * RC_MOCAP_NAME_LEN];
+}
+
+
+uint32_t rc_route_messages(const rc_route_table_t* table)
+{
+	return table == NULL ? 0 : table->messages;
+}
+
+
+uint32_t rc_route_formats(const rc_route_table_t* table)
+{
+	return table == NULL ? 0 : table->formats;
+}
+
+
+const rc_scan_obstacle_t* rc_route_obstacles(const rc_route_table_t* table, int* count)
+{
+	if(table == NULL || table->obstacles.empty()){
+		*count = 0;
+		return NULL;
+	}
+	*count = (int)table->obstacles.size();
+	return table->obstacles.data();
+}
+
+
+void rc_route_origin(const rc_route_table_t* table, double* lat_deg, double* lon_deg, double* alt_m)
+{
+	*lat_deg = table == NULL ? 0.0 : table->origin[0];
+	*lon_deg = table == NULL ? 0.0 : table->origin[1];
+	*alt_m = table == NULL ? 0.0 : table->origin[2];
+}
+
+
+uint64_t rc_route_generation()
+{
+	return generation.load(std::memory_order_relaxed);
+}
+
+
+void rc_route_transform(const rc_route_transform_t* t, const double xyz[3],
+			const double q_in[4], float pos[3], float q[4])
+{
+	const float* a = t->q;
+	float w, x, y, z;
+	int i;
+
+	if(!t->ned){
+		for(i=0; i<3; i++) pos[i] = (float)xyz[i];
+		for(i=0; i<4; i++) q[i] = (float)q_in[i];
+		return;
+	}
+	for(i=0; i<3; i++){
+		pos[i] = (float)(t->m[3*i] * xyz[0] + t->m[3*i+1] * xyz[1] + t->m[3*i+2] * xyz[2]) + t->offset[i];
+	}
+	w = (float)q_in[3];
+	x = (float)q_in[0];
+	y = (float)-q_in[1];
+	z = (float)-q_in[2];
+	q[0] = a[0]*w - a[1]*x - a[2]*y - a[3]*z;
+	q[1] = a[0]*x + a[1]*w + a[2]*z - a[3]*y;
+	q[2] = a[0]*y - a[1]*z + a[2]*w + a[3]*x;
+	q[3] = a[0]*z + a[1]*y - a[2]*x + a[3]*w;
+}
+
+
+void rc_route_transform_vector(const rc_route_transform_t* t, const float in[3], int translate, float out[3])
+{
+	int i;
+
+	if(!t->ned){
+		for(i=0; i<3; i++) out[i] = in[i];
+		return;
+	}
+	for(i=0; i<3; i++){
+		out[i] = t->m[3*i] * in[0] + t->m[3*i+1] * in[1] + t->m[3*i+2] * in[2];
+		if(translate) out[i] += t->offset[i];
+	}
+}
+
+
+// the diagonal rotated and scaled, m diag(var) m^T
+void rc_route_transform_covariance(const rc_route_transform_t* t, const float var[3], float cov[6])
+{
+	const float* m = t->m;
+	int i, j, k, n = 0;
+
+	for(i=0; i<3; i++){
+		for(j=i; j<3; j++){
+			if(!t->ned){
+				cov[n++] = i == j ? var[i] : 0.0f;
+				continue;
+			}
+			cov[n] = 0.0f;
+			for(k=0; k<3; k++) cov[n] += m[3*i+k] * m[3*j+k] * var[k];
+			n++;
+		}
+	}
+}
@@ -0,0 +1,225 @@
+/**
+ * @file spatial_grid.cpp
+ *
+ * @brief      Uniform spatial hash grid over the subject positions of one
+ *             frame. See spatial_grid.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <math.h>
+#include <vector>
+#include "../include/rc/spatial_grid.h"
+
+// the points, sorted by table entry
+typedef struct grid_point_t{
+	float p[3];
+	int32_t c[3];			// cube, to skip other cubes sharing the entry
+	int32_t id;
+} grid_point_t;
+
+static std::vector<grid_point_t> points;
+static std::vector<grid_point_t> unsorted;
+static std::vector<uint32_t> start;	// first point of each entry, plus one past the end
+static std::vector<uint32_t> entry;	// entry of each unsorted point
+static uint32_t mask;
+static float cell_size = RC_GRID_DEFAULT_CELL;
+static float inv_cell = 1.0f / RC_GRID_DEFAULT_CELL;
+
+
+// private local function declarations;
+static inline uint32_t __hash(int32_t cx, int32_t cy, int32_t cz);
+static inline int32_t __cube(float v);
+static float __auto_cell(const float* x, const float* y, const float* z, int n);
+static void __consider(const grid_point_t* g, const float p[3], int self, int k, int* out, float* d2, int* found);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// the usual three large primes of spatial hashing
+static inline uint32_t __hash(int32_t cx, int32_t cy, int32_t cz)
+{
+	return (((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u) ^ ((uint32_t)cz * 83492791u)) & mask;
+}
+
+
+static inline int32_t __cube(float v)
+{
+	return (int32_t)floorf(v * inv_cell);
+}
+
+
+// cube holding about RC_GRID_POINTS_PER_CELL points on average. A swarm
+// flying at one height or along a line has little or no volume, so the
+// size is worked out as if the points filled a volume, an area or a line
+// and the largest of the three taken.
+static float __auto_cell(const float* x, const float* y, const float* z, int n)
+{
+	float lo[3] = {x[0], y[0], z[0]};
+	float hi[3] = {x[0], y[0], z[0]};
+	float e[3], t, c1, c2, c3;
+	int i;
+
+	for(i=1; i<n; i++){
+		if(x[i] < lo[0]) lo[0] = x[i];
+		if(x[i] > hi[0]) hi[0] = x[i];
+		if(y[i] < lo[1]) lo[1] = y[i];
+		if(y[i] > hi[1]) hi[1] = y[i];
+		if(z[i] < lo[2]) lo[2] = z[i];
+		if(z[i] > hi[2]) hi[2] = z[i];
+	}
+	for(i=0; i<3; i++) e[i] = hi[i] - lo[i];
+	// largest extent first
+	if(e[0] < e[1]){ t = e[0]; e[0] = e[1]; e[1] = t; }
+	if(e[1] < e[2]){ t = e[1]; e[1] = e[2]; e[2] = t; }
+	if(e[0] < e[1]){ t = e[0]; e[0] = e[1]; e[1] = t; }
+	c1 = e[0] * RC_GRID_POINTS_PER_CELL / n;
+	c2 = sqrtf(e[0] * e[1] * RC_GRID_POINTS_PER_CELL / n);
+	c3 = cbrtf(e[0] * e[1] * e[2] * RC_GRID_POINTS_PER_CELL / n);
+	t = c1 > c2 ? c1 : c2;
+	t = t > c3 ? t : c3;
+	return t > 0.0f ? t : RC_GRID_DEFAULT_CELL;
+}
+
+
+// keeps the k nearest seen so far sorted in out and d2
+static void __consider(const grid_point_t* g, const float p[3], int self, int k, int* out, float* d2, int* found)
+{
+	float dx = g->p[0] - p[0];
+	float dy = g->p[1] - p[1];
+	float dz = g->p[2] - p[2];
+	float d = dx * dx + dy * dy + dz * dz;
+	int i;
+
+	if(g->id == self) return;
+	if(*found == k && d >= d2[k - 1]) return;
+	i = *found < k ? (*found)++ : k - 1;
+	while(i > 0 && d2[i - 1] > d){
+		d2[i] = d2[i - 1];
+		out[i] = out[i - 1];
+		i--;
+	}
+	d2[i] = d;
+	out[i] = g->id;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR spatial_grid.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_grid_build(const float* x, const float* y, const float* z, int n, float cell)
+{
+	uint32_t size, e;
+	grid_point_t* g;
+	int i;
+
+	if(n < 0 || cell != cell){
+		fprintf(stderr, "ERROR: in rc_grid_build, invalid point count or cube size\n");
+		return -1;
+	}
+	if(cell <= 0.0f) cell = n > 1 ? __auto_cell(x, y, z, n) : RC_GRID_DEFAULT_CELL;
+	cell_size = cell;
+	inv_cell = 1.0f / cell;
+	for(size = 16; size < 2u * (uint32_t)n; size *= 2);
+	mask = size - 1;
+	unsorted.resize(n);
+	points.resize(n);
+	entry.resize(n);
+	start.assign(size + 1, 0);
+
+	// count the points of every entry
+	for(i=0; i<n; i++){
+		g = &unsorted[i];
+		g->p[0] = x[i];
+		g->p[1] = y[i];
+		g->p[2] = z[i];
+		g->c[0] = __cube(x[i]);
+		g->c[1] = __cube(y[i]);
+		g->c[2] = __cube(z[i]);
+		g->id = i;
+		entry[i] = __hash(g->c[0], g->c[1], g->c[2]);
+		start[entry[i] + 1]++;
+	}
+	for(e=0; e<size; e++) start[e + 1] += start[e];
+	// scatter, using start as the insertion point and shifting it back after
+	for(i=0; i<n; i++) points[start[entry[i]]++] = unsorted[i];
+	for(e=size; e>0; e--) start[e] = start[e - 1];
+	start[0] = 0;
+	return 0;
+}
+
+
+int rc_grid_nearest(const float p[3], int self, int k, int* out)
+{
+	float d2[64];
+	int32_t c[3];
+	uint32_t e, j;
+	int found = 0;
+	int r, dx, dy, dz, step;
+	float reach, lo, hi;
+
+	if(k < 1 || points.empty()) return 0;
+	if(k > 64) k = 64;
+	c[0] = __cube(p[0]);
+	c[1] = __cube(p[1]);
+	c[2] = __cube(p[2]);
+	for(r=0; r<=RC_GRID_MAX_SHELLS; r++){
+		for(dx=-r; dx<=r; dx++){
+			for(dy=-r; dy<=r; dy++){
+				// only the surface of the shell, the inside was searched before
+				step = (dx == -r || dx == r || dy == -r || dy == r) ? 1 : 2 * r;
+				for(dz=-r; dz<=r; dz+=step){
+					e = __hash(c[0] + dx, c[1] + dy, c[2] + dz);
+					for(j=start[e]; j<start[e + 1]; j++){
+						if(points[j].c[0] != c[0] + dx || points[j].c[1] != c[1] + dy ||
+								points[j].c[2] != c[2] + dz) continue;
+						__consider(&points[j], p, self, k, out, d2, &found);
+					}
+				}
+			}
+		}
+		// anything outside the block searched is at least as far as its
+		// nearest face
+		reach = (2 * r + 1) * cell_size;
+		for(dx=0; dx<3; dx++){
+			lo = p[dx] - (c[dx] - r) * cell_size;
+			hi = (c[dx] + r + 1) * cell_size - p[dx];
+			if(lo < reach) reach = lo;
+			if(hi < reach) reach = hi;
+		}
+		if(found == k && d2[k - 1] <= reach * reach) break;
+	}
+	return found;
+}
+
+
+void rc_grid_reserve(int n)
+{
+	uint32_t size;
+
+	if(n < 0) return;
+	for(size = 16; size < 2u * (uint32_t)n; size *= 2);
+	points.reserve(n);
+	unsorted.reserve(n);
+	entry.reserve(n);
+	start.reserve(size + 1);
+}
+
+
+void rc_grid_cleanup()
+{
+	points.clear();
+	points.shrink_to_fit();
+	unsorted.clear();
+	unsorted.shrink_to_fit();
+	start.clear();
+	start.shrink_to_fit();
+	entry.clear();
+	entry.shrink_to_fit();
+}
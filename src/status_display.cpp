@@ -0,0 +1,263 @@
+/**
+ * @file status_display.cpp
+ *
+ * @brief      Asynchronous, rate-limited status table for the bridge. See
+ *             status_display.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include "../include/rc/status_display.h"
+
+#define LINE_LENGTH	160
+
+// everything one subject shows in the table, written only by the frame loop
+typedef struct display_slot_t{
+	std::atomic<uint32_t> seq;	// odd while the pose below is being written
+	std::atomic<int> active;
+	char name[RC_DISPLAY_NAME_LEN];
+	float q[4];
+	double xyz[3];
+	int occluded;
+	double latency_s;
+	std::atomic<uint64_t> sent;
+	std::atomic<uint64_t> occluded_count;
+	std::atomic<uint64_t> drops;
+} display_slot_t;
+
+// one merged mocap server, fields are independent so no seqlock is needed
+typedef struct display_server_t{
+	std::atomic<int> active;
+	char name[RC_DISPLAY_NAME_LEN];
+	std::atomic<uint64_t> frame_number;
+	std::atomic<double> lag_s;
+	std::atomic<double> latency_s;
+} display_server_t;
+
+// what the display thread remembers from its previous refresh
+typedef struct display_prev_t{
+	uint64_t sent;
+	uint64_t occluded_count;
+} display_prev_t;
+
+static display_slot_t slots[RC_DISPLAY_MAX_SUBJECTS];
+static display_prev_t prev[RC_DISPLAY_MAX_SUBJECTS];
+static display_server_t servers[RC_DISPLAY_MAX_SERVERS];
+static std::atomic<uint32_t> frame_number(0);
+static std::atomic<unsigned int> subject_count(0);
+static std::atomic<const char*> status_msg(NULL);
+static std::atomic<int> running(0);
+static std::thread display_thread;
+static double period_s;
+
+
+// private local function declarations;
+static void __render(double dt);
+static void __display_loop();
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+static void __render(double dt)
+{
+	std::string out;
+	char line[LINE_LENGTH];
+	display_slot_t snap;
+	uint32_t s1, s2;
+	uint64_t sent, occl, drops;
+	const char* msg;
+	int i;
+
+	// move to the top left and clear so the table redraws in place
+	out += "\x1b[H\x1b[J";
+	snprintf(line, sizeof(line), "frame %u   subjects %u\n",
+		frame_number.load(std::memory_order_relaxed),
+		subject_count.load(std::memory_order_relaxed));
+	out += line;
+	for(i=0; i<RC_DISPLAY_MAX_SERVERS; i++){
+		display_server_t* v = &servers[i];
+		if(!v->active.load(std::memory_order_acquire)) continue;
+		snprintf(line, sizeof(line), "server %d %-24.24s frame %10llu   lag %7.2f ms   sdk latency %7.2f ms\n",
+			i, v->name, (unsigned long long)v->frame_number.load(std::memory_order_relaxed),
+			v->lag_s.load(std::memory_order_relaxed) * 1000.0,
+			v->latency_s.load(std::memory_order_relaxed) * 1000.0);
+		out += line;
+	}
+	msg = status_msg.load(std::memory_order_acquire);
+	if(msg != NULL){
+		out += msg;
+		out += "\n";
+	}
+	snprintf(line, sizeof(line), "%-24s %8s %9s %7s %8s %8s %8s %8s %6s %6s %6s %6s\n",
+		"subject", "rate(Hz)", "lat(ms)", "occl%", "drops",
+		"x(mm)", "y(mm)", "z(mm)", "qw", "qx", "qy", "qz");
+	out += line;
+
+	for(i=0; i<RC_DISPLAY_MAX_SUBJECTS; i++){
+		display_slot_t* s = &slots[i];
+		if(!s->active.load(std::memory_order_acquire)) continue;
+
+		// seqlock read, retry if the frame loop wrote in the meantime
+		do{
+			s1 = s->seq.load(std::memory_order_acquire);
+			if(s1 & 1) continue;
+			memcpy(snap.name, s->name, sizeof(snap.name));
+			memcpy(snap.q, s->q, sizeof(snap.q));
+			memcpy(snap.xyz, s->xyz, sizeof(snap.xyz));
+			snap.latency_s = s->latency_s;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			s2 = s->seq.load(std::memory_order_relaxed);
+		}while((s1 & 1) || s1 != s2);
+		snap.name[RC_DISPLAY_NAME_LEN-1] = 0;
+
+		sent = s->sent.load(std::memory_order_relaxed);
+		occl = s->occluded_count.load(std::memory_order_relaxed);
+		drops = s->drops.load(std::memory_order_relaxed);
+		double rate = (double)(sent - prev[i].sent) / dt;
+		double occl_pct = sent > prev[i].sent ?
+			100.0 * (double)(occl - prev[i].occluded_count) / (double)(sent - prev[i].sent) : 0.0;
+		prev[i].sent = sent;
+		prev[i].occluded_count = occl;
+
+		snprintf(line, sizeof(line), "%-24.24s %8.1f %9.2f %7.1f %8llu %8.0f %8.0f %8.0f %6.2f %6.2f %6.2f %6.2f\n",
+			snap.name, rate, snap.latency_s * 1000.0, occl_pct,
+			(unsigned long long)drops,
+			snap.xyz[0], snap.xyz[1], snap.xyz[2],
+			snap.q[0], snap.q[1], snap.q[2], snap.q[3]);
+		out += line;
+	}
+	fwrite(out.data(), 1, out.size(), stdout);
+	fflush(stdout);
+}
+
+
+static void __display_loop()
+{
+	auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(period_s));
+	auto last = std::chrono::steady_clock::now();
+	auto next = last + period;
+
+	while(running.load()){
+		std::this_thread::sleep_until(next);
+		auto now = std::chrono::steady_clock::now();
+		__render(std::chrono::duration<double>(now - last).count());
+		last = now;
+		next += period;
+		// don't try to catch up after a stall, just skip the missed refreshes
+		if(next < now) next = now + period;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR status_display.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_display_start(double hz)
+{
+	if(running.load()){
+		fprintf(stderr, "ERROR: in rc_display_start, display already running\n");
+		return -1;
+	}
+	if(hz <= 0.0){
+		fprintf(stderr, "ERROR: in rc_display_start, hz must be positive\n");
+		return -1;
+	}
+#ifdef _WIN32
+	// let the Windows 10 console interpret the escape codes used to redraw
+	HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD mode;
+	if(GetConsoleMode(h, &mode)){
+		SetConsoleMode(h, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+	}
+#endif
+	period_s = 1.0 / hz;
+	running.store(1);
+	display_thread = std::thread(__display_loop);
+	return 0;
+}
+
+
+int rc_display_stop()
+{
+	if(!running.exchange(0)) return -1;
+	display_thread.join();
+	return 0;
+}
+
+
+void rc_display_publish_frame(uint32_t frame, unsigned int count)
+{
+	frame_number.store(frame, std::memory_order_relaxed);
+	subject_count.store(count, std::memory_order_relaxed);
+}
+
+
+void rc_display_publish_server(int server, const char* name, uint64_t frame,
+			double lag_s, double latency_s)
+{
+	display_server_t* v;
+
+	if(server < 0 || server >= RC_DISPLAY_MAX_SERVERS) return;
+	v = &servers[server];
+	if(!v->active.load(std::memory_order_relaxed)){
+		strncpy(v->name, name, RC_DISPLAY_NAME_LEN-1);
+	}
+	v->frame_number.store(frame, std::memory_order_relaxed);
+	v->lag_s.store(lag_s, std::memory_order_relaxed);
+	v->latency_s.store(latency_s, std::memory_order_relaxed);
+	v->active.store(1, std::memory_order_release);
+}
+
+
+void rc_display_set_status(const char* msg)
+{
+	status_msg.store(msg, std::memory_order_release);
+}
+
+
+void rc_display_publish_pose(int subject, const char* name, const float q[4],
+			const double xyz[3], int occluded, double latency_s)
+{
+	display_slot_t* s;
+	uint32_t seq;
+
+	if(subject < 0 || subject >= RC_DISPLAY_MAX_SUBJECTS) return;
+	s = &slots[subject];
+
+	seq = s->seq.load(std::memory_order_relaxed);
+	s->seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	strncpy(s->name, name, RC_DISPLAY_NAME_LEN-1);
+	memcpy(s->q, q, sizeof(s->q));
+	memcpy(s->xyz, xyz, sizeof(s->xyz));
+	s->occluded = occluded;
+	s->latency_s = latency_s;
+	s->seq.store(seq + 2, std::memory_order_release);
+
+	s->sent.fetch_add(1, std::memory_order_relaxed);
+	if(occluded) s->occluded_count.fetch_add(1, std::memory_order_relaxed);
+	s->active.store(1, std::memory_order_release);
+}
+
+
+void rc_display_count_drop(int subject)
+{
+	if(subject < 0 || subject >= RC_DISPLAY_MAX_SUBJECTS) return;
+	slots[subject].drops.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file synthetic_source.cpp
+ *
+ * @brief      MocapSource generating frames of any number of subjects without
+ *             a Vicon system. See mocap_source.h
+ *
+ * @date       10/18/2026
+ */
+
+#define _USE_MATH_DEFINES	// for M_PI on Windows
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include "../include/rc/latency_stats.h"
+#include "../include/rc/mocap_source.h"
+
+#define SYNTH_RADIUS_MM		1500.0
+#define SYNTH_PERIOD_S		10.0
+
+typedef std::chrono::steady_clock synth_clock;
+
+/**
+ * Generates every subject's pose from the frame number
+ */
+class SyntheticMocapSource : public MocapSource
+{
+public:
+	SyntheticMocapSource(int subjects, double rate_hz);
+	int next_frame(const rc_mocap_frame_t** frame);
+
+private:
+	double rate_hz;
+	uint64_t frame_number;
+	synth_clock::time_point next;
+	std::vector<uint64_t> buf;	// uint64_t keeps the frame 8 byte aligned
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR SyntheticMocapSource
+////////////////////////////////////////////////////////////////////////////////
+
+SyntheticMocapSource::SyntheticMocapSource(int subjects, double rate_hz) :
+	rate_hz(rate_hz), frame_number(0)
+{
+	rc_mocap_frame_t* f;
+	rc_mocap_subject_t* s;
+	int i;
+
+	buf.resize((rc_mocap_frame_size(subjects) + 7) / 8);
+	f = (rc_mocap_frame_t*)buf.data();
+	memset(f, 0, rc_mocap_frame_size(subjects));
+	f->size = rc_mocap_frame_size(subjects);
+	f->subject_count = subjects;
+	s = (rc_mocap_subject_t*)(f + 1);
+	// names never change, only poses are updated per frame
+	for(i=0; i<subjects; i++){
+		snprintf(s[i].name, RC_MOCAP_NAME_LEN, "synth%04d@127.%d.%d.%d",
+			i, (i + 1) >> 16, ((i + 1) >> 8) & 0xFF, (i + 1) & 0xFF);
+		s[i].quality = 1.0;
+		s[i].index = (uint16_t)i;
+	}
+	next = synth_clock::now();
+}
+
+
+int SyntheticMocapSource::next_frame(const rc_mocap_frame_t** frame)
+{
+	rc_mocap_frame_t* f = (rc_mocap_frame_t*)buf.data();
+	rc_mocap_subject_t* s = (rc_mocap_subject_t*)(f + 1);
+	double t, phase, yaw;
+	uint64_t start;
+	uint32_t i;
+
+	if(rate_hz > 0.0){
+		next += std::chrono::duration_cast<synth_clock::duration>(std::chrono::duration<double>(1.0 / rate_hz));
+		std::this_thread::sleep_until(next);
+	}
+
+	start = rc_lat_now();
+	frame_number++;
+	f->frame_number = frame_number;
+	f->capture_usec = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	t = rate_hz > 0.0 ? (double)frame_number / rate_hz : (double)frame_number / 400.0;
+	for(i=0; i<f->subject_count; i++){
+		phase = 2.0 * M_PI * (t / SYNTH_PERIOD_S + (double)i / (double)f->subject_count);
+		yaw = phase + M_PI / 2.0;
+		s[i].translation[0] = (SYNTH_RADIUS_MM + 10.0 * (i % 50)) * cos(phase);
+		s[i].translation[1] = (SYNTH_RADIUS_MM + 10.0 * (i % 50)) * sin(phase);
+		s[i].translation[2] = 500.0 + 20.0 * (i % 40);
+		// rotation about z in the SDK's x, y, z, w order
+		s[i].quaternion[0] = 0.0;
+		s[i].quaternion[1] = 0.0;
+		s[i].quaternion[2] = sin(yaw / 2.0);
+		s[i].quaternion[3] = cos(yaw / 2.0);
+	}
+	rc_lat_record(RC_LAT_ACQUIRE, RC_LAT_ALL_SUBJECTS, start);
+
+	*frame = f;
+	return RC_MOCAP_FRAME;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR mocap_source.h
+////////////////////////////////////////////////////////////////////////////////
+
+MocapSource* rc_mocap_synthetic_source_create(int subjects, double rate_hz)
+{
+	if(subjects < 1 || subjects > 65535 || rate_hz < 0.0){
+		fprintf(stderr, "ERROR: in rc_mocap_synthetic_source_create, invalid arguments\n");
+		return NULL;
+	}
+	return new SyntheticMocapSource(subjects, rate_hz);
+}
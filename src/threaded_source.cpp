@@ -0,0 +1,148 @@
+/**
+ * @file threaded_source.cpp
+ *
+ * @brief      MocapSource that runs another source on its own acquisition
+ *             thread and hands frames over without blocking. See
+ *             mocap_source.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "../include/rc/mocap_source.h"
+#include "../include/rc/realtime.h"
+
+/**
+ * Runs a source on a thread, one frame in flight
+ */
+class ThreadedMocapSource : public MocapSource
+{
+public:
+	ThreadedMocapSource(MocapSource* source, void (*on_frame)()) :
+		source(source), on_frame(on_frame), running(1), reserve_subjects(0), full(0), ended(0) {}
+	~ThreadedMocapSource();
+
+	void start();
+	int next_frame(const rc_mocap_frame_t** frame);
+	void reserve(int max_subjects);
+
+private:
+	void acquire();
+
+	MocapSource* source;
+	void (*on_frame)();
+	std::thread thread;
+	std::atomic<int> running;
+	std::atomic<int> reserve_subjects;	// for the thread to reserve the source for, 0 for none
+	std::mutex lock;
+	std::condition_variable cv;
+	std::vector<uint64_t> slot;	// uint64_t keeps the frame 8 byte aligned
+	int full;			// slot holds a frame not yet returned
+	int ended;			// the source ran out of frames
+	std::vector<uint64_t> out;	// the frame last returned
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR ThreadedMocapSource
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadedMocapSource::~ThreadedMocapSource()
+{
+	running.store(0);
+	{
+		std::lock_guard<std::mutex> l(lock);
+		full = 0;
+	}
+	cv.notify_one();
+	if(thread.joinable()) thread.join();
+	delete source;
+}
+
+
+void ThreadedMocapSource::start()
+{
+	thread = std::thread(&ThreadedMocapSource::acquire, this);
+}
+
+
+void ThreadedMocapSource::acquire()
+{
+	const rc_mocap_frame_t* f;
+	int n, ret;
+
+	rc_rt_enter(RC_RT_ACQUISITION);
+	while(running.load()){
+		// the source is only ever touched from this thread
+		n = reserve_subjects.exchange(0);
+		if(n > 0) source->reserve(n);
+		ret = source->next_frame(&f);
+		if(ret == RC_MOCAP_END) break;
+		if(ret != RC_MOCAP_FRAME) continue;
+		{
+			// wait for the last frame to be taken so replays drop nothing
+			std::unique_lock<std::mutex> l(lock);
+			cv.wait(l, [this]{ return !full || !running.load(); });
+			if(!running.load()) break;
+			slot.assign((const uint64_t*)f, (const uint64_t*)f + (f->size + 7) / 8);
+			full = 1;
+		}
+		if(on_frame != NULL) on_frame();
+	}
+	{
+		std::lock_guard<std::mutex> l(lock);
+		ended = 1;
+	}
+	if(on_frame != NULL) on_frame();
+}
+
+
+int ThreadedMocapSource::next_frame(const rc_mocap_frame_t** frame)
+{
+	{
+		std::lock_guard<std::mutex> l(lock);
+		if(!full) return ended ? RC_MOCAP_END : RC_MOCAP_NO_FRAME;
+		out.swap(slot);
+		full = 0;
+	}
+	cv.notify_one();
+	*frame = (const rc_mocap_frame_t*)out.data();
+	return RC_MOCAP_FRAME;
+}
+
+
+void ThreadedMocapSource::reserve(int max_subjects)
+{
+	size_t words;
+
+	if(max_subjects <= 0) return;
+	words = (rc_mocap_frame_size(max_subjects) + 7) / 8;
+	reserve_subjects.store(max_subjects);
+	{
+		std::lock_guard<std::mutex> l(lock);
+		slot.reserve(words);
+	}
+	out.reserve(words);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR mocap_source.h
+////////////////////////////////////////////////////////////////////////////////
+
+MocapSource* rc_mocap_threaded_source_create(MocapSource* source, void (*on_frame)())
+{
+	if(source == NULL){
+		fprintf(stderr, "ERROR: in rc_mocap_threaded_source_create, no source\n");
+		return NULL;
+	}
+	ThreadedMocapSource* s = new ThreadedMocapSource(source, on_frame);
+	s->start();
+	return s;
+}
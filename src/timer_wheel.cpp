@@ -0,0 +1,281 @@
+/**
+ * @file timer_wheel.cpp
+ *
+ * @brief      Hierarchical timer wheel for periodic work driven from the frame
+ *             loop. See timer_wheel.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <vector>
+#include "../include/rc/timer_wheel.h"
+
+#define SLOT_MASK	(RC_TIMER_SLOTS - 1)
+#define NOT_LINKED	-1
+#define FIRING		-2
+
+typedef struct timer_node_t{
+	uint64_t expires;		// tick
+	uint32_t period;		// ticks, 0 for one-shot
+	uint32_t generation;		// bumped when the node is freed
+	int32_t next;
+	int32_t prev;
+	int16_t level;			// NOT_LINKED, FIRING or the level it is in
+	int16_t slot;
+	int cancelled;			// cancelled from its own callback
+	rc_timer_func_t func;
+	void* ctx;
+} timer_node_t;
+
+static std::vector<timer_node_t> nodes;
+static int32_t free_head = -1;
+static int32_t heads[RC_TIMER_LEVELS][RC_TIMER_SLOTS];
+static uint64_t occupied[RC_TIMER_LEVELS];	// bit per non-empty slot
+static uint64_t now_tick;
+static int count;
+static int initialized = 0;
+
+
+// private local function declarations;
+static inline rc_timer_id_t __id(int32_t i);
+static int32_t __node(rc_timer_id_t id);
+static void __link(int32_t i, uint64_t earliest);
+static void __unlink(int32_t i);
+static void __free(int32_t i);
+static void __cascade(int level);
+static int __fire_slot();
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+static inline rc_timer_id_t __id(int32_t i)
+{
+	return ((uint64_t)nodes[i].generation << 32) | (uint32_t)(i + 1);
+}
+
+
+// returns -1 for handles of timers that no longer exist
+static int32_t __node(rc_timer_id_t id)
+{
+	int64_t i = (int64_t)(uint32_t)id - 1;
+
+	if(i < 0 || i >= (int64_t)nodes.size()) return -1;
+	if(nodes[i].generation != (uint32_t)(id >> 32) || nodes[i].level == NOT_LINKED) return -1;
+	return (int32_t)i;
+}
+
+
+// puts a node in the slot of the lowest level that reaches its expiry, no
+// earlier than the tick earliest
+static void __link(int32_t i, uint64_t earliest)
+{
+	timer_node_t* n = &nodes[i];
+	uint64_t delta, expires;
+	int level = 0;
+
+	if(n->expires < earliest) n->expires = earliest;
+	expires = n->expires;
+	delta = expires - now_tick;
+	while(level < RC_TIMER_LEVELS - 1 && delta >= (1ull << (RC_TIMER_SLOT_BITS * (level + 1)))) level++;
+	// beyond the top level it waits in the furthest slot and is placed again
+	if(delta >= (1ull << (RC_TIMER_SLOT_BITS * RC_TIMER_LEVELS))){
+		expires = now_tick + (1ull << (RC_TIMER_SLOT_BITS * RC_TIMER_LEVELS)) - 1;
+	}
+	n->level = (int16_t)level;
+	n->slot = (int16_t)((expires >> (RC_TIMER_SLOT_BITS * level)) & SLOT_MASK);
+	n->prev = -1;
+	n->next = heads[level][n->slot];
+	if(n->next >= 0) nodes[n->next].prev = i;
+	heads[level][n->slot] = i;
+	occupied[level] |= 1ull << n->slot;
+}
+
+
+static void __unlink(int32_t i)
+{
+	timer_node_t* n = &nodes[i];
+
+	if(n->prev >= 0) nodes[n->prev].next = n->next;
+	else heads[n->level][n->slot] = n->next;
+	if(n->next >= 0) nodes[n->next].prev = n->prev;
+	if(heads[n->level][n->slot] < 0) occupied[n->level] &= ~(1ull << n->slot);
+	n->level = NOT_LINKED;
+}
+
+
+static void __free(int32_t i)
+{
+	nodes[i].level = NOT_LINKED;
+	nodes[i].generation++;
+	nodes[i].next = free_head;
+	free_head = i;
+	count--;
+}
+
+
+// moves the timers of the slot the wheel just reached down a level or more
+static void __cascade(int level)
+{
+	int slot = (int)((now_tick >> (RC_TIMER_SLOT_BITS * level)) & SLOT_MASK);
+	int32_t i;
+
+	// timers due this very tick go to the level 0 slot about to fire
+	while((i = heads[level][slot]) >= 0){
+		__unlink(i);
+		__link(i, now_tick);
+	}
+}
+
+
+static int __fire_slot()
+{
+	int slot = (int)(now_tick & SLOT_MASK);
+	int fired = 0;
+	int32_t i;
+	timer_node_t* n;
+	int ret;
+
+	// nothing linked while firing can land in this slot, it is at least one
+	// tick and at most RC_TIMER_SLOTS-1 ticks away
+	while((i = heads[0][slot]) >= 0){
+		__unlink(i);
+		nodes[i].level = FIRING;
+		nodes[i].cancelled = 0;
+		// the callback may grow the pool, so index rather than hold a pointer
+		ret = nodes[i].func(__id(i), nodes[i].ctx, now_tick * RC_TIMER_TICK_USEC);
+		fired++;
+		n = &nodes[i];
+		if(n->period == 0 || ret != 0 || n->cancelled){
+			__free(i);
+			continue;
+		}
+		n->expires += n->period;
+		// fell behind, carry on from now rather than firing to catch up
+		if(n->expires <= now_tick) n->expires = now_tick + n->period;
+		__link(i, now_tick + 1);
+	}
+	return fired;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR timer_wheel.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_timer_init(uint64_t now_usec)
+{
+	int l, s;
+
+	if(initialized){
+		fprintf(stderr, "ERROR: in rc_timer_init, already initialized\n");
+		return -1;
+	}
+	for(l=0; l<RC_TIMER_LEVELS; l++){
+		for(s=0; s<RC_TIMER_SLOTS; s++) heads[l][s] = -1;
+		occupied[l] = 0;
+	}
+	nodes.clear();
+	free_head = -1;
+	count = 0;
+	now_tick = now_usec / RC_TIMER_TICK_USEC;
+	initialized = 1;
+	return 0;
+}
+
+
+rc_timer_id_t rc_timer_add(uint64_t first_usec, uint32_t period_usec, rc_timer_func_t func, void* ctx)
+{
+	timer_node_t* n;
+	int32_t i;
+
+	if(!initialized || func == NULL){
+		fprintf(stderr, "ERROR: in rc_timer_add, wheel not initialized or no callback\n");
+		return 0;
+	}
+	if(free_head >= 0){
+		i = free_head;
+		free_head = nodes[i].next;
+	}
+	else{
+		i = (int32_t)nodes.size();
+		nodes.emplace_back();
+		nodes[i].generation = 1;
+	}
+	n = &nodes[i];
+	n->expires = first_usec / RC_TIMER_TICK_USEC;
+	// periods shorter than a tick run every tick
+	n->period = period_usec == 0 ? 0 : (period_usec + RC_TIMER_TICK_USEC / 2) / RC_TIMER_TICK_USEC;
+	if(period_usec != 0 && n->period == 0) n->period = 1;
+	n->func = func;
+	n->ctx = ctx;
+	n->cancelled = 0;
+	__link(i, now_tick + 1);
+	count++;
+	return __id(i);
+}
+
+
+int rc_timer_cancel(rc_timer_id_t id)
+{
+	int32_t i = __node(id);
+
+	if(i < 0) return -1;
+	// freed by __fire_slot once its callback returns
+	if(nodes[i].level == FIRING){
+		nodes[i].cancelled = 1;
+		return 0;
+	}
+	__unlink(i);
+	__free(i);
+	return 0;
+}
+
+
+int rc_timer_advance(uint64_t now_usec)
+{
+	uint64_t target = now_usec / RC_TIMER_TICK_USEC;
+	int fired = 0;
+	int l;
+
+	if(!initialized) return 0;
+	while(now_tick < target){
+		if(count == 0){
+			now_tick = target;
+			break;
+		}
+		now_tick++;
+		// higher levels first so their timers can drop all the way down
+		for(l=RC_TIMER_LEVELS-1; l>0; l--){
+			if((now_tick & ((1ull << (RC_TIMER_SLOT_BITS * l)) - 1)) == 0 && occupied[l]) __cascade(l);
+		}
+		if(occupied[0] & (1ull << (now_tick & SLOT_MASK))) fired += __fire_slot();
+	}
+	return fired;
+}
+
+
+int rc_timer_count()
+{
+	return count;
+}
+
+
+void rc_timer_reserve(int n)
+{
+	if(n > 0) nodes.reserve(n);
+}
+
+
+void rc_timer_cleanup()
+{
+	nodes.clear();
+	nodes.shrink_to_fit();
+	free_head = -1;
+	count = 0;
+	initialized = 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file tlog_replay.cpp
+ *
+ * @brief      Indexed, memory-mapped access to tlog files and paced replay of
+ *             their packets through the rc_mav send path. See tlog_replay.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	// for specific integer types
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "../include/rc/mavlink_udp.h"
+#include "../include/rc/mapped_file.h"
+#include "../include/rc/tlog_replay.h"
+
+#define TLOG_STAMP_LEN		8
+#define MAVLINK2_HEADER_LEN	10
+#define MAVLINK1_HEADER_LEN	6
+#define SPIN_THRESHOLD_US	2000	// sleep until this close, then spin
+
+struct rc_tlog_t{
+	rc_mapped_file_t file;
+	std::vector<rc_tlog_entry_t> entries;
+	std::vector<uint32_t> by_sysid[256];
+};
+
+typedef std::chrono::steady_clock replay_clock;
+
+
+// private local function declarations;
+static int __parse_packet(const uint8_t* p, size_t avail, rc_tlog_entry_t* e);
+static void __wait_until(replay_clock::time_point due);
+static bool __entry_before(const rc_tlog_entry_t& a, const rc_tlog_entry_t& b);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+// fills in len, sysid, compid and msgid of the packet at p, checking the crc
+// for known message ids. Returns 0 if p holds a complete valid packet.
+static int __parse_packet(const uint8_t* p, size_t avail, rc_tlog_entry_t* e)
+{
+	size_t header_len, len;
+	uint16_t crc;
+	const mavlink_msg_entry_t* info;
+
+	if(avail < MAVLINK1_HEADER_LEN + 2) return -1;
+	if(p[0] == MAVLINK_STX){
+		if(avail < MAVLINK2_HEADER_LEN + 2) return -1;
+		header_len = MAVLINK2_HEADER_LEN;
+		len = header_len + p[1] + 2;
+		if(p[2] & MAVLINK_IFLAG_SIGNED) len += MAVLINK_SIGNATURE_BLOCK_LEN;
+		e->sysid = p[5];
+		e->compid = p[6];
+		e->msgid = p[7] | ((uint32_t)p[8] << 8) | ((uint32_t)p[9] << 16);
+	}
+	else if(p[0] == MAVLINK_STX_MAVLINK1){
+		header_len = MAVLINK1_HEADER_LEN;
+		len = header_len + p[1] + 2;
+		e->sysid = p[3];
+		e->compid = p[4];
+		e->msgid = p[5];
+	}
+	else return -1;
+	if(len > avail) return -1;
+
+	info = mavlink_get_msg_entry(e->msgid);
+	if(info != NULL){
+		crc = crc_calculate(p + 1, (uint16_t)(header_len - 1 + p[1]));
+		crc_accumulate(info->crc_extra, &crc);
+		if((crc & 0xFF) != p[header_len + p[1]] || (crc >> 8) != p[header_len + p[1] + 1]) return -1;
+	}
+	e->len = (uint16_t)len;
+	return 0;
+}
+
+
+static void __wait_until(replay_clock::time_point due)
+{
+	auto now = replay_clock::now();
+	if(due - now > std::chrono::microseconds(SPIN_THRESHOLD_US)){
+		std::this_thread::sleep_for(due - now - std::chrono::microseconds(SPIN_THRESHOLD_US));
+	}
+	while(replay_clock::now() < due);
+}
+
+
+static bool __entry_before(const rc_tlog_entry_t& a, const rc_tlog_entry_t& b)
+{
+	return a.time_usec < b.time_usec;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR tlog_replay.h
+////////////////////////////////////////////////////////////////////////////////
+
+rc_tlog_t* rc_tlog_open(const char* path)
+{
+	rc_tlog_t* log = new rc_tlog_t;
+	rc_tlog_entry_t e;
+	size_t pos = 0;
+	size_t skipped = 0;
+	size_t i;
+	int j;
+
+	if(rc_map_file(path, &log->file)){
+		delete log;
+		return NULL;
+	}
+	const uint8_t* d = log->file.data;
+	size_t size = log->file.size;
+
+	// roughly 40 bytes per record for typical pose traffic
+	log->entries.reserve(size / 40);
+	while(pos + TLOG_STAMP_LEN < size){
+		if(__parse_packet(d + pos + TLOG_STAMP_LEN, size - pos - TLOG_STAMP_LEN, &e)){
+			// resynchronize one byte at a time
+			pos++;
+			skipped++;
+			continue;
+		}
+		e.time_usec = 0;
+		for(j=0; j<TLOG_STAMP_LEN; j++) e.time_usec = (e.time_usec << 8) | d[pos + j];
+		e.offset = (uint64_t)(pos + TLOG_STAMP_LEN);
+		log->entries.push_back(e);
+		pos += TLOG_STAMP_LEN + e.len;
+	}
+	if(skipped > 0){
+		fprintf(stderr, "WARNING: in rc_tlog_open, skipped %zu unparseable bytes in %s\n", skipped, path);
+	}
+
+	// writers stamp at send time from several threads so order isn't
+	// guaranteed, keep file order among equal stamps
+	std::stable_sort(log->entries.begin(), log->entries.end(), __entry_before);
+	for(i=0; i<log->entries.size(); i++){
+		log->by_sysid[log->entries[i].sysid].push_back((uint32_t)i);
+	}
+	return log;
+}
+
+
+void rc_tlog_close(rc_tlog_t* log)
+{
+	if(log == NULL) return;
+	rc_unmap_file(&log->file);
+	delete log;
+}
+
+
+size_t rc_tlog_count(const rc_tlog_t* log)
+{
+	return log->entries.size();
+}
+
+
+const rc_tlog_entry_t* rc_tlog_entry(const rc_tlog_t* log, size_t i)
+{
+	if(i >= log->entries.size()) return NULL;
+	return &log->entries[i];
+}
+
+
+const uint8_t* rc_tlog_packet(const rc_tlog_t* log, const rc_tlog_entry_t* entry)
+{
+	return log->file.data + entry->offset;
+}
+
+
+size_t rc_tlog_seek_time(const rc_tlog_t* log, uint64_t time_usec)
+{
+	rc_tlog_entry_t key;
+	key.time_usec = time_usec;
+	return std::lower_bound(log->entries.begin(), log->entries.end(), key, __entry_before)
+		- log->entries.begin();
+}
+
+
+const uint32_t* rc_tlog_sysid_index(const rc_tlog_t* log, uint8_t sysid, size_t* count)
+{
+	*count = log->by_sysid[sysid].size();
+	return *count ? log->by_sysid[sysid].data() : NULL;
+}
+
+
+int rc_tlog_replay(const rc_tlog_t* log, const rc_tlog_replay_config_t* config,
+			rc_tlog_replay_stats_t* stats)
+{
+	rc_tlog_replay_stats_t s;
+	const rc_tlog_entry_t* e;
+	const uint32_t* index = NULL;
+	size_t n, i, first;
+	uint64_t t0_log = 0;
+	double late_sum = 0.0;
+	uint64_t paced = 0;
+	int started = 0;
+
+	if(log == NULL || config == NULL || config->speed < 0.0){
+		fprintf(stderr, "ERROR: in rc_tlog_replay, invalid arguments\n");
+		return -1;
+	}
+	memset(&s, 0, sizeof(s));
+
+	// walk either the whole time index or one sysid's
+	if(config->sysid == RC_TLOG_ANY_SYSID){
+		n = log->entries.size();
+	}
+	else{
+		index = rc_tlog_sysid_index(log, (uint8_t)config->sysid, &n);
+	}
+	first = 0;
+	if(config->start_usec > 0){
+		if(index == NULL) first = rc_tlog_seek_time(log, config->start_usec);
+		else while(first < n && log->entries[index[first]].time_usec < config->start_usec) first++;
+	}
+
+	auto t0_wall = replay_clock::now();
+	for(i=first; i<n; i++){
+		if(config->running != NULL && !*config->running) break;
+		e = &log->entries[index ? index[i] : i];
+		if(config->end_usec > 0 && e->time_usec > config->end_usec) break;
+
+		if(!started){
+			t0_log = e->time_usec;
+			t0_wall = replay_clock::now();
+			started = 1;
+		}
+		if(config->speed > 0.0){
+			auto due = t0_wall + std::chrono::duration_cast<replay_clock::duration>(
+				std::chrono::duration<double, std::micro>((double)(e->time_usec - t0_log) / config->speed));
+			__wait_until(due);
+			double late = std::chrono::duration<double, std::micro>(replay_clock::now() - due).count();
+			late_sum += late;
+			paced++;
+			if(late > s.late_max_us) s.late_max_us = late;
+		}
+
+		if(config->before_send != NULL && config->before_send(e, config->ctx)) continue;
+		if(rc_mav_send_buffer(rc_tlog_packet(log, e), e->len)) s.failed++;
+		else s.sent++;
+	}
+
+	s.duration_s = std::chrono::duration<double>(replay_clock::now() - t0_wall).count();
+	if(paced > 0) s.late_mean_us = late_sum / (double)paced;
+	if(stats != NULL) *stats = s;
+	return 0;
+}
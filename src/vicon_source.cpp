@@ -0,0 +1,272 @@
+/**
+ * @file vicon_source.cpp
+ *
+ * @brief      MocapSource reading live frames from a Vicon DataStream server.
+ *             See mocap_source.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include "../include/rc/latency_stats.h"
+#include "../include/rc/mocap_source.h"
+
+// defined by the build when the DataStream SDK isn't available for the platform
+#ifndef RC_NO_VICON
+#include "../include/rc/DataStreamClient.h"
+
+#define output_stream std::cout
+
+using namespace ViconDataStreamSDK::CPP;
+
+/**
+ * Converts each SDK frame into the flat frame layout
+ */
+class ViconMocapSource : public MocapSource
+{
+public:
+	ViconMocapSource() : transmitting(0) {}
+	~ViconMocapSource();
+
+	int connect(const rc_mocap_vicon_config_t* config, const int* running);
+	int next_frame(const rc_mocap_frame_t** frame);
+	void reserve(int max_subjects);
+
+private:
+	void print_subjects();
+
+	Client client;
+	rc_mocap_vicon_config_t config;
+	int transmitting;
+	std::vector<uint64_t> buf;	// uint64_t keeps the frame 8 byte aligned
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR ViconMocapSource
+////////////////////////////////////////////////////////////////////////////////
+
+ViconMocapSource::~ViconMocapSource()
+{
+	if(transmitting) client.StopTransmittingMulticast();
+	client.Disconnect();
+}
+
+
+int ViconMocapSource::connect(const rc_mocap_vicon_config_t* c, const int* running)
+{
+	int connect_attempted = 0;
+	Result::Enum result;
+
+	config = *c;
+	if(config.shard_count < 1) config.shard_count = 1;
+	// the SDK takes a bare address here, not the host:port connect string
+	if(config.multicast_send != NULL &&
+	   (config.multicast_interface == NULL || strchr(config.multicast_interface, ':') != NULL)){
+		fprintf(stderr, "ERROR: in rc_mocap_vicon_source_create, multicast_send needs the server interface as a bare IP\n");
+		return -1;
+	}
+
+	//try to connect to the server every 0.5 seconds, or join its multicast
+	while(1)
+	{
+		if(config.multicast_join != NULL){
+			result = client.ConnectToMulticast(config.host, config.multicast_join).Result;
+		}
+		else{
+			result = client.Connect(config.host).Result;
+		}
+		if(result == Result::Success) break;
+		if(!*running) return -1;
+		if(connect_attempted != 1){
+			output_stream << "Trying to connect to the Vicon server, make sure the cameras are turned on and Vicon Tracker is running...";
+		}
+		connect_attempted = 1;
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		output_stream << ".";
+	}
+
+	//client.SetAxisMapping(Direction::Forward,
+		//Direction::Right,
+		//Direction::Up);
+	client.EnableSegmentData();
+	client.EnableMarkerData();
+	client.EnableUnlabeledMarkerData();
+	client.EnableMarkerRayData();
+	client.EnableDeviceData();
+	client.EnableDebugData();
+
+	// let other bridges share this connection's frames
+	if(config.multicast_send != NULL){
+		if(client.StartTransmittingMulticast(config.multicast_interface, config.multicast_send).Result != Result::Success){
+			fprintf(stderr, "ERROR: in rc_mocap_vicon_source_create, failed to start multicast to %s\n", config.multicast_send);
+			return -1;
+		}
+		transmitting = 1;
+	}
+
+	unsigned int SubjectCount = client.GetSubjectCount().SubjectCount;
+	while (SubjectCount < 1)
+	{
+		if(!*running) return -1;
+		if (client.GetFrame().Result != Result::Success)
+		{
+			output_stream << "Waiting for new frame..." << std::endl;
+		}
+		else{
+			output_stream << "Scanning Vicon software for subjects..." << std::endl;
+		}
+		SubjectCount = client.GetSubjectCount().SubjectCount;
+	}
+	print_subjects();
+	return 0;
+}
+
+
+void ViconMocapSource::print_subjects()
+{
+	unsigned int SubjectCount = client.GetSubjectCount().SubjectCount;
+	output_stream << "Subjects (" << SubjectCount << "):" << std::endl;
+
+	for (unsigned int SubjectIndex = 0; SubjectIndex < SubjectCount; ++SubjectIndex)
+	{
+		output_stream << "  Subject #" << SubjectIndex + 1 << std::endl;
+
+		// Get the subject name
+		std::string SubjectName = client.GetSubjectName(SubjectIndex).SubjectName;
+		output_stream << "    Name: " << SubjectName << std::endl;
+
+		// Get the root segment
+		std::string RootSegment = client.GetSubjectRootSegmentName(SubjectName).SegmentName;
+		output_stream << "    Root Segment: " << RootSegment << std::endl;
+
+		// Count the number of segments
+		unsigned int SegmentCount = client.GetSegmentCount(SubjectName).SegmentCount;
+		output_stream << "    Segments (" << SegmentCount << "):" << std::endl;
+		for (unsigned int SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex)
+		{
+			output_stream << "      Segment #" << SegmentIndex << std::endl;
+
+			// Get the segment name
+			std::string SegmentName = client.GetSegmentName(SubjectName, SegmentIndex).SegmentName;
+			output_stream << "        Name: " << SegmentName << std::endl;
+
+			// Get the segment parent
+			std::string SegmentParentName = client.GetSegmentParentName(SubjectName, SegmentName).SegmentName;
+			output_stream << "        Parent: " << SegmentParentName << std::endl;
+
+			// Get the segment's children
+			unsigned int ChildCount = client.GetSegmentChildCount(SubjectName, SegmentName).SegmentCount;
+			output_stream << "     Children (" << ChildCount << "):" << std::endl;
+			for (unsigned int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+			{
+				std::string ChildName = client.GetSegmentChildName(SubjectName, SegmentName, ChildIndex).SegmentName;
+				output_stream << "       " << ChildName << std::endl;
+			}
+		}
+	}
+}
+
+
+int ViconMocapSource::next_frame(const rc_mocap_frame_t** frame)
+{
+	rc_mocap_frame_t* f;
+	rc_mocap_subject_t* s;
+	Output_GetTimecode tc;
+	uint64_t t;
+	unsigned int i, j, n, k;
+
+	if (client.GetFrame().Result != Result::Success) return RC_MOCAP_NO_FRAME;
+
+	// frame-level queries
+	t = rc_lat_now();
+	n = client.GetSubjectCount().SubjectCount;
+	buf.resize((rc_mocap_frame_size(n) + 7) / 8);
+	f = (rc_mocap_frame_t*)buf.data();
+	f->size = rc_mocap_frame_size(n);
+	f->subject_count = n;
+	f->frame_number = client.GetFrameNumber().FrameNumber;
+	f->capture_usec = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	f->latency_s = client.GetLatencyTotal().Total;
+	tc = client.GetTimecode();
+	f->timecode.hours = (uint8_t)tc.Hours;
+	f->timecode.minutes = (uint8_t)tc.Minutes;
+	f->timecode.seconds = (uint8_t)tc.Seconds;
+	f->timecode.frames = (uint8_t)tc.Frames;
+	f->timecode.subframe = (uint16_t)tc.SubFrame;
+	f->timecode.subframes_per_frame = (uint16_t)tc.SubFramesPerFrame;
+	rc_lat_record(RC_LAT_ACQUIRE, RC_LAT_ALL_SUBJECTS, t);
+
+	// Get the subject name and root segment pose from the SDK
+	s = (rc_mocap_subject_t*)(f + 1);
+	k = 0;
+	for(i=0; i<n; i++){
+		t = rc_lat_now();
+		std::string SubjectName = client.GetSubjectName(i).SubjectName;
+		// other bridges handle the rest of the subjects
+		if(config.shard_count > 1 &&
+			rc_mocap_shard_of(SubjectName.c_str(), config.shard_count) != config.shard_index) continue;
+		std::string RootSegment = client.GetSubjectRootSegmentName(SubjectName).SegmentName;
+		Output_GetSegmentGlobalRotationQuaternion global_quat =
+			client.GetSegmentGlobalRotationQuaternion(SubjectName, RootSegment);
+		Output_GetSegmentGlobalTranslation global_translation =
+			client.GetSegmentGlobalTranslation(SubjectName, RootSegment);
+		Output_GetObjectQuality quality = client.GetObjectQuality(SubjectName);
+
+		memset(&s[k], 0, sizeof(s[k]));
+		strncpy(s[k].name, SubjectName.c_str(), RC_MOCAP_NAME_LEN - 1);
+		for(j=0; j<3; j++) s[k].translation[j] = global_translation.Translation[j];
+		for(j=0; j<4; j++) s[k].quaternion[j] = global_quat.Rotation[j];
+		s[k].quality = quality.Result == Result::Success ? quality.Quality : -1.0;
+		s[k].occluded = global_translation.Occluded ? 1 : 0;
+		s[k].index = (uint16_t)i;
+		k++;
+		rc_lat_record(RC_LAT_EXTRACT, i, t);
+	}
+	f->subject_count = k;
+	f->size = rc_mocap_frame_size(k);
+
+	*frame = f;
+	return RC_MOCAP_FRAME;
+}
+
+
+void ViconMocapSource::reserve(int max_subjects)
+{
+	if(max_subjects > 0) buf.reserve((rc_mocap_frame_size(max_subjects) + 7) / 8);
+}
+
+#endif // RC_NO_VICON
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR mocap_source.h
+////////////////////////////////////////////////////////////////////////////////
+
+MocapSource* rc_mocap_vicon_source_create(const rc_mocap_vicon_config_t* config, const int* running)
+{
+#ifdef RC_NO_VICON
+	fprintf(stderr, "ERROR: in rc_mocap_vicon_source_create, built without the Vicon DataStream SDK, use -R or -S\n");
+	return NULL;
+#else
+	ViconMocapSource* source;
+
+	if(config->shard_count > 1 && (config->shard_index < 0 || config->shard_index >= config->shard_count)){
+		fprintf(stderr, "ERROR: in rc_mocap_vicon_source_create, shard index must be between 0 and %d\n", config->shard_count - 1);
+		return NULL;
+	}
+	source = new ViconMocapSource;
+	if(source->connect(config, running)){
+		delete source;
+		return NULL;
+	}
+	return source;
+#endif
+}
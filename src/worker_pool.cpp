@@ -0,0 +1,214 @@
+/**
+ * @file worker_pool.cpp
+ *
+ * @brief      Fixed pool of threads running a parallel for over an index range
+ *             with work stealing. See worker_pool.h
+ *
+ * @date       10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>	// for specific integer types
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "../include/rc/worker_pool.h"
+#include "../include/rc/realtime.h"
+
+// remaining range of one worker, begin in the low and end in the high word,
+// on its own cache line so taking chunks doesn't bounce other workers' lines
+typedef struct pool_worker_t{
+	alignas(64) std::atomic<uint64_t> range;
+} pool_worker_t;
+
+static pool_worker_t workers[RC_POOL_MAX_WORKERS];
+static std::thread threads[RC_POOL_MAX_WORKERS];
+static int num_workers = 0;
+
+// wakes the threads for each run, generation and shutdown are guarded by lock
+static std::mutex lock;
+static std::condition_variable cv;
+static uint64_t generation;
+static int shutdown;
+static std::atomic<int> active(0);
+
+// the current run, written before generation is bumped
+static rc_pool_func_t job_func;
+static void* job_ctx;
+static uint32_t job_chunk;
+
+
+// private local function declarations;
+static inline uint64_t __pack(uint32_t begin, uint32_t end);
+static int __take(int w, uint32_t* begin, uint32_t* end);
+static int __steal(int w);
+static void __work(int w);
+static void __thread_loop(int w);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOCAL FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+static inline uint64_t __pack(uint32_t begin, uint32_t end)
+{
+	return ((uint64_t)end << 32) | begin;
+}
+
+
+// takes a chunk from the front of worker w's own range
+static int __take(int w, uint32_t* begin, uint32_t* end)
+{
+	uint64_t r = workers[w].range.load(std::memory_order_acquire);
+	uint32_t b, e, nb;
+
+	while(1){
+		b = (uint32_t)r;
+		e = (uint32_t)(r >> 32);
+		if(b >= e) return 0;
+		nb = e - b > job_chunk ? b + job_chunk : e;
+		if(workers[w].range.compare_exchange_weak(r, __pack(nb, e), std::memory_order_acq_rel)){
+			*begin = b;
+			*end = nb;
+			return 1;
+		}
+	}
+}
+
+
+// moves the back half of another worker's range into worker w's empty range
+static int __steal(int w)
+{
+	uint64_t r;
+	uint32_t b, e, mid;
+	int k, v;
+
+	for(k=1; k<num_workers; k++){
+		v = (w + k) % num_workers;
+		r = workers[v].range.load(std::memory_order_acquire);
+		while(1){
+			b = (uint32_t)r;
+			e = (uint32_t)(r >> 32);
+			if(b >= e) break;
+			// small leftovers are taken whole rather than split
+			mid = e - b > job_chunk ? b + (e - b) / 2 : b;
+			if(workers[v].range.compare_exchange_weak(r, __pack(b, mid), std::memory_order_acq_rel)){
+				workers[w].range.store(__pack(mid, e), std::memory_order_release);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+
+static void __work(int w)
+{
+	uint32_t b, e;
+
+	while(1){
+		while(__take(w, &b, &e)) job_func((int)b, (int)e, w, job_ctx);
+		if(!__steal(w)) return;
+	}
+}
+
+
+static void __thread_loop(int w)
+{
+	uint64_t seen = 0;
+
+	rc_rt_enter(RC_RT_WORKER);
+	while(1){
+		{
+			std::unique_lock<std::mutex> l(lock);
+			cv.wait(l, [&seen]{ return shutdown || generation != seen; });
+			if(shutdown) return;
+			seen = generation;
+		}
+		__work(w);
+		active.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS FOR worker_pool.h
+////////////////////////////////////////////////////////////////////////////////
+
+int rc_pool_init(int n)
+{
+	int i;
+
+	if(num_workers != 0){
+		fprintf(stderr, "ERROR: in rc_pool_init, pool already running\n");
+		return -1;
+	}
+	if(n < 1 || n > RC_POOL_MAX_WORKERS){
+		fprintf(stderr, "ERROR: in rc_pool_init, workers must be between 1 and %d\n", RC_POOL_MAX_WORKERS);
+		return -1;
+	}
+	num_workers = n;
+	shutdown = 0;
+	generation = 0;
+	for(i=1; i<n; i++) threads[i] = std::thread(__thread_loop, i);
+	return 0;
+}
+
+
+int rc_pool_num_workers()
+{
+	return num_workers;
+}
+
+
+int rc_pool_run(int n, int chunk, rc_pool_func_t func, void* ctx)
+{
+	int w;
+
+	if(num_workers == 0 || chunk < 1){
+		fprintf(stderr, "ERROR: in rc_pool_run, pool not initialized or invalid chunk\n");
+		return -1;
+	}
+	if(n <= 0) return 0;
+	// not worth waking anyone
+	if(num_workers == 1 || n <= chunk){
+		func(0, n, 0, ctx);
+		return 0;
+	}
+
+	job_func = func;
+	job_ctx = ctx;
+	job_chunk = (uint32_t)chunk;
+	for(w=0; w<num_workers; w++){
+		workers[w].range.store(__pack((uint32_t)((int64_t)n * w / num_workers),
+			(uint32_t)((int64_t)n * (w + 1) / num_workers)), std::memory_order_relaxed);
+	}
+	active.store(num_workers - 1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> l(lock);
+		generation++;
+	}
+	cv.notify_all();
+
+	// the caller is worker 0, then waits at the barrier
+	__work(0);
+	while(active.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+	return 0;
+}
+
+
+void rc_pool_cleanup()
+{
+	int i;
+
+	if(num_workers == 0) return;
+	{
+		std::lock_guard<std::mutex> l(lock);
+		shutdown = 1;
+	}
+	cv.notify_all();
+	for(i=1; i<num_workers; i++) threads[i].join();
+	num_workers = 0;
+}